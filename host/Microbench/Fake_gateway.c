@@ -0,0 +1,532 @@
+/**
+ * @file      Fake_gateway.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the in-process gateway of the microbenchmarks.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Fake_gateway.h>
+#include <System_network.h>
+#include <Frame.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Maximum number of connections open at the same time, the connection per command
+ * mode can leave some of them closing.
+ */
+#define MAX_CLIENTS 4u
+
+/* Size in bytes of the reception buffer of a connection. */
+#define RX_BUFFER_SIZE 4096u
+
+/* Number of commands that the gateway keeps in the order they arrived, the later ones
+ * are only counted.
+ */
+#define COMMANDS_HISTORY_LEN 1024u
+
+/* Period in milliseconds at which the waits check the counters. */
+#define WAIT_POLL_PERIOD_MS 1u
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that contains a connection and the bytes of its incomplete frame. */
+typedef struct
+{
+  int sock_fd;
+  uint8_t buffer[RX_BUFFER_SIZE];
+  size_t len;
+} gateway_client;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Lock of the counters and condition signaled when a command arrives. */
+static pthread_mutex_t gateway_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gateway_changed;
+
+/* Counters since the last reset. */
+static uint32_t received_cmds;
+static uint32_t duplicated_frames;
+static uint32_t stats_frames;
+static bool has_last_cmd;
+static TCP_COMMAND_TYPE last_cmd;
+static TCP_COMMAND_TYPE commands_history[COMMANDS_HISTORY_LEN];
+
+/* Time in microseconds of the last command. */
+static int64_t last_cmd_us;
+
+#if TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_RAW
+  /* Sequence of the newest commands frame, the older ones are duplicates. */
+  static bool has_last_seq;
+  static uint16_t last_seq;
+#endif
+
+/* Listening socket and thread of the gateway. */
+static int server_fd = -1;
+static pthread_t gateway_thread;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Thread of the gateway, it serves the connections or the datagrams.
+ *
+ * @param args Unused.
+ *
+ * @return NULL
+ */
+static void *gateway_func(void *args);
+
+/**
+ * @brief Decodes the complete frames or commands of a buffer and writes the acks.
+ *
+ * @param client Connection of the data, its buffer keeps the incomplete frame.
+ *
+ * @param reply_fd Socket where the acks are written.
+ *
+ * @param reply_addr Sender of the datagram, NULL for a connection.
+ *
+ * @return void
+ */
+static void decode_buffer(gateway_client *client, const int reply_fd,
+  const struct sockaddr_in *reply_addr);
+
+#if TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_RAW
+  /**
+   * @brief Counts the commands of a frame that is not a duplicate.
+   *
+   * @param seq Sequence number of the frame.
+   *
+   * @param records Command records of the frame.
+   *
+   * @param count Number of command records.
+   *
+   * @return void
+   */
+  static void count_commands(const uint16_t seq, const uint8_t *records,
+    const uint8_t count);
+#endif
+
+/**
+ * @brief Stores a received command as the last one and in the history. The lock of
+ *        the counters must be taken.
+ *
+ * @param cmd Received command.
+ *
+ * @return void
+ */
+static void store_command(const TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Returns the time in microseconds of CLOCK_MONOTONIC.
+ *
+ * @param void
+ *
+ * @return Time in microseconds.
+ */
+static int64_t monotonic_us(void);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+bool start_fake_gateway(void)
+{
+
+  if(server_fd >= 0)
+  {
+    return true;
+  }
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&gateway_changed, &attr);
+  pthread_condattr_destroy(&attr);
+
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+    server_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    const uint16_t port = TCP_CLIENT_UDP_PORT;
+  #else
+    server_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    const uint16_t port = TCP_IP_PORT;
+  #endif
+  if(server_fd < 0)
+  {
+    return false;
+  }
+
+  const int enable = 1;
+  setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  const struct sockaddr_in addr =
+  {
+    .sin_family = AF_INET,
+    .sin_port = htons(port),
+    .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+  };
+  if(bind(server_fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0
+     #if TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_UDP
+       || listen(server_fd, (int)MAX_CLIENTS) != 0
+     #endif
+    )
+  {
+    close(server_fd);
+    server_fd = -1;
+    return false;
+  }
+
+  if(pthread_create(&gateway_thread, NULL, gateway_func, NULL) != 0)
+  {
+    close(server_fd);
+    server_fd = -1;
+    return false;
+  }
+  pthread_detach(gateway_thread);
+
+  return true;
+}
+
+void reset_fake_gateway(void)
+{
+
+  pthread_mutex_lock(&gateway_lock);
+  received_cmds = 0u;
+  duplicated_frames = 0u;
+  stats_frames = 0u;
+  has_last_cmd = false;
+  last_cmd_us = monotonic_us();
+  pthread_mutex_unlock(&gateway_lock);
+}
+
+uint32_t fake_gateway_commands(void)
+{
+
+  pthread_mutex_lock(&gateway_lock);
+  const uint32_t num_of_cmds = received_cmds;
+  pthread_mutex_unlock(&gateway_lock);
+
+  return num_of_cmds;
+}
+
+uint32_t fake_gateway_duplicates(void)
+{
+
+  pthread_mutex_lock(&gateway_lock);
+  const uint32_t duplicates = duplicated_frames;
+  pthread_mutex_unlock(&gateway_lock);
+
+  return duplicates;
+}
+
+uint32_t fake_gateway_stats_frames(void)
+{
+
+  pthread_mutex_lock(&gateway_lock);
+  const uint32_t num_of_frames = stats_frames;
+  pthread_mutex_unlock(&gateway_lock);
+
+  return num_of_frames;
+}
+
+bool fake_gateway_last_command(TCP_COMMAND_TYPE *cmd)
+{
+
+  pthread_mutex_lock(&gateway_lock);
+  const bool received = has_last_cmd;
+  *cmd = last_cmd;
+  pthread_mutex_unlock(&gateway_lock);
+
+  return received;
+}
+
+bool fake_gateway_command(const uint32_t index, TCP_COMMAND_TYPE *cmd)
+{
+
+  pthread_mutex_lock(&gateway_lock);
+  const bool stored = (index < received_cmds && index < COMMANDS_HISTORY_LEN);
+  if(stored)
+  {
+    *cmd = commands_history[index];
+  }
+  pthread_mutex_unlock(&gateway_lock);
+
+  return stored;
+}
+
+bool wait_for_fake_gateway_commands(const uint32_t num_of_cmds,
+  const uint32_t time_out_ms)
+{
+
+  const int64_t deadline_us = monotonic_us() + (int64_t)time_out_ms*1000;
+  struct timespec deadline =
+  {
+    .tv_sec = (time_t)(deadline_us/1000000),
+    .tv_nsec = (long)((deadline_us%1000000)*1000),
+  };
+
+  pthread_mutex_lock(&gateway_lock);
+  int ret = 0;
+  while(received_cmds < num_of_cmds && ret != ETIMEDOUT)
+  {
+    ret = pthread_cond_timedwait(&gateway_changed, &gateway_lock, &deadline);
+  }
+  const bool arrived = (received_cmds >= num_of_cmds);
+  pthread_mutex_unlock(&gateway_lock);
+
+  return arrived;
+}
+
+void wait_for_fake_gateway_quiet(const uint32_t quiet_ms)
+{
+
+  while(true)
+  {
+    pthread_mutex_lock(&gateway_lock);
+    const int64_t quiet_us = monotonic_us() - last_cmd_us;
+    pthread_mutex_unlock(&gateway_lock);
+
+    if(quiet_us >= (int64_t)quiet_ms*1000)
+    {
+      return;
+    }
+
+    const struct timespec period = { .tv_nsec = WAIT_POLL_PERIOD_MS*1000000L };
+    nanosleep(&period, NULL);
+  }
+}
+
+static void *gateway_func(void *args)
+{
+
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+    /* Every datagram is a whole frame, a partial one is not carried to the next. */
+    static gateway_client datagram;
+    while(true)
+    {
+      struct sockaddr_in sender;
+      socklen_t sender_len = sizeof(sender);
+      const ssize_t len = recvfrom(server_fd, datagram.buffer, sizeof(datagram.buffer),
+        0, (struct sockaddr *)&sender, &sender_len);
+      if(len > 0)
+      {
+        datagram.len = (size_t)len;
+        decode_buffer(&datagram, server_fd, &sender);
+      }
+    }
+  #else
+    static gateway_client clients[MAX_CLIENTS];
+    for(size_t i = 0u; i < MAX_CLIENTS; i++)
+    {
+      clients[i].sock_fd = -1;
+    }
+
+    while(true)
+    {
+      struct pollfd fds[MAX_CLIENTS + 1u];
+      nfds_t num_of_fds = 0u;
+      fds[num_of_fds++] = (struct pollfd){ .fd = server_fd, .events = POLLIN };
+      for(size_t i = 0u; i < MAX_CLIENTS; i++)
+      {
+        fds[num_of_fds++] =
+          (struct pollfd){ .fd = clients[i].sock_fd, .events = POLLIN };
+      }
+
+      if(poll(fds, num_of_fds, -1) <= 0)
+      {
+        continue;
+      }
+
+      if((fds[0].revents & POLLIN) != 0)
+      {
+        const int client_fd = accept(server_fd, NULL, NULL);
+        size_t free_client = 0u;
+        while(free_client < MAX_CLIENTS && clients[free_client].sock_fd >= 0)
+        {
+          free_client++;
+        }
+        if(client_fd >= 0 && free_client == MAX_CLIENTS)
+        {
+          close(client_fd);
+        }
+        else if(client_fd >= 0)
+        {
+          const int enable = 1;
+          setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+          clients[free_client].sock_fd = client_fd;
+          clients[free_client].len = 0u;
+        }
+      }
+
+      for(size_t i = 0u; i < MAX_CLIENTS; i++)
+      {
+        gateway_client *client = &clients[i];
+        if(client->sock_fd < 0 || (fds[i + 1u].revents & (POLLIN | POLLHUP)) == 0)
+        {
+          continue;
+        }
+
+        const ssize_t len = recv(client->sock_fd, client->buffer + client->len,
+          sizeof(client->buffer) - client->len, 0);
+        if(len <= 0)
+        {
+          close(client->sock_fd);
+          client->sock_fd = -1;
+          continue;
+        }
+        client->len += (size_t)len;
+        decode_buffer(client, client->sock_fd, NULL);
+      }
+    }
+  #endif
+
+  return NULL;
+}
+
+static void decode_buffer(gateway_client *client, const int reply_fd,
+  const struct sockaddr_in *reply_addr)
+{
+
+  size_t offset = 0u;
+
+  #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_RAW
+    while(client->len - offset >= sizeof(TCP_COMMAND_TYPE))
+    {
+      TCP_COMMAND_TYPE cmd;
+      memcpy(&cmd, client->buffer + offset, sizeof(TCP_COMMAND_TYPE));
+      pthread_mutex_lock(&gateway_lock);
+      store_command(&cmd);
+      last_cmd_us = monotonic_us();
+      pthread_cond_broadcast(&gateway_changed);
+      pthread_mutex_unlock(&gateway_lock);
+      offset += sizeof(TCP_COMMAND_TYPE);
+    }
+  #else
+    while(true)
+    {
+      Frame_header header;
+      const Frame_return ret = decode_frame_header(client->buffer + offset,
+        client->len - offset, &header);
+      if(ret == CORE_FRAME_TOO_SHORT_ERR || ret == CORE_FRAME_LEN_ERR)
+      {
+        /* The rest of the frame did not arrive yet. */
+        break;
+      }
+      if(ret != CORE_FRAME_OK)
+      {
+        /* The stream lost its alignment, nothing after it can be trusted. */
+        offset = client->len;
+        break;
+      }
+
+      if(header.type == FRAME_TYPE_COMMANDS)
+      {
+        count_commands(header.seq, client->buffer + offset + FRAME_HEADER_SIZE,
+          header.count);
+        offset += FRAME_CMDS_SIZE(header.count);
+
+        #if TCP_CLIENT_GATEWAY_ACKS == 1
+          uint8_t ack[FRAME_ACK_SIZE];
+          encode_frame_header(ack, FRAME_TYPE_ACK, header.seq, 0u);
+          sendto(reply_fd, ack, sizeof(ack), MSG_NOSIGNAL,
+            (const struct sockaddr *)reply_addr,
+            (reply_addr != NULL) ? sizeof(*reply_addr) : 0u);
+        #endif
+      }
+      else if(header.type == FRAME_TYPE_STATE)
+      {
+        offset += FRAME_STATE_SIZE(header.count);
+      }
+      else if(header.type == FRAME_TYPE_STATS)
+      {
+        /* The reports are not acknowledged, they are only counted. */
+        pthread_mutex_lock(&gateway_lock);
+        stats_frames++;
+        pthread_mutex_unlock(&gateway_lock);
+        offset += FRAME_STATS_SIZE(header.count);
+      }
+      else
+      {
+        offset += FRAME_ACK_SIZE;
+      }
+    }
+  #endif
+
+  /* Keep the incomplete frame at the start of the buffer. */
+  memmove(client->buffer, client->buffer + offset, client->len - offset);
+  client->len -= offset;
+}
+
+#if TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_RAW
+  static void count_commands(const uint16_t seq, const uint8_t *records,
+    const uint8_t count)
+  {
+
+    pthread_mutex_lock(&gateway_lock);
+
+    /* The frames written again after a reconnection are older than the newest one. */
+    if(has_last_seq && (int16_t)(seq - last_seq) <= 0)
+    {
+      duplicated_frames++;
+      pthread_mutex_unlock(&gateway_lock);
+      return;
+    }
+    has_last_seq = true;
+    last_seq = seq;
+
+    for(uint8_t i = 0u; i < count; i++)
+    {
+      TCP_COMMAND_TYPE cmd;
+      decode_cmd_record(records + (size_t)i*FRAME_CMD_RECORD_SIZE, &cmd);
+      store_command(&cmd);
+    }
+    if(count > 0u)
+    {
+      last_cmd_us = monotonic_us();
+      pthread_cond_broadcast(&gateway_changed);
+    }
+
+    pthread_mutex_unlock(&gateway_lock);
+  }
+#endif
+
+static void store_command(const TCP_COMMAND_TYPE *cmd)
+{
+
+  if(received_cmds < COMMANDS_HISTORY_LEN)
+  {
+    commands_history[received_cmds] = *cmd;
+  }
+  last_cmd = *cmd;
+  has_last_cmd = true;
+  received_cmds++;
+}
+
+static int64_t monotonic_us(void)
+{
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (int64_t)now.tv_sec*1000000 + now.tv_nsec/1000;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file      Fake_gateway.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the in-process gateway of the microbenchmarks.
+ *            It listens in the loopback interface with the transport and the wire
+ *            format of System_network.h, counts the commands that it receives and,
+ *            with TCP_CLIENT_GATEWAY_ACKS, acknowledges their frames. It is the C twin
+ *            of tools/bench_gateway.py for the host build.
+ */
+
+#ifndef HOST_FAKE_GATEWAY_H_
+#define HOST_FAKE_GATEWAY_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Network_config.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Opens the socket of the gateway and starts its thread.
+ *
+ * @param void
+ *
+ * @return True if the gateway listens, otherwise false.
+ */
+bool start_fake_gateway(void);
+
+/**
+ * @brief Sets the counters of the gateway to 0. The sequences received before are
+ *        still recognized as duplicates.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void reset_fake_gateway(void);
+
+/**
+ * @brief Returns the number of commands received, the duplicated frames excluded.
+ *
+ * @param void
+ *
+ * @return Number of commands.
+ */
+uint32_t fake_gateway_commands(void);
+
+/**
+ * @brief Returns the number of frames written again that the gateway discarded.
+ *
+ * @param void
+ *
+ * @return Number of duplicated frames.
+ */
+uint32_t fake_gateway_duplicates(void);
+
+/**
+ * @brief Returns the number of stats frames received, see TELEMETRY_REPORT_PERIOD_MS.
+ *
+ * @param void
+ *
+ * @return Number of stats frames.
+ */
+uint32_t fake_gateway_stats_frames(void);
+
+/**
+ * @brief Returns the last command received.
+ *
+ * @param cmd Where the command is copied.
+ *
+ * @return True if a command was received since the last reset, otherwise false.
+ */
+bool fake_gateway_last_command(TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Returns a command of the history, in the order that the gateway received
+ *        them since the last reset. The history keeps the first 1024 commands.
+ *
+ * @param index Position of the command, 0 is the first one after the reset.
+ *
+ * @param cmd Where the command is copied.
+ *
+ * @return True if the command is in the history, otherwise false.
+ */
+bool fake_gateway_command(const uint32_t index, TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Waits until the gateway received a number of commands.
+ *
+ * @param num_of_cmds Number of commands since the last reset.
+ *
+ * @param time_out_ms Maximum time to wait in milliseconds.
+ *
+ * @return True if the commands arrived, false if the time out expired.
+ */
+bool wait_for_fake_gateway_commands(const uint32_t num_of_cmds,
+  const uint32_t time_out_ms);
+
+/**
+ * @brief Waits until the gateway does not receive commands during some time.
+ *
+ * @param quiet_ms Time without commands in milliseconds.
+ *
+ * @return void
+ */
+void wait_for_fake_gateway_quiet(const uint32_t quiet_ms);
+
+#endif /* HOST_FAKE_GATEWAY_H_ */
@@ -0,0 +1,439 @@
+/**
+ * @file      Host_tests.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Tests of the core in the host build, ctest runs one of them per process:
+ *
+ *            - frame_round_trip: the records of every frame type are decoded as they
+ *              were encoded, and the broken headers are rejected.
+ *            - journal_compaction: a pair of toggles of a LED cancels, and only the
+ *              newest SET_PWM of every LED is kept.
+ *            - PWM_coalescing: a storm of SET_PWM commands only delivers newer duty
+ *              cycles of a LED, and the last one delivered is the newest one.
+ *            - dispatch_order: the presses of several buttons reach the gateway in
+ *              the order they happened. It expects the actions of System_actions.h,
+ *              BUTTON_0 toggles LED_0 and BUTTON_1 steps its duty cycle.
+ *
+ *            Usage: Host_tests <test>
+ *
+ *            It returns 0 if the test passed, SKIPPED_TEST if the build does not have
+ *            the tested module, otherwise 1.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Fake_gateway.h>
+#include <Host_shims.h>
+#include <Remote_switch.h>
+#include <TCP_client.h>
+#include <Frame.h>
+#include <Journal.h>
+#include <Debounce.h>
+#include <System_debounce.h>
+#include <System_lights.h>
+#include <System_network.h>
+#include <freertos/FreeRTOS.h>
+#include <esp_timer.h>
+#include <stdio.h>
+#include <string.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Tests of the program: name and if it needs the fake gateway and the TCP client. */
+#define HOST_TESTS                          \
+  HOST_TEST(frame_round_trip, false)        \
+  HOST_TEST(journal_compaction, false)      \
+  HOST_TEST(PWM_coalescing, true)           \
+  HOST_TEST(dispatch_order, true)
+
+/* Return of a test that can not run in this build, see SKIP_RETURN_CODE of ctest. */
+#define SKIPPED_TEST 77
+
+/* Time in milliseconds that the link has to come up. */
+#define LINK_TIME_OUT_MS 5000u
+
+/* Time in milliseconds that a test waits for its commands. */
+#define DELIVERY_TIME_OUT_MS 10000u
+
+/* Time in milliseconds without commands after which a storm was delivered, see
+ * QUIET_MS of Microbench.c.
+ */
+#define QUIET_MS 50u
+
+/* Number of duty cycles that the storm sends to every LED, from 1 to 100. */
+#define STORM_LEN 100u
+
+/* Number of rounds of three presses of the dispatch test. */
+#define DISPATCH_ROUNDS 20u
+
+/* Checks a condition of a test, the test fails with the first false one. */
+#define TEST_CHECK(condition)                                         \
+  do                                                                  \
+  {                                                                   \
+    if(!(condition))                                                  \
+    {                                                                 \
+      fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition); \
+      return 1;                                                       \
+    }                                                                 \
+  } while(0)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Function that runs a test, it returns the exit code of the program. */
+typedef int (*host_test_func)(void);
+
+/* Structure that describes a test. */
+typedef struct
+{
+  const char *name;
+  host_test_func func;
+  bool needs_gateway;
+} host_test;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Tests, see the file description.
+ *
+ * @param void
+ *
+ * @return 0 if the test passed, SKIPPED_TEST if it can not run, otherwise 1.
+ */
+#define HOST_TEST(test_name, needs_gateway) static int test_##test_name(void);
+  HOST_TESTS
+#undef HOST_TEST
+
+/**
+ * @brief Starts the fake gateway and connects the remote switches of all the buttons.
+ *
+ * @param void
+ *
+ * @return True if the link is up, otherwise false.
+ */
+static bool connect_to_fake_gateway(void);
+
+/**
+ * @brief Presses and releases a button from the ISR context.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return void
+ */
+static void press_button(const Button_ID ID);
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Table of the tests. */
+static const host_test host_tests[] =
+{
+  #define HOST_TEST(test_name, needs_gateway) \
+    { #test_name, test_##test_name, needs_gateway },
+    HOST_TESTS
+  #undef HOST_TEST
+};
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+int main(int argc, char **argv)
+{
+
+  if(argc == 2)
+  {
+    for(size_t i = 0u; i < sizeof(host_tests)/sizeof(host_tests[0]); i++)
+    {
+      if(strcmp(argv[1], host_tests[i].name) != 0)
+      {
+        continue;
+      }
+      if(host_tests[i].needs_gateway && !connect_to_fake_gateway())
+      {
+        fprintf(stderr, "The remote switch did not connect to the fake gateway.\n");
+        return 1;
+      }
+      return host_tests[i].func();
+    }
+  }
+
+  fprintf(stderr, "Usage: %s <test>, the tests are:\n", argv[0]);
+  for(size_t i = 0u; i < sizeof(host_tests)/sizeof(host_tests[0]); i++)
+  {
+    fprintf(stderr, "  %s\n", host_tests[i].name);
+  }
+
+  return 2;
+}
+
+static int test_frame_round_trip(void)
+{
+
+  uint8_t frame[FRAME_CMDS_SIZE(3u)];
+  Frame_header header;
+
+  /* Commands frame, with the lowest and the highest duty cycles. */
+  const TCP_COMMAND_TYPE cmds[3] =
+  {
+    { .ID = LED_0, .action = TOOGLE_LED },
+    { .ID = (LED_ID)(NUM_OF_LEDS - 1u), .action = SET_PWM, .pwm = 0u },
+    { .ID = LED_0, .action = SET_PWM, .pwm = MAX_DUTY_CYCLE_PERC },
+  };
+  size_t len = encode_frame_header(frame, FRAME_TYPE_COMMANDS, 0xABCDu, 3u);
+  for(size_t i = 0u; i < 3u; i++)
+  {
+    len += encode_cmd_record(frame + len, &cmds[i]);
+  }
+  TEST_CHECK(len == FRAME_CMDS_SIZE(3u));
+  TEST_CHECK(decode_frame_header(frame, len, &header) == CORE_FRAME_OK);
+  TEST_CHECK(header.version == FRAME_VERSION && header.type == FRAME_TYPE_COMMANDS);
+  TEST_CHECK(header.seq == 0xABCDu && header.count == 3u);
+  size_t offset = FRAME_HEADER_SIZE;
+  for(size_t i = 0u; i < 3u; i++)
+  {
+    TCP_COMMAND_TYPE cmd;
+    offset += decode_cmd_record(frame + offset, &cmd);
+    TEST_CHECK(cmd.ID == cmds[i].ID && cmd.action == cmds[i].action);
+    TEST_CHECK(cmd.action != SET_PWM || cmd.pwm == cmds[i].pwm);
+  }
+  TEST_CHECK(offset == len);
+
+  /* The header announces more records than the buffer has. */
+  TEST_CHECK(decode_frame_header(frame, len - 1u, &header) == CORE_FRAME_LEN_ERR);
+  TEST_CHECK(decode_frame_header(frame, FRAME_HEADER_SIZE - 1u, &header) ==
+    CORE_FRAME_TOO_SHORT_ERR);
+  frame[0] = (uint8_t)(FRAME_VERSION + 1u);
+  TEST_CHECK(decode_frame_header(frame, len, &header) == CORE_FRAME_VERSION_ERR);
+  frame[0] = (uint8_t)FRAME_VERSION;
+  frame[1] = 0u;
+  TEST_CHECK(decode_frame_header(frame, len, &header) == CORE_FRAME_TYPE_ERR);
+
+  /* State frame. */
+  const Frame_state_record state = { .ID = LED_0, .on = true, .pwm = 42u };
+  len = encode_frame_header(frame, FRAME_TYPE_STATE, 0u, 1u);
+  len += encode_state_record(frame + len, &state);
+  TEST_CHECK(len == FRAME_STATE_SIZE(1u));
+  TEST_CHECK(decode_frame_header(frame, len, &header) == CORE_FRAME_OK);
+  TEST_CHECK(header.type == FRAME_TYPE_STATE && header.count == 1u);
+  Frame_state_record decoded_state;
+  decode_state_record(frame + FRAME_HEADER_SIZE, &decoded_state);
+  TEST_CHECK(decoded_state.ID == state.ID && decoded_state.on == state.on &&
+    decoded_state.pwm == state.pwm);
+
+  /* Stats frame, the value keeps its 32 bits. */
+  const Frame_stats_record stats = { .ID = 7u, .value = 0xDEADBEEFu };
+  len = encode_frame_header(frame, FRAME_TYPE_STATS, 1u, 1u);
+  len += encode_stats_record(frame + len, &stats);
+  TEST_CHECK(len == FRAME_STATS_SIZE(1u));
+  TEST_CHECK(decode_frame_header(frame, len, &header) == CORE_FRAME_OK);
+  TEST_CHECK(header.type == FRAME_TYPE_STATS && header.seq == 1u);
+  Frame_stats_record decoded_stats;
+  decode_stats_record(frame + FRAME_HEADER_SIZE, &decoded_stats);
+  TEST_CHECK(decoded_stats.ID == stats.ID && decoded_stats.value == stats.value);
+
+  /* Ack, only a header. */
+  len = encode_frame_header(frame, FRAME_TYPE_ACK, 0xFFFFu, 0u);
+  TEST_CHECK(len == FRAME_ACK_SIZE);
+  TEST_CHECK(decode_frame_header(frame, len, &header) == CORE_FRAME_OK);
+  TEST_CHECK(header.type == FRAME_TYPE_ACK && header.seq == 0xFFFFu);
+
+  return 0;
+}
+
+static int test_journal_compaction(void)
+{
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    TCP_COMMAND_TYPE taken[TCP_CLIENT_JOURNAL_LEN];
+    TEST_CHECK(5u*NUM_OF_LEDS <= TCP_CLIENT_JOURNAL_LEN);
+
+    init_journal();
+
+    /* A pair of toggles leaves the LED as it was, nothing is replayed. */
+    const TCP_COMMAND_TYPE toggle_cmd = { .ID = LED_0, .action = TOOGLE_LED };
+    append_to_journal(&toggle_cmd);
+    append_to_journal(&toggle_cmd);
+    TEST_CHECK(take_from_journal(taken, TCP_CLIENT_JOURNAL_LEN) == 0u);
+    TEST_CHECK(journal_is_empty());
+
+    /* Three toggles and two duty cycles of every LED, interleaved. */
+    for(uint32_t LED = 0u; LED < NUM_OF_LEDS; LED++)
+    {
+      const TCP_COMMAND_TYPE cmds[5] =
+      {
+        { .ID = (LED_ID)LED, .action = TOOGLE_LED },
+        { .ID = (LED_ID)LED, .action = SET_PWM, .pwm = 10u },
+        { .ID = (LED_ID)LED, .action = TOOGLE_LED },
+        { .ID = (LED_ID)LED, .action = TOOGLE_LED },
+        { .ID = (LED_ID)LED, .action = SET_PWM, .pwm = (uint8_t)(20u + LED) },
+      };
+      for(size_t i = 0u; i < 5u; i++)
+      {
+        append_to_journal(&cmds[i]);
+      }
+    }
+
+    /* A toggle and the newest duty cycle are left of every LED. */
+    const size_t num_of_taken = take_from_journal(taken, TCP_CLIENT_JOURNAL_LEN);
+    TEST_CHECK(num_of_taken == 2u*NUM_OF_LEDS);
+    TEST_CHECK(journal_is_empty());
+    for(uint32_t LED = 0u; LED < NUM_OF_LEDS; LED++)
+    {
+      uint32_t toggles = 0u;
+      uint32_t PWMs = 0u;
+      for(size_t i = 0u; i < num_of_taken; i++)
+      {
+        if(taken[i].ID != (LED_ID)LED)
+        {
+          continue;
+        }
+        if(taken[i].action == TOOGLE_LED)
+        {
+          toggles++;
+        }
+        else
+        {
+          TEST_CHECK(taken[i].action == SET_PWM && taken[i].pwm == 20u + LED);
+          PWMs++;
+        }
+      }
+      TEST_CHECK(toggles == 1u && PWMs == 1u);
+    }
+
+    return 0;
+  #else
+    printf("journal_compaction: disabled, TCP_CLIENT_OFFLINE_JOURNAL is 0\n");
+    return SKIPPED_TEST;
+  #endif
+}
+
+static int test_PWM_coalescing(void)
+{
+
+  wait_for_fake_gateway_quiet(QUIET_MS);
+  reset_fake_gateway();
+
+  for(uint32_t pwm = 1u; pwm <= STORM_LEN; pwm++)
+  {
+    for(uint32_t LED = 0u; LED < NUM_OF_LEDS; LED++)
+    {
+      const TCP_COMMAND_TYPE cmd =
+      {
+        .ID = (LED_ID)LED,
+        .action = SET_PWM,
+        .pwm = (uint8_t)pwm,
+      };
+      try_send_message(cmd, 0u, TCP_CLIENT_DROP_OLDEST);
+    }
+  }
+  wait_for_fake_gateway_quiet(QUIET_MS);
+
+  /* The intermediate duty cycles can be missed, an older one after a newer one not. */
+  uint8_t delivered_PWMs[NUM_OF_LEDS] = {0u};
+  const uint32_t num_of_cmds = fake_gateway_commands();
+  TEST_CHECK(num_of_cmds > 0u && num_of_cmds <= STORM_LEN*NUM_OF_LEDS);
+  for(uint32_t i = 0u; i < num_of_cmds; i++)
+  {
+    TCP_COMMAND_TYPE cmd;
+    TEST_CHECK(fake_gateway_command(i, &cmd));
+    TEST_CHECK(cmd.action == SET_PWM && cmd.ID < NUM_OF_LEDS);
+    TEST_CHECK(cmd.pwm > delivered_PWMs[cmd.ID]);
+    delivered_PWMs[cmd.ID] = cmd.pwm;
+  }
+  for(uint32_t LED = 0u; LED < NUM_OF_LEDS; LED++)
+  {
+    TEST_CHECK(delivered_PWMs[LED] == STORM_LEN);
+  }
+
+  printf("PWM_coalescing: sent=%u delivered=%u\n",
+    (unsigned int)(STORM_LEN*NUM_OF_LEDS), (unsigned int)num_of_cmds);
+
+  return 0;
+}
+
+static int test_dispatch_order(void)
+{
+
+  wait_for_fake_gateway_quiet(QUIET_MS);
+  reset_fake_gateway();
+
+  uint32_t num_of_cmds = 0u;
+  uint32_t num_of_steps = 0u;
+  for(uint32_t round = 0u; round < DISPATCH_ROUNDS; round++)
+  {
+    /* The press of BUTTON_1 moves along the round, so no order is fixed. A round has
+     * one duty cycle, the TX task can not merge it with the one of other round.
+     */
+    Button_ID presses[3] = { BUTTON_0, BUTTON_0, BUTTON_0 };
+    presses[round % 3u] = BUTTON_1;
+    for(size_t i = 0u; i < 3u; i++)
+    {
+      press_button(presses[i]);
+    }
+    TEST_CHECK(wait_for_fake_gateway_commands(num_of_cmds + 3u, DELIVERY_TIME_OUT_MS));
+
+    for(size_t i = 0u; i < 3u; i++)
+    {
+      TCP_COMMAND_TYPE cmd;
+      TEST_CHECK(fake_gateway_command(num_of_cmds, &cmd));
+      TEST_CHECK(cmd.ID == LED_0);
+      if(presses[i] == BUTTON_0)
+      {
+        TEST_CHECK(cmd.action == TOOGLE_LED);
+      }
+      else
+      {
+        TEST_CHECK(cmd.action == SET_PWM);
+        TEST_CHECK(cmd.pwm ==
+          MIN_DUTY_CYCLE_PERC + (num_of_steps % NUM_OF_PWM_STEPS)*PWM_STEP_PERC);
+        num_of_steps++;
+      }
+      num_of_cmds++;
+    }
+  }
+  TEST_CHECK(fake_gateway_commands() == num_of_cmds);
+
+  return 0;
+}
+
+static bool connect_to_fake_gateway(void)
+{
+
+  if(!start_fake_gateway() || init_BSP_button_module() != BSP_BUTTON_OK ||
+     remote_switch_start_client() != CORE_REMOTE_SWITCH_OK)
+  {
+    return false;
+  }
+  for(uint32_t ID = 0u; ID < NUM_OF_BUTTONS; ID++)
+  {
+    if(init_remote_switch((Button_ID)ID) != CORE_REMOTE_SWITCH_OK)
+    {
+      return false;
+    }
+  }
+
+  return (wait_for_connection(pdMS_TO_TICKS(LINK_TIME_OUT_MS)) == CORE_TCP_CLIENT_OK);
+}
+
+static void press_button(const Button_ID ID)
+{
+
+  /* The edges skip the sampling of the debounce engine, they are already stable. */
+  host_ISR_enter();
+  #if SYSTEM_DEBOUNCE_ENGINE == 1
+    debounce_CB(ID, BUTTON_IS_PRESSED, esp_timer_get_time());
+    debounce_CB(ID, BUTTON_IS_NOT_PRESSED, esp_timer_get_time());
+  #else
+    button_CB(ID);
+  #endif
+  host_ISR_exit();
+}
@@ -0,0 +1,489 @@
+/**
+ * @file      Microbench.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Microbenchmarks of the core in the host build. They run the hot paths
+ *            that do not need the radio against the in-process gateway and print one
+ *            line per benchmark, the best of the repetitions:
+ *
+ *            - frame_encode: encoding of headers and command records.
+ *            - journal: append and take of the offline journal, with its merges.
+ *            - send_message: try_send_message until the gateway receives the command,
+ *              with the heap allocations per command.
+ *            - coalesce: a storm of SET_PWM commands, sent against delivered.
+ *            - dispatch: a press from the ISR context until the gateway receives its
+ *              command, one press at a time.
+ *            - telemetry: the counters of the core after the benchmarks, and the
+ *              stats frames that reached the gateway.
+ *
+ *            Usage: Microbench [--events N] [--repeat R]
+ *
+ *            It returns 1 if a command does not reach the gateway.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Fake_gateway.h>
+#include <Host_shims.h>
+#include <Remote_switch.h>
+#include <TCP_client.h>
+#include <Frame.h>
+#include <Journal.h>
+#include <Debounce.h>
+#include <Telemetry.h>
+#include <System_debounce.h>
+#include <System_network.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Default number of events and repetitions of every benchmark. */
+#define DEFAULT_EVENTS 1000u
+#define DEFAULT_REPEAT 5u
+
+/* Time in milliseconds that the link has to come up. */
+#define LINK_TIME_OUT_MS 5000u
+
+/* Time in milliseconds that a benchmark waits for its commands. */
+#define DELIVERY_TIME_OUT_MS 10000u
+
+/* Time in milliseconds without commands after which a storm was delivered. The TX
+ * task joins the commands during TCP_CLIENT_TX_LINGER_MS, so it is several times it.
+ */
+#define QUIET_MS 50u
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that contains the arguments of the program. */
+typedef struct
+{
+  uint32_t events;
+  uint32_t repeat;
+} bench_args;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Destination of the benchmarked results, so the compiler keeps the loops. */
+static volatile uint32_t sink;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Returns the time in nanoseconds of CLOCK_MONOTONIC.
+ *
+ * @param void
+ *
+ * @return Time in nanoseconds.
+ */
+static uint64_t now_ns(void);
+
+/**
+ * @brief Compares two measures for qsort.
+ *
+ * @return Negative, 0 or positive if the first one is lower, equal or greater.
+ */
+static int compare_measures(const void *a, const void *b);
+
+/**
+ * @brief Sorts the measures and returns one of their percentiles.
+ *
+ * @return Upper bound of the given fraction of the measures.
+ */
+static uint64_t percentile(uint64_t *measures, const uint32_t num_of_measures,
+  const double fraction);
+
+/**
+ * @brief Benchmarks, see the file description.
+ *
+ * @param args Number of events and of repetitions.
+ *
+ * @return True if the benchmark passed, otherwise false.
+ */
+static bool bench_frame_encode(const bench_args *args);
+static bool bench_journal(const bench_args *args);
+static bool bench_send_message(const bench_args *args);
+static bool bench_coalesce(const bench_args *args);
+static bool bench_dispatch(const bench_args *args);
+
+/**
+ * @brief Prints the telemetry counters of the core, they are not measures of the
+ *        benchmarks so they can not fail.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void print_bench_telemetry(void);
+
+/**
+ * @brief Presses and releases a button from the ISR context.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return void
+ */
+static void press_button(const Button_ID ID);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+int main(int argc, char **argv)
+{
+
+  bench_args args = { .events = DEFAULT_EVENTS, .repeat = DEFAULT_REPEAT };
+  for(int i = 1; i < argc; i++)
+  {
+    if(strcmp(argv[i], "--events") == 0 && i + 1 < argc)
+    {
+      args.events = (uint32_t)strtoul(argv[++i], NULL, 10);
+    }
+    else if(strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+    {
+      args.repeat = (uint32_t)strtoul(argv[++i], NULL, 10);
+    }
+    else
+    {
+      fprintf(stderr, "Usage: %s [--events N] [--repeat R]\n", argv[0]);
+      return 2;
+    }
+  }
+  if(args.events == 0u || args.repeat == 0u)
+  {
+    fprintf(stderr, "The events and the repetitions must be positive.\n");
+    return 2;
+  }
+
+  bool passed = bench_frame_encode(&args) && bench_journal(&args);
+
+  /* The rest of benchmarks go through the TX task and the gateway. */
+  if(!start_fake_gateway())
+  {
+    fprintf(stderr, "Can not start the fake gateway on port %u.\n",
+      (unsigned int)TCP_IP_PORT);
+    return 1;
+  }
+  if(init_BSP_button_module() != BSP_BUTTON_OK ||
+     remote_switch_start_client() != CORE_REMOTE_SWITCH_OK ||
+     init_remote_switch(BUTTON_0) != CORE_REMOTE_SWITCH_OK ||
+     wait_for_connection(pdMS_TO_TICKS(LINK_TIME_OUT_MS)) != CORE_TCP_CLIENT_OK)
+  {
+    fprintf(stderr, "The remote switch did not connect to the fake gateway.\n");
+    return 1;
+  }
+
+  passed = bench_send_message(&args) && passed;
+  passed = bench_coalesce(&args) && passed;
+  passed = bench_dispatch(&args) && passed;
+  print_bench_telemetry();
+
+  return passed ? 0 : 1;
+}
+
+static uint64_t now_ns(void)
+{
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec*1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static int compare_measures(const void *a, const void *b)
+{
+
+  const uint64_t first = *(const uint64_t *)a;
+  const uint64_t second = *(const uint64_t *)b;
+
+  return (first > second) - (first < second);
+}
+
+static uint64_t percentile(uint64_t *measures, const uint32_t num_of_measures,
+  const double fraction)
+{
+
+  qsort(measures, num_of_measures, sizeof(uint64_t), compare_measures);
+  uint32_t index = (uint32_t)(fraction*num_of_measures);
+  if(index >= num_of_measures)
+  {
+    index = num_of_measures - 1u;
+  }
+
+  return measures[index];
+}
+
+static bool bench_frame_encode(const bench_args *args)
+{
+
+  uint8_t frame[FRAME_CMDS_SIZE(FRAME_MAX_RECORDS)];
+  uint64_t best_ns = UINT64_MAX;
+
+  for(uint32_t r = 0u; r < args->repeat; r++)
+  {
+    const uint64_t start_ns = now_ns();
+    uint32_t encoded = 0u;
+    uint16_t seq = 0u;
+    while(encoded < args->events)
+    {
+      uint32_t count = args->events - encoded;
+      if(count > FRAME_MAX_RECORDS)
+      {
+        count = FRAME_MAX_RECORDS;
+      }
+
+      size_t len = encode_frame_header(frame, FRAME_TYPE_COMMANDS, seq++,
+        (uint8_t)count);
+      for(uint32_t i = 0u; i < count; i++)
+      {
+        const TCP_COMMAND_TYPE cmd =
+        {
+          .ID = (LED_ID)((encoded + i) % NUM_OF_LEDS),
+          .action = SET_PWM,
+          .pwm = (uint8_t)((encoded + i) % 101u),
+        };
+        len += encode_cmd_record(frame + len, &cmd);
+      }
+      sink += frame[len - 1u];
+      encoded += count;
+    }
+    const uint64_t elapsed_ns = now_ns() - start_ns;
+    if(elapsed_ns < best_ns)
+    {
+      best_ns = elapsed_ns;
+    }
+  }
+
+  printf("frame_encode: records=%" PRIu32 " ns/record=%.1f\n", args->events,
+    (double)best_ns/args->events);
+
+  return true;
+}
+
+static bool bench_journal(const bench_args *args)
+{
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    TCP_COMMAND_TYPE taken[TCP_CLIENT_JOURNAL_LEN];
+    uint64_t best_ns = UINT64_MAX;
+    uint32_t num_of_taken = 0u;
+
+    init_journal();
+    for(uint32_t r = 0u; r < args->repeat; r++)
+    {
+      num_of_taken = 0u;
+      const uint64_t start_ns = now_ns();
+      for(uint32_t i = 0u; i < args->events; i++)
+      {
+        const TCP_COMMAND_TYPE cmd = { .ID = LED_0, .action = TOOGLE_LED };
+        append_to_journal(&cmd);
+        /* Drain it when it is full, as the TX task does when the link comes back. */
+        if((i + 1u) % TCP_CLIENT_JOURNAL_LEN == 0u)
+        {
+          num_of_taken += take_from_journal(taken, TCP_CLIENT_JOURNAL_LEN);
+        }
+      }
+      num_of_taken += take_from_journal(taken, TCP_CLIENT_JOURNAL_LEN);
+      const uint64_t elapsed_ns = now_ns() - start_ns;
+      if(elapsed_ns < best_ns)
+      {
+        best_ns = elapsed_ns;
+      }
+    }
+
+    /* The journal merges the toggles of a LED, so fewer commands are taken. */
+    printf("journal: appended=%" PRIu32 " taken=%" PRIu32 " ns/cmd=%.1f\n",
+      args->events, num_of_taken, (double)best_ns/args->events);
+  #else
+    printf("journal: disabled, TCP_CLIENT_OFFLINE_JOURNAL is 0\n");
+  #endif
+
+  return true;
+}
+
+static bool bench_send_message(const bench_args *args)
+{
+
+  uint64_t best_ns = UINT64_MAX;
+  uint64_t best_allocs = UINT64_MAX;
+  bool passed = true;
+
+  for(uint32_t r = 0u; r < args->repeat; r++)
+  {
+    reset_fake_gateway();
+    const uint64_t start_allocs = host_heap_allocations();
+    const uint64_t start_ns = now_ns();
+    for(uint32_t i = 0u; i < args->events; i++)
+    {
+      const TCP_COMMAND_TYPE cmd = { .ID = LED_0, .action = TOOGLE_LED };
+      try_send_message(cmd, portMAX_DELAY, TCP_CLIENT_DROP_NEWEST);
+    }
+    const bool delivered = wait_for_fake_gateway_commands(args->events,
+      DELIVERY_TIME_OUT_MS);
+    const uint64_t elapsed_ns = now_ns() - start_ns;
+    const uint64_t allocs = host_heap_allocations() - start_allocs;
+
+    if(elapsed_ns < best_ns)
+    {
+      best_ns = elapsed_ns;
+    }
+    if(allocs < best_allocs)
+    {
+      best_allocs = allocs;
+    }
+    passed = passed && delivered;
+  }
+
+  printf("send_message: cmds=%" PRIu32 " ns/cmd=%.1f allocs/cmd=%.3f%s\n",
+    args->events, (double)best_ns/args->events, (double)best_allocs/args->events,
+    passed ? "" : " MISSING");
+
+  return passed;
+}
+
+static bool bench_coalesce(const bench_args *args)
+{
+
+  uint32_t best_delivered = UINT32_MAX;
+  bool passed = true;
+
+  for(uint32_t r = 0u; r < args->repeat; r++)
+  {
+    wait_for_fake_gateway_quiet(QUIET_MS);
+    reset_fake_gateway();
+
+    TCP_COMMAND_TYPE cmd = { .ID = LED_0, .action = SET_PWM };
+    for(uint32_t i = 0u; i < args->events; i++)
+    {
+      cmd.pwm = (uint8_t)(i % 101u);
+      try_send_message(cmd, 0u, TCP_CLIENT_DROP_OLDEST);
+    }
+    wait_for_fake_gateway_quiet(QUIET_MS);
+
+    /* The gateway can miss the intermediate duty cycles, never the last one. */
+    TCP_COMMAND_TYPE last_cmd;
+    passed = passed && fake_gateway_last_command(&last_cmd) &&
+      last_cmd.action == SET_PWM && last_cmd.pwm == cmd.pwm;
+
+    const uint32_t delivered = fake_gateway_commands();
+    if(delivered < best_delivered)
+    {
+      best_delivered = delivered;
+    }
+  }
+
+  printf("coalesce: sent=%" PRIu32 " delivered=%" PRIu32 " ratio=%.3f%s\n",
+    args->events, best_delivered, (double)best_delivered/args->events,
+    passed ? "" : " LAST_PWM_MISSING");
+
+  return passed;
+}
+
+static bool bench_dispatch(const bench_args *args)
+{
+
+  uint64_t *latencies_ns = malloc(sizeof(uint64_t)*args->events);
+  if(latencies_ns == NULL)
+  {
+    return false;
+  }
+
+  uint64_t best_p50_ns = UINT64_MAX;
+  uint64_t best_p99_ns = UINT64_MAX;
+  uint64_t best_max_ns = UINT64_MAX;
+  bool passed = true;
+
+  for(uint32_t r = 0u; r < args->repeat && passed; r++)
+  {
+    wait_for_fake_gateway_quiet(QUIET_MS);
+    reset_fake_gateway();
+
+    for(uint32_t i = 0u; i < args->events && passed; i++)
+    {
+      const uint64_t start_ns = now_ns();
+      press_button(BUTTON_0);
+      passed = wait_for_fake_gateway_commands(i + 1u, DELIVERY_TIME_OUT_MS);
+      latencies_ns[i] = now_ns() - start_ns;
+    }
+    if(!passed)
+    {
+      break;
+    }
+
+    const uint64_t p50_ns = percentile(latencies_ns, args->events, 0.50);
+    const uint64_t p99_ns = percentile(latencies_ns, args->events, 0.99);
+    const uint64_t max_ns = latencies_ns[args->events - 1u];
+    if(p99_ns < best_p99_ns)
+    {
+      best_p50_ns = p50_ns;
+      best_p99_ns = p99_ns;
+      best_max_ns = max_ns;
+    }
+  }
+  free(latencies_ns);
+
+  if(passed)
+  {
+    printf("dispatch: presses=%" PRIu32 " p50=%.1fus p99=%.1fus max=%.1fus\n",
+      args->events, best_p50_ns/1000.0, best_p99_ns/1000.0, best_max_ns/1000.0);
+  }
+  else
+  {
+    printf("dispatch: presses=%" PRIu32 " MISSING\n", args->events);
+  }
+
+  return passed;
+}
+
+static void print_bench_telemetry(void)
+{
+
+  #if SYSTEM_TELEMETRY == 1
+    /* Every value is valid, the reads can not fail. */
+    uint32_t values[NUM_OF_TELEMETRY_VALUES];
+    for(uint32_t ID = 0u; ID < NUM_OF_TELEMETRY_VALUES; ID++)
+    {
+      get_telemetry((Telemetry_ID)ID, &values[ID]);
+    }
+
+    printf("telemetry: enqueued=%" PRIu32 " dropped=%" PRIu32 " writes=%" PRIu32
+      " queue_high_water=%" PRIu32 " open_sockets=%" PRIu32 " TX_stack_free=%" PRIu32
+      " stats_frames=%" PRIu32 "\n", values[TELEMETRY_CMDS_ENQUEUED],
+      values[TELEMETRY_DROPPED_NEWEST] + values[TELEMETRY_DROPPED_OLDEST],
+      values[TELEMETRY_WRITES], values[TELEMETRY_TX_QUEUE_HIGH_WATER],
+      values[TELEMETRY_SOCKETS_OPENED] - values[TELEMETRY_SOCKETS_CLOSED],
+      values[TELEMETRY_TX_STACK_LOW_WATER], fake_gateway_stats_frames());
+  #else
+    printf("telemetry: disabled, SYSTEM_TELEMETRY is 0\n");
+  #endif
+}
+
+static void press_button(const Button_ID ID)
+{
+
+  /* The edges skip the sampling of the debounce engine, they are already stable. */
+  host_ISR_enter();
+  #if SYSTEM_DEBOUNCE_ENGINE == 1
+    debounce_CB(ID, BUTTON_IS_PRESSED, esp_timer_get_time());
+    debounce_CB(ID, BUTTON_IS_NOT_PRESSED, esp_timer_get_time());
+  #else
+    button_CB(ID);
+  #endif
+  host_ISR_exit();
+}
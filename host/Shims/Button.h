@@ -0,0 +1,94 @@
+/**
+ * @file      Button.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host stand-in of the Button submodule. The GPIO of every button calls
+ *            button_CB from its interruption, see host_set_GPIO_level -> Host_shims.h
+ */
+
+#ifndef HOST_BUTTON_H_
+#define HOST_BUTTON_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Button_physical_connection.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that the button module can return. */
+#define BUTTON_RETURNS                       \
+  /* Info codes */                           \
+  BUTTON_RETURN(BSP_BUTTON_OK)               \
+  /* Error codes */                          \
+  BUTTON_RETURN(BSP_BUTTON_INIT_ERR)         \
+  BUTTON_RETURN(BSP_BUTTON_DE_INIT_ERR)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define BUTTON_RETURN(enumerate) enumerate,
+    BUTTON_RETURNS
+  #undef BUTTON_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_BUTTON_RETURNS,
+} Button_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Initializes the interruption service of the buttons.
+ *
+ * @param void
+ *
+ * @return BSP_BUTTON_OK if the operation went well, otherwise BSP_BUTTON_INIT_ERR.
+ */
+Button_return init_BSP_button_module(void);
+
+/**
+ * @brief Configures the GPIO of a button and attaches its interruption.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return BSP_BUTTON_OK if the operation went well, otherwise BSP_BUTTON_INIT_ERR.
+ */
+Button_return init_button(const Button_ID ID);
+
+/**
+ * @brief Detaches the interruption of a button.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return BSP_BUTTON_OK if the operation went well, otherwise
+ *         BSP_BUTTON_DE_INIT_ERR.
+ */
+Button_return de_init_button(const Button_ID ID);
+
+/**
+ * @brief Callback of a press, called in ISR context.
+ *
+ * @param ID Identifier of the pressed button.
+ *
+ * @return void
+ */
+void button_CB(const Button_ID ID);
+
+/**
+ * @brief Prints the return of a button module function in debug mode.
+ *
+ * @param ret Received return from a button module function.
+ *
+ * @return The given return.
+ */
+Button_return BPS_button_LOG(const Button_return ret);
+
+#endif /* HOST_BUTTON_H_ */
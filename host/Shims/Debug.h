@@ -0,0 +1,51 @@
+/**
+ * @file      Debug.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host stand-in of the Debug submodule. The traces are printed in the
+ *            format of esp_log, with the milliseconds since the start.
+ */
+
+#ifndef HOST_DEBUG_H_
+#define HOST_DEBUG_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_err.h>
+#include <esp_timer.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* The microbenchmarks measure the core without its traces, see host/CMakeLists.txt */
+#ifndef DEBUG_MODE_ENABLE
+  #define DEBUG_MODE_ENABLE 0
+#endif
+
+#define HOST_LOG(level, tag, format, ...)                                          \
+  printf(level " (%" PRId64 ") %s: " format "\n", esp_timer_get_time()/1000, tag,  \
+    ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...) HOST_LOG("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_LOG("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_LOG("I", tag, format, ##__VA_ARGS__)
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Prints an ESP-IDF error in debug mode.
+ *
+ * @param err Error to check.
+ *
+ * @return The given error.
+ */
+esp_err_t ESP_error_check(const esp_err_t err);
+
+#endif /* HOST_DEBUG_H_ */
@@ -0,0 +1,665 @@
+/**
+ * @file      Esp_shim.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the host shims of esp_timer, the CRC of the ROM,
+ *            the random number generator, the NVS blobs and the GPIO driver.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Host_shims.h>
+#include <freertos/FreeRTOS.h>
+#include <esp_timer.h>
+#include <esp_rom_crc.h>
+#include <esp_random.h>
+#include <nvs_flash.h>
+#include <nvs.h>
+#include <driver/gpio.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Maximum number of NVS blobs and size in bytes of every one. */
+#define NVS_MAX_BLOBS    8u
+#define NVS_MAX_BLOB_LEN 256u
+
+/* Maximum length of a NVS namespace or key, the terminator included. */
+#define NVS_MAX_NAME_LEN 16u
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that contains a timer, its callbacks run in its own thread. */
+struct esp_timer
+{
+  esp_timer_create_args_t args;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  bool armed;
+  bool periodic;
+  bool deleted;
+  uint64_t period_us;
+  int64_t next_us;
+};
+
+/* Structure that contains a NVS blob. */
+typedef struct
+{
+  bool used;
+  char name_space[NVS_MAX_NAME_LEN];
+  char key[NVS_MAX_NAME_LEN];
+  uint8_t value[NVS_MAX_BLOB_LEN];
+  size_t len;
+} nvs_blob;
+
+/* Structure that contains the state of a GPIO. */
+typedef struct
+{
+  int level;
+  gpio_int_type_t intr_type;
+  bool intr_enabled;
+  gpio_isr_t handler;
+  void *args;
+} GPIO_state;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Time of CLOCK_MONOTONIC when the program started. */
+static struct timespec boot_time;
+
+/* Blobs of the NVS partition and lock of the table. */
+static nvs_blob nvs_blobs[NVS_MAX_BLOBS];
+static pthread_mutex_t nvs_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Namespaces of the open handles, the handle is the index plus one. */
+static char nvs_handles[NVS_MAX_BLOBS][NVS_MAX_NAME_LEN];
+
+/* States of the GPIOs and lock of the table. */
+static GPIO_state GPIO_states[GPIO_NUM_MAX];
+static pthread_mutex_t GPIO_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Indicates if the GPIO interruption service was installed. */
+static bool GPIO_ISR_service_installed;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Takes the start time of the program before main.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void __attribute__((constructor)) take_boot_time(void);
+
+/**
+ * @brief Thread of a timer, it waits until its next expiration and runs its callback.
+ *
+ * @param args The timer.
+ *
+ * @return NULL
+ */
+static void *timer_func(void *args);
+
+/**
+ * @brief Arms a timer.
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if it is already armed.
+ */
+static esp_err_t arm_timer(esp_timer_handle_t timer, const uint64_t time_us,
+  const bool periodic);
+
+/**
+ * @brief Finds a blob of the NVS partition, the lock must be taken.
+ *
+ * @return The blob, NULL if it does not exist.
+ */
+static nvs_blob *find_nvs_blob(const nvs_handle_t handle, const char *key);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+int64_t esp_timer_get_time(void)
+{
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (int64_t)(now.tv_sec - boot_time.tv_sec)*1000000 +
+    (now.tv_nsec - boot_time.tv_nsec)/1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args,
+  esp_timer_handle_t *out_handle)
+{
+
+  if(create_args == NULL || create_args->callback == NULL || out_handle == NULL)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  struct esp_timer *timer = calloc(1u, sizeof(struct esp_timer));
+  if(timer == NULL)
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  timer->args = *create_args;
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&timer->changed, &attr);
+  pthread_condattr_destroy(&attr);
+  pthread_mutex_init(&timer->lock, NULL);
+
+  if(pthread_create(&timer->thread, NULL, timer_func, timer) != 0)
+  {
+    free(timer);
+    return ESP_ERR_NO_MEM;
+  }
+  pthread_detach(timer->thread);
+
+  *out_handle = timer;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, const uint64_t timeout_us)
+{
+
+  return arm_timer(timer, timeout_us, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, const uint64_t period_us)
+{
+
+  return arm_timer(timer, period_us, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+
+  pthread_mutex_lock(&timer->lock);
+  const bool was_armed = timer->armed;
+  timer->armed = false;
+  pthread_cond_signal(&timer->changed);
+  pthread_mutex_unlock(&timer->lock);
+
+  return was_armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+
+  /* The thread frees the timer when it sees the flag. */
+  pthread_mutex_lock(&timer->lock);
+  if(timer->armed)
+  {
+    pthread_mutex_unlock(&timer->lock);
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->deleted = true;
+  pthread_cond_signal(&timer->changed);
+  pthread_mutex_unlock(&timer->lock);
+
+  return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+
+  pthread_mutex_lock(&timer->lock);
+  const bool armed = timer->armed;
+  pthread_mutex_unlock(&timer->lock);
+
+  return armed;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+
+  crc = ~crc;
+  for(uint32_t i = 0u; i < len; i++)
+  {
+    crc ^= buf[i];
+    for(uint8_t bit = 0u; bit < 8u; bit++)
+    {
+      crc = (crc >> 1u) ^ ((crc & 1u) ? 0xEDB88320u : 0u);
+    }
+  }
+
+  return ~crc;
+}
+
+uint32_t esp_random(void)
+{
+
+  /* Two calls, the libc generator gives 31 bits. */
+  return ((uint32_t)random() << 16u) ^ (uint32_t)random();
+}
+
+esp_err_t nvs_flash_init(void)
+{
+
+  return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, const nvs_open_mode_t open_mode,
+  nvs_handle_t *out_handle)
+{
+
+  if(name == NULL || strlen(name) >= NVS_MAX_NAME_LEN || out_handle == NULL)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&nvs_lock);
+
+  /* As in the device, a namespace without blobs can not be opened to read. */
+  bool name_space_exists = false;
+  for(size_t i = 0u; i < NVS_MAX_BLOBS; i++)
+  {
+    if(nvs_blobs[i].used && strcmp(nvs_blobs[i].name_space, name) == 0)
+    {
+      name_space_exists = true;
+    }
+  }
+
+  esp_err_t ret = ESP_ERR_NVS_NOT_FOUND;
+  if(name_space_exists || open_mode == NVS_READWRITE)
+  {
+    ret = ESP_ERR_NO_MEM;
+    for(size_t i = 0u; i < NVS_MAX_BLOBS; i++)
+    {
+      if(nvs_handles[i][0] == '\0')
+      {
+        strcpy(nvs_handles[i], name);
+        *out_handle = (nvs_handle_t)(i + 1u);
+        ret = ESP_OK;
+        break;
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&nvs_lock);
+
+  return ret;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+
+  if(handle == 0u || handle > NVS_MAX_BLOBS)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&nvs_lock);
+  nvs_handles[handle - 1u][0] = '\0';
+  pthread_mutex_unlock(&nvs_lock);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value,
+  size_t *length)
+{
+
+  pthread_mutex_lock(&nvs_lock);
+
+  const nvs_blob *blob = find_nvs_blob(handle, key);
+  esp_err_t ret = ESP_ERR_NVS_NOT_FOUND;
+  if(blob != NULL)
+  {
+    ret = ESP_OK;
+    if(out_value != NULL)
+    {
+      if(*length < blob->len)
+      {
+        ret = ESP_ERR_INVALID_SIZE;
+      }
+      else
+      {
+        memcpy(out_value, blob->value, blob->len);
+      }
+    }
+    *length = blob->len;
+  }
+
+  pthread_mutex_unlock(&nvs_lock);
+
+  return ret;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value,
+  const size_t length)
+{
+
+  if(handle == 0u || handle > NVS_MAX_BLOBS || key == NULL ||
+     strlen(key) >= NVS_MAX_NAME_LEN || length > NVS_MAX_BLOB_LEN)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&nvs_lock);
+
+  nvs_blob *blob = find_nvs_blob(handle, key);
+  for(size_t i = 0u; blob == NULL && i < NVS_MAX_BLOBS; i++)
+  {
+    if(!nvs_blobs[i].used)
+    {
+      blob = &nvs_blobs[i];
+      blob->used = true;
+      strcpy(blob->name_space, nvs_handles[handle - 1u]);
+      strcpy(blob->key, key);
+    }
+  }
+  if(blob != NULL)
+  {
+    memcpy(blob->value, value, length);
+    blob->len = length;
+  }
+
+  pthread_mutex_unlock(&nvs_lock);
+
+  return (blob != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+
+  pthread_mutex_lock(&nvs_lock);
+  nvs_blob *blob = find_nvs_blob(handle, key);
+  if(blob != NULL)
+  {
+    blob->used = false;
+  }
+  pthread_mutex_unlock(&nvs_lock);
+
+  return (blob != NULL) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+
+  return ESP_OK;
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  for(uint32_t GPIO = 0u; GPIO < GPIO_NUM_MAX; GPIO++)
+  {
+    if((config->pin_bit_mask & ((uint64_t)1u << GPIO)) != 0u)
+    {
+      /* The button is released, the pull resistor sets the level. */
+      GPIO_states[GPIO].level = (config->pull_up_en == GPIO_PULLUP_ENABLE) ? 1 : 0;
+      GPIO_states[GPIO].intr_type = config->intr_type;
+    }
+  }
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return ESP_OK;
+}
+
+int gpio_get_level(const gpio_num_t GPIO)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  const int level = GPIO_states[GPIO].level;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return level;
+}
+
+esp_err_t gpio_set_intr_type(const gpio_num_t GPIO, const gpio_int_type_t intr_type)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  GPIO_states[GPIO].intr_type = intr_type;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(const gpio_num_t GPIO)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  GPIO_states[GPIO].intr_enabled = true;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(const gpio_num_t GPIO)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  GPIO_states[GPIO].intr_enabled = false;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(const int intr_alloc_flags)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  const bool was_installed = GPIO_ISR_service_installed;
+  GPIO_ISR_service_installed = true;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return was_installed ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(const gpio_num_t GPIO, gpio_isr_t isr_handler,
+  void *args)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  const bool installed = GPIO_ISR_service_installed;
+  if(installed)
+  {
+    GPIO_states[GPIO].handler = isr_handler;
+    GPIO_states[GPIO].args = args;
+  }
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t gpio_isr_handler_remove(const gpio_num_t GPIO)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  GPIO_states[GPIO].handler = NULL;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_enable(const gpio_num_t GPIO, const gpio_int_type_t intr_type)
+{
+
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(const gpio_num_t GPIO)
+{
+
+  return ESP_OK;
+}
+
+void host_set_GPIO_level(const gpio_num_t GPIO, const int level)
+{
+
+  pthread_mutex_lock(&GPIO_lock);
+  GPIO_state *state = &GPIO_states[GPIO];
+  const int previous_level = state->level;
+  state->level = level;
+
+  bool fires = false;
+  switch(state->intr_type)
+  {
+    case GPIO_INTR_POSEDGE:
+      fires = (previous_level == 0 && level != 0);
+      break;
+    case GPIO_INTR_NEGEDGE:
+      fires = (previous_level != 0 && level == 0);
+      break;
+    case GPIO_INTR_ANYEDGE:
+      fires = (previous_level != level);
+      break;
+    case GPIO_INTR_LOW_LEVEL:
+      fires = (level == 0);
+      break;
+    case GPIO_INTR_HIGH_LEVEL:
+      fires = (level != 0);
+      break;
+    default:
+      break;
+  }
+  fires = fires && state->intr_enabled && state->handler != NULL;
+  const gpio_isr_t handler = state->handler;
+  void *args = state->args;
+  pthread_mutex_unlock(&GPIO_lock);
+
+  /* The handler runs in the caller, as the interruption of the core that sets it. */
+  if(fires)
+  {
+    host_ISR_enter();
+    handler(args);
+    host_ISR_exit();
+  }
+}
+
+static void __attribute__((constructor)) take_boot_time(void)
+{
+
+  clock_gettime(CLOCK_MONOTONIC, &boot_time);
+}
+
+static void *timer_func(void *args)
+{
+
+  struct esp_timer *timer = (struct esp_timer *)args;
+
+  pthread_mutex_lock(&timer->lock);
+  while(!timer->deleted)
+  {
+    if(!timer->armed)
+    {
+      pthread_cond_wait(&timer->changed, &timer->lock);
+      continue;
+    }
+
+    const int64_t now_us = esp_timer_get_time();
+    if(now_us < timer->next_us)
+    {
+      const int64_t wake_us = timer->next_us;
+      struct timespec deadline =
+      {
+        .tv_sec = boot_time.tv_sec + (time_t)(wake_us/1000000),
+        .tv_nsec = boot_time.tv_nsec + (long)((wake_us%1000000)*1000),
+      };
+      if(deadline.tv_nsec >= 1000000000L)
+      {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&timer->changed, &timer->lock, &deadline);
+      continue;
+    }
+
+    if(timer->periodic)
+    {
+      timer->next_us += (int64_t)timer->period_us;
+      /* The expirations that were missed are not run. */
+      if(timer->next_us <= now_us)
+      {
+        timer->next_us = now_us + (int64_t)timer->period_us;
+      }
+    }
+    else
+    {
+      timer->armed = false;
+    }
+
+    /* The callback can stop or start the timer. */
+    pthread_mutex_unlock(&timer->lock);
+    if(timer->args.dispatch_method == ESP_TIMER_ISR)
+    {
+      host_ISR_enter();
+      timer->args.callback(timer->args.arg);
+      host_ISR_exit();
+    }
+    else
+    {
+      timer->args.callback(timer->args.arg);
+    }
+    pthread_mutex_lock(&timer->lock);
+  }
+  pthread_mutex_unlock(&timer->lock);
+
+  pthread_cond_destroy(&timer->changed);
+  pthread_mutex_destroy(&timer->lock);
+  free(timer);
+
+  return NULL;
+}
+
+static esp_err_t arm_timer(esp_timer_handle_t timer, const uint64_t time_us,
+  const bool periodic)
+{
+
+  pthread_mutex_lock(&timer->lock);
+  if(timer->armed)
+  {
+    pthread_mutex_unlock(&timer->lock);
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->armed = true;
+  timer->periodic = periodic;
+  timer->period_us = time_us;
+  timer->next_us = esp_timer_get_time() + (int64_t)time_us;
+  pthread_cond_signal(&timer->changed);
+  pthread_mutex_unlock(&timer->lock);
+
+  return ESP_OK;
+}
+
+static nvs_blob *find_nvs_blob(const nvs_handle_t handle, const char *key)
+{
+
+  if(handle == 0u || handle > NVS_MAX_BLOBS || key == NULL)
+  {
+    return NULL;
+  }
+
+  for(size_t i = 0u; i < NVS_MAX_BLOBS; i++)
+  {
+    if(nvs_blobs[i].used && strcmp(nvs_blobs[i].key, key) == 0 &&
+       strcmp(nvs_blobs[i].name_space, nvs_handles[handle - 1u]) == 0)
+    {
+      return &nvs_blobs[i];
+    }
+  }
+
+  return NULL;
+}
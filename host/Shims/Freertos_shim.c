@@ -0,0 +1,829 @@
+/**
+ * @file      Freertos_shim.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the host shim of FreeRTOS. Every task is a
+ *            POSIX thread, the priorities and the cores are ignored and the host
+ *            preempts the threads. The waits use CLOCK_MONOTONIC, the same clock than
+ *            esp_timer_get_time.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <freertos/FreeRTOS.h>
+#include <Host_shims.h>
+#include <esp_timer.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Number of microseconds of a tick. */
+#define TICK_PERIOD_US (1000000u/configTICK_RATE_HZ)
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Task that runs in the calling thread, NULL out of the tasks. */
+static _Thread_local TaskHandle_t current_task;
+
+/* Nesting of the ISR context of the calling thread. */
+static _Thread_local uint32_t ISR_nesting;
+
+/* Token of the calling thread in the spinlocks, 0 until it takes the first one. */
+static _Thread_local uint32_t thread_token;
+
+/* Last token given to a thread. */
+static _Atomic uint32_t last_thread_token;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Entry point of the thread of a task.
+ *
+ * @param args Control block of the task.
+ *
+ * @return NULL
+ */
+static void *task_trampoline(void *args);
+
+/**
+ * @brief Initializes a mutex and up to two conditions that wait on CLOCK_MONOTONIC.
+ *
+ * @param lock Mutex to initialize.
+ *
+ * @param cond First condition to initialize.
+ *
+ * @param other_cond Second condition to initialize, NULL if there is only one.
+ *
+ * @return void
+ */
+static void init_sync(pthread_mutex_t *lock, pthread_cond_t *cond,
+  pthread_cond_t *other_cond);
+
+/**
+ * @brief Computes the absolute deadline of a wait.
+ *
+ * @param ticks Ticks to wait, portMAX_DELAY has no deadline.
+ *
+ * @param deadline Where the deadline is written.
+ *
+ * @return void
+ */
+static void deadline_of(const TickType_t ticks, struct timespec *deadline);
+
+/**
+ * @brief Waits for a condition until the deadline of deadline_of.
+ *
+ * @return False if the deadline expired.
+ */
+static bool wait_until(pthread_cond_t *cond, pthread_mutex_t *lock,
+  const TickType_t ticks, const struct timespec *deadline);
+
+/**
+ * @brief Starts the thread of a task.
+ *
+ * @return The task, NULL if the thread could not be created.
+ */
+static TaskHandle_t start_task(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, StaticTask_t *TCB, const bool allocated);
+
+/**
+ * @brief Writes an item in a queue, by the front or by the back.
+ *
+ * @return pdPASS if there was room before the ticks expired.
+ */
+static BaseType_t send_to_queue(QueueHandle_t queue, const void *item,
+  const TickType_t ticks, const bool to_front);
+
+/**
+ * @brief Reads the oldest item of a queue, removing it or not.
+ *
+ * @return pdPASS if there was an item before the ticks expired.
+ */
+static BaseType_t read_from_queue(QueueHandle_t queue, void *item,
+  const TickType_t ticks, const bool remove);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+void host_enter_critical(portMUX_TYPE *mux)
+{
+
+  if(thread_token == 0u)
+  {
+    thread_token = atomic_fetch_add(&last_thread_token, 1u) + 1u;
+  }
+
+  if(__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) == thread_token)
+  {
+    mux->count++;
+    return;
+  }
+
+  uint32_t expected = 0u;
+  while(!__atomic_compare_exchange_n(&mux->owner, &expected, thread_token, false,
+          __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  {
+    expected = 0u;
+    sched_yield();
+  }
+  mux->count = 1u;
+}
+
+void host_exit_critical(portMUX_TYPE *mux)
+{
+
+  if(--mux->count == 0u)
+  {
+    __atomic_store_n(&mux->owner, 0u, __ATOMIC_RELEASE);
+  }
+}
+
+BaseType_t xPortInIsrContext(void)
+{
+
+  return (ISR_nesting > 0u) ? pdTRUE : pdFALSE;
+}
+
+void host_ISR_enter(void)
+{
+
+  ISR_nesting++;
+}
+
+void host_ISR_exit(void)
+{
+
+  ISR_nesting--;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t func, const char *name, const uint32_t stack_size,
+  void *args, UBaseType_t priority, TaskHandle_t *handle)
+{
+
+  return xTaskCreatePinnedToCore(func, name, stack_size, args, priority, handle,
+    tskNO_AFFINITY);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, UBaseType_t priority, TaskHandle_t *handle,
+  const BaseType_t core)
+{
+
+  StaticTask_t *TCB = malloc(sizeof(StaticTask_t));
+  if(TCB == NULL)
+  {
+    return pdFAIL;
+  }
+
+  const TaskHandle_t task = start_task(func, name, stack_size, args, TCB, true);
+  if(task == NULL)
+  {
+    free(TCB);
+    return pdFAIL;
+  }
+  if(handle != NULL)
+  {
+    *handle = task;
+  }
+
+  return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, UBaseType_t priority, StackType_t *stack,
+  StaticTask_t *TCB)
+{
+
+  return xTaskCreateStaticPinnedToCore(func, name, stack_size, args, priority, stack,
+    TCB, tskNO_AFFINITY);
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, UBaseType_t priority, StackType_t *stack,
+  StaticTask_t *TCB, const BaseType_t core)
+{
+
+  /* The thread runs in a host stack, the static one is not used. */
+  return start_task(func, name, stack_size, args, TCB, false);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+
+  if(task == NULL || task == current_task)
+  {
+    /* The control block of a dynamic task is leaked, its thread still runs here. */
+    pthread_exit(NULL);
+  }
+
+  pthread_cancel(task->thread);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+
+  return current_task;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+
+  /* The host stacks are not measured, the whole stack is reported as free. */
+  if(task == NULL)
+  {
+    task = current_task;
+  }
+
+  return (task != NULL) ? task->stack_size : 0u;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+
+  return (TickType_t)((uint64_t)esp_timer_get_time()/TICK_PERIOD_US);
+}
+
+void vTaskDelay(const TickType_t ticks)
+{
+
+  if(ticks == 0u)
+  {
+    sched_yield();
+    return;
+  }
+
+  const uint64_t delay_us = (uint64_t)ticks*TICK_PERIOD_US;
+  const struct timespec delay =
+  {
+    .tv_sec = (time_t)(delay_us/1000000u),
+    .tv_nsec = (long)((delay_us%1000000u)*1000u),
+  };
+  while(nanosleep(&delay, NULL) != 0 && errno == EINTR)
+  {
+  }
+}
+
+void vTaskDelayUntil(TickType_t *previous_wake_tick, const TickType_t period)
+{
+
+  const TickType_t wake_tick = *previous_wake_tick + period;
+  const TickType_t now = xTaskGetTickCount();
+  *previous_wake_tick = wake_tick;
+
+  /* The wake up tick can already be in the past if the task was late. */
+  if((int32_t)(wake_tick - now) > 0)
+  {
+    vTaskDelay(wake_tick - now);
+  }
+}
+
+void vTaskSetTimeOutState(TimeOut_t *time_out)
+{
+
+  time_out->entry_tick = xTaskGetTickCount();
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *time_out, TickType_t *ticks_to_wait)
+{
+
+  if(*ticks_to_wait == portMAX_DELAY)
+  {
+    return pdFALSE;
+  }
+
+  const TickType_t now = xTaskGetTickCount();
+  const TickType_t elapsed = now - time_out->entry_tick;
+  if(elapsed >= *ticks_to_wait)
+  {
+    *ticks_to_wait = 0u;
+    return pdTRUE;
+  }
+
+  *ticks_to_wait -= elapsed;
+  time_out->entry_tick = now;
+
+  return pdFALSE;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, const uint32_t value,
+  const eNotifyAction action)
+{
+
+  BaseType_t ret = pdPASS;
+
+  pthread_mutex_lock(&task->lock);
+  switch(action)
+  {
+    case eSetBits:
+      task->notify_value |= value;
+      break;
+    case eIncrement:
+      task->notify_value++;
+      break;
+    case eSetValueWithOverwrite:
+      task->notify_value = value;
+      break;
+    case eSetValueWithoutOverwrite:
+      if(task->notify_pending)
+      {
+        ret = pdFAIL;
+      }
+      else
+      {
+        task->notify_value = value;
+      }
+      break;
+    default:
+      break;
+  }
+  task->notify_pending = true;
+  pthread_cond_signal(&task->notified);
+  pthread_mutex_unlock(&task->lock);
+
+  return ret;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, const uint32_t value,
+  const eNotifyAction action, BaseType_t *higher_priority_task_woken)
+{
+
+  if(higher_priority_task_woken != NULL)
+  {
+    *higher_priority_task_woken = pdFALSE;
+  }
+
+  return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(const uint32_t bits_to_clear_on_entry,
+  const uint32_t bits_to_clear_on_exit, uint32_t *value, const TickType_t ticks)
+{
+
+  TaskHandle_t task = current_task;
+  struct timespec deadline;
+  deadline_of(ticks, &deadline);
+
+  pthread_mutex_lock(&task->lock);
+
+  /* As in FreeRTOS, the entry bits are only cleared if nothing is pending. */
+  if(!task->notify_pending)
+  {
+    task->notify_value &= ~bits_to_clear_on_entry;
+  }
+  while(!task->notify_pending &&
+        wait_until(&task->notified, &task->lock, ticks, &deadline))
+  {
+  }
+
+  if(value != NULL)
+  {
+    *value = task->notify_value;
+  }
+  const BaseType_t ret = task->notify_pending ? pdTRUE : pdFALSE;
+  if(task->notify_pending)
+  {
+    task->notify_value &= ~bits_to_clear_on_exit;
+  }
+  task->notify_pending = false;
+
+  pthread_mutex_unlock(&task->lock);
+
+  return ret;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+
+  return xTaskNotify(task, 0u, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(const BaseType_t clear_on_exit, const TickType_t ticks)
+{
+
+  TaskHandle_t task = current_task;
+  struct timespec deadline;
+  deadline_of(ticks, &deadline);
+
+  pthread_mutex_lock(&task->lock);
+  while(task->notify_value == 0u &&
+        wait_until(&task->notified, &task->lock, ticks, &deadline))
+  {
+  }
+
+  const uint32_t value = task->notify_value;
+  if(value != 0u)
+  {
+    task->notify_value = (clear_on_exit == pdTRUE) ? 0u : value - 1u;
+  }
+  task->notify_pending = false;
+  pthread_mutex_unlock(&task->lock);
+
+  return value;
+}
+
+QueueHandle_t xQueueCreate(const UBaseType_t length, const UBaseType_t item_size)
+{
+
+  StaticQueue_t *queue = malloc(sizeof(StaticQueue_t));
+  uint8_t *storage = malloc((size_t)length*item_size);
+  if(queue == NULL || storage == NULL)
+  {
+    free(queue);
+    free(storage);
+    return NULL;
+  }
+
+  xQueueCreateStatic(length, item_size, storage, queue);
+  queue->allocated = true;
+
+  return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(const UBaseType_t length, const UBaseType_t item_size,
+  uint8_t *storage, StaticQueue_t *queue_buffer)
+{
+
+  memset(queue_buffer, 0, sizeof(*queue_buffer));
+  init_sync(&queue_buffer->lock, &queue_buffer->not_empty, &queue_buffer->not_full);
+  queue_buffer->storage = storage;
+  queue_buffer->item_size = item_size;
+  queue_buffer->length = length;
+
+  return queue_buffer;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+
+  pthread_cond_destroy(&queue->not_empty);
+  pthread_cond_destroy(&queue->not_full);
+  pthread_mutex_destroy(&queue->lock);
+  if(queue->allocated)
+  {
+    free(queue->storage);
+    free(queue);
+  }
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, const TickType_t ticks)
+{
+
+  return send_to_queue(queue, item, ticks, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item,
+  const TickType_t ticks)
+{
+
+  return send_to_queue(queue, item, ticks, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item,
+  const TickType_t ticks)
+{
+
+  return send_to_queue(queue, item, ticks, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+  BaseType_t *higher_priority_task_woken)
+{
+
+  if(higher_priority_task_woken != NULL)
+  {
+    *higher_priority_task_woken = pdFALSE;
+  }
+
+  return send_to_queue(queue, item, 0u, false);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, const TickType_t ticks)
+{
+
+  return read_from_queue(queue, item, ticks, true);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *item,
+  BaseType_t *higher_priority_task_woken)
+{
+
+  if(higher_priority_task_woken != NULL)
+  {
+    *higher_priority_task_woken = pdFALSE;
+  }
+
+  return read_from_queue(queue, item, 0u, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, const TickType_t ticks)
+{
+
+  return read_from_queue(queue, item, ticks, false);
+}
+
+BaseType_t xQueuePeekFromISR(QueueHandle_t queue, void *item)
+{
+
+  return read_from_queue(queue, item, 0u, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+
+  pthread_mutex_lock(&queue->lock);
+  const UBaseType_t count = queue->count;
+  pthread_mutex_unlock(&queue->lock);
+
+  return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+
+  pthread_mutex_lock(&queue->lock);
+  const UBaseType_t spaces = queue->length - queue->count;
+  pthread_mutex_unlock(&queue->lock);
+
+  return spaces;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+
+  pthread_mutex_lock(&queue->lock);
+  queue->head = 0u;
+  queue->count = 0u;
+  pthread_cond_broadcast(&queue->not_full);
+  pthread_mutex_unlock(&queue->lock);
+
+  return pdPASS;
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+
+  StaticEventGroup_t *event_group = malloc(sizeof(StaticEventGroup_t));
+  if(event_group == NULL)
+  {
+    return NULL;
+  }
+
+  xEventGroupCreateStatic(event_group);
+  event_group->allocated = true;
+
+  return event_group;
+}
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *event_group_buffer)
+{
+
+  memset(event_group_buffer, 0, sizeof(*event_group_buffer));
+  init_sync(&event_group_buffer->lock, &event_group_buffer->changed, NULL);
+
+  return event_group_buffer;
+}
+
+void vEventGroupDelete(EventGroupHandle_t event_group)
+{
+
+  pthread_cond_destroy(&event_group->changed);
+  pthread_mutex_destroy(&event_group->lock);
+  if(event_group->allocated)
+  {
+    free(event_group);
+  }
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t event_group, const EventBits_t bits)
+{
+
+  pthread_mutex_lock(&event_group->lock);
+  event_group->bits |= bits;
+  const EventBits_t value = event_group->bits;
+  pthread_cond_broadcast(&event_group->changed);
+  pthread_mutex_unlock(&event_group->lock);
+
+  return value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t event_group,
+  const EventBits_t bits)
+{
+
+  pthread_mutex_lock(&event_group->lock);
+  const EventBits_t value = event_group->bits;
+  event_group->bits &= ~bits;
+  pthread_mutex_unlock(&event_group->lock);
+
+  return value;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t event_group)
+{
+
+  pthread_mutex_lock(&event_group->lock);
+  const EventBits_t value = event_group->bits;
+  pthread_mutex_unlock(&event_group->lock);
+
+  return value;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t event_group, const EventBits_t bits,
+  const BaseType_t clear_on_exit, const BaseType_t wait_for_all,
+  const TickType_t ticks)
+{
+
+  struct timespec deadline;
+  deadline_of(ticks, &deadline);
+
+  pthread_mutex_lock(&event_group->lock);
+
+  bool met;
+  while(true)
+  {
+    const EventBits_t set_bits = event_group->bits & bits;
+    met = (wait_for_all == pdTRUE) ? (set_bits == bits) : (set_bits != 0u);
+    if(met || !wait_until(&event_group->changed, &event_group->lock, ticks, &deadline))
+    {
+      break;
+    }
+  }
+
+  const EventBits_t value = event_group->bits;
+  if(met && clear_on_exit == pdTRUE)
+  {
+    event_group->bits &= ~bits;
+  }
+  pthread_mutex_unlock(&event_group->lock);
+
+  return value;
+}
+
+static void *task_trampoline(void *args)
+{
+
+  current_task = (TaskHandle_t)args;
+  current_task->func(current_task->args);
+
+  /* A task function must not return, but the thread ends as with vTaskDelete. */
+  return NULL;
+}
+
+static void init_sync(pthread_mutex_t *lock, pthread_cond_t *cond,
+  pthread_cond_t *other_cond)
+{
+
+  pthread_mutex_init(lock, NULL);
+
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  if(other_cond != NULL)
+  {
+    pthread_cond_init(other_cond, &attr);
+  }
+  pthread_condattr_destroy(&attr);
+}
+
+static void deadline_of(const TickType_t ticks, struct timespec *deadline)
+{
+
+  if(ticks == 0u || ticks == portMAX_DELAY)
+  {
+    return;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, deadline);
+  const uint64_t wait_ns = (uint64_t)ticks*TICK_PERIOD_US*1000u;
+  const uint64_t nsec = (uint64_t)deadline->tv_nsec + (wait_ns%1000000000u);
+  deadline->tv_sec += (time_t)(wait_ns/1000000000u + nsec/1000000000u);
+  deadline->tv_nsec = (long)(nsec%1000000000u);
+}
+
+static bool wait_until(pthread_cond_t *cond, pthread_mutex_t *lock,
+  const TickType_t ticks, const struct timespec *deadline)
+{
+
+  if(ticks == 0u)
+  {
+    return false;
+  }
+  if(ticks == portMAX_DELAY)
+  {
+    pthread_cond_wait(cond, lock);
+    return true;
+  }
+
+  return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+static TaskHandle_t start_task(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, StaticTask_t *TCB, const bool allocated)
+{
+
+  memset(TCB, 0, sizeof(*TCB));
+  init_sync(&TCB->lock, &TCB->notified, NULL);
+  TCB->func = func;
+  TCB->args = args;
+  TCB->name = name;
+  TCB->stack_size = stack_size;
+  TCB->allocated = allocated;
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  const int ret = pthread_create(&TCB->thread, &attr, task_trampoline, TCB);
+  pthread_attr_destroy(&attr);
+
+  return (ret == 0) ? TCB : NULL;
+}
+
+static BaseType_t send_to_queue(QueueHandle_t queue, const void *item,
+  const TickType_t ticks, const bool to_front)
+{
+
+  struct timespec deadline;
+  deadline_of(ticks, &deadline);
+
+  pthread_mutex_lock(&queue->lock);
+  while(queue->count >= queue->length &&
+        wait_until(&queue->not_full, &queue->lock, ticks, &deadline))
+  {
+  }
+
+  if(queue->count >= queue->length)
+  {
+    pthread_mutex_unlock(&queue->lock);
+    return errQUEUE_FULL;
+  }
+
+  UBaseType_t index;
+  if(to_front)
+  {
+    queue->head = (queue->head + queue->length - 1u) % queue->length;
+    index = queue->head;
+  }
+  else
+  {
+    index = (queue->head + queue->count) % queue->length;
+  }
+  memcpy(&queue->storage[(size_t)index*queue->item_size], item, queue->item_size);
+  queue->count++;
+
+  pthread_cond_signal(&queue->not_empty);
+  pthread_mutex_unlock(&queue->lock);
+
+  return pdPASS;
+}
+
+static BaseType_t read_from_queue(QueueHandle_t queue, void *item,
+  const TickType_t ticks, const bool remove)
+{
+
+  struct timespec deadline;
+  deadline_of(ticks, &deadline);
+
+  pthread_mutex_lock(&queue->lock);
+  while(queue->count == 0u &&
+        wait_until(&queue->not_empty, &queue->lock, ticks, &deadline))
+  {
+  }
+
+  if(queue->count == 0u)
+  {
+    pthread_mutex_unlock(&queue->lock);
+    return errQUEUE_EMPTY;
+  }
+
+  memcpy(item, &queue->storage[(size_t)queue->head*queue->item_size],
+    queue->item_size);
+  if(remove)
+  {
+    queue->head = (queue->head + 1u) % queue->length;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+  }
+  else
+  {
+    /* Another reader can be waiting for the same item. */
+    pthread_cond_signal(&queue->not_empty);
+  }
+  pthread_mutex_unlock(&queue->lock);
+
+  return pdPASS;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file      Heap_shim.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the counter of heap allocations. The programs
+ *            that link it with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc count
+ *            every allocation, see host/CMakeLists.txt. It also defines the heap
+ *            sizes of esp_system.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Host_shims.h>
+#include <esp_system.h>
+#include <stdatomic.h>
+#include <stddef.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Free heap in bytes that the host reports, about the one of an ESP32 with WiFi. */
+#define HOST_FREE_HEAP_SIZE 180000u
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Number of allocations since the start. */
+static atomic_uint_fast64_t heap_allocations;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/* Allocators of the C library, the linker renames the originals. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t num, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+void *__wrap_malloc(size_t size)
+{
+
+  atomic_fetch_add_explicit(&heap_allocations, 1u, memory_order_relaxed);
+
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+
+  atomic_fetch_add_explicit(&heap_allocations, 1u, memory_order_relaxed);
+
+  return __real_calloc(num, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+
+  atomic_fetch_add_explicit(&heap_allocations, 1u, memory_order_relaxed);
+
+  return __real_realloc(ptr, size);
+}
+
+uint64_t host_heap_allocations(void)
+{
+
+  return atomic_load_explicit(&heap_allocations, memory_order_relaxed);
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+
+  return HOST_FREE_HEAP_SIZE;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+
+  return HOST_FREE_HEAP_SIZE;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file      Host_shims.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions that only exist in the host
+ *            build. They drive the shims from the microbenchmarks: the ISR context,
+ *            the GPIO levels, the WiFi link and the heap allocations counter.
+ */
+
+#ifndef HOST_SHIMS_H_
+#define HOST_SHIMS_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <driver/gpio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Marks the calling thread as running an ISR until host_ISR_exit, so
+ *        xPortInIsrContext returns pdTRUE. The calls can be nested.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void host_ISR_enter(void);
+
+/**
+ * @brief Ends the ISR context of host_ISR_enter.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void host_ISR_exit(void);
+
+/**
+ * @brief Sets the level of a GPIO. If its interruption is enabled and the change
+ *        matches its type, the handler is called in ISR context from the caller.
+ *
+ * @param GPIO GPIO to change.
+ *
+ * @param level New level, 0 or 1.
+ *
+ * @return void
+ */
+void host_set_GPIO_level(const gpio_num_t GPIO, const int level);
+
+/**
+ * @brief Brings the WiFi link up or down. While it is down the association attempts
+ *        wait, when it comes up the pending attempt associates and gets the lease.
+ *        The link starts up.
+ *
+ * @param up True to bring the link up.
+ *
+ * @return void
+ */
+void host_set_WiFi_link(const bool up);
+
+/**
+ * @brief Sets the IPv4 address that the leases give as default gateway, 127.0.0.1
+ *        by default.
+ *
+ * @param gateway_IP Address in network byte order.
+ *
+ * @return void
+ */
+void host_set_lease_gateway(const uint32_t gateway_IP);
+
+/**
+ * @brief Returns the number of heap allocations since the start. It only counts when
+ *        the program is linked with the malloc wrappers, see host/CMakeLists.txt.
+ *
+ * @param void
+ *
+ * @return Number of calls to malloc, calloc and realloc.
+ */
+uint64_t host_heap_allocations(void);
+
+#endif /* HOST_SHIMS_H_ */
@@ -0,0 +1,58 @@
+/**
+ * @file      Network_config.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host stand-in of the network configuration of the WiFi submodule. The
+ *            gateway is a fake one of the microbenchmarks in the loopback interface.
+ */
+
+#ifndef HOST_NETWORK_CONFIG_H_
+#define HOST_NETWORK_CONFIG_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_lights.h>
+#include <esp_wifi.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Port where the fake gateway listens. */
+#ifndef TCP_IP_PORT
+  #define TCP_IP_PORT 47800
+#endif
+
+#define WIFI_SSID      "host"
+#define WIFI_PASS      "host"
+#define WIFI_AUTH_MODE WIFI_AUTH_WPA2_PSK
+
+/* Size in bytes of a command with the raw wire format. */
+#define TCP_COMMAND_SIZE sizeof(TCP_COMMAND_TYPE)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the actions over a LED. */
+typedef enum
+{
+  TOOGLE_LED,
+  SET_PWM,
+} LED_action;
+
+/* Structure of a command for the gateway. */
+typedef struct
+{
+  /* LED of the command. */
+  LED_ID ID;
+  /* Action over the LED. */
+  LED_action action;
+  /* Duty cycle of SET_PWM in terms of percentage. */
+  uint8_t pwm;
+} TCP_COMMAND_TYPE;
+
+#endif /* HOST_NETWORK_CONFIG_H_ */
@@ -0,0 +1,148 @@
+/**
+ * @file      Submodules_shim.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the host stand-ins of the Debug and Button
+ *            submodules. The buttons are GPIOs of the GPIO shim, host_set_GPIO_level
+ *            presses them.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Button.h>
+#include <Debug.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* GPIOs, pull modes and interruption types of the buttons. */
+static const gpio_num_t button_GPIOs[NUM_OF_BUTTONS] =
+{
+  #define BUTTON_CONFIG(ID, GPIO, pull_mode, intr_type, debounce_ms) [ID] = GPIO,
+    BUTTONS_CONFIGURATIONS
+  #undef BUTTON_CONFIG
+};
+
+static const gpio_pull_mode_t button_pull_modes[NUM_OF_BUTTONS] =
+{
+  #define BUTTON_CONFIG(ID, GPIO, pull_mode, intr_type, debounce_ms) [ID] = pull_mode,
+    BUTTONS_CONFIGURATIONS
+  #undef BUTTON_CONFIG
+};
+
+static const gpio_int_type_t button_intr_types[NUM_OF_BUTTONS] =
+{
+  #define BUTTON_CONFIG(ID, GPIO, pull_mode, intr_type, debounce_ms) [ID] = intr_type,
+    BUTTONS_CONFIGURATIONS
+  #undef BUTTON_CONFIG
+};
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Interruption of a button, it calls button_CB without debouncing.
+ *
+ * @param args ID of the button.
+ *
+ * @return void
+ */
+static void button_ISR(void *args);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+esp_err_t ESP_error_check(const esp_err_t err)
+{
+
+  #if DEBUG_MODE_ENABLE == 1
+    if(err != ESP_OK)
+    {
+      ESP_LOGE("ESP", "Error 0x%x", (unsigned int)err);
+    }
+  #endif
+
+  return err;
+}
+
+Button_return init_BSP_button_module(void)
+{
+
+  const esp_err_t ret = gpio_install_isr_service(0);
+
+  return (ret == ESP_OK || ret == ESP_ERR_INVALID_STATE) ? BSP_BUTTON_OK :
+    BSP_BUTTON_INIT_ERR;
+}
+
+Button_return init_button(const Button_ID ID)
+{
+
+  if(ID >= NUM_OF_BUTTONS)
+  {
+    return BSP_BUTTON_INIT_ERR;
+  }
+
+  const gpio_config_t config =
+  {
+    .pin_bit_mask = (uint64_t)1u << button_GPIOs[ID],
+    .mode = GPIO_MODE_INPUT,
+    .pull_up_en = (button_pull_modes[ID] == GPIO_PULLUP_ONLY) ?
+      GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+    .pull_down_en = (button_pull_modes[ID] == GPIO_PULLDOWN_ONLY) ?
+      GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
+    .intr_type = button_intr_types[ID],
+  };
+  if(gpio_config(&config) != ESP_OK ||
+     gpio_isr_handler_add(button_GPIOs[ID], button_ISR, (void *)(uintptr_t)ID) !=
+       ESP_OK || gpio_intr_enable(button_GPIOs[ID]) != ESP_OK)
+  {
+    return BSP_BUTTON_INIT_ERR;
+  }
+
+  return BSP_BUTTON_OK;
+}
+
+Button_return de_init_button(const Button_ID ID)
+{
+
+  if(ID >= NUM_OF_BUTTONS)
+  {
+    return BSP_BUTTON_DE_INIT_ERR;
+  }
+
+  gpio_intr_disable(button_GPIOs[ID]);
+
+  return (gpio_isr_handler_remove(button_GPIOs[ID]) == ESP_OK) ? BSP_BUTTON_OK :
+    BSP_BUTTON_DE_INIT_ERR;
+}
+
+Button_return BPS_button_LOG(const Button_return ret)
+{
+
+  #if DEBUG_MODE_ENABLE == 1
+    static const char *BUTTON_RETURN_NAMES[] =
+    {
+      #define BUTTON_RETURN(enumerate) #enumerate,
+        BUTTON_RETURNS
+      #undef BUTTON_RETURN
+    };
+    if(ret != BSP_BUTTON_OK && ret < NUM_OF_BUTTON_RETURNS)
+    {
+      ESP_LOGE("Button", "%s", BUTTON_RETURN_NAMES[ret]);
+    }
+  #endif
+
+  return ret;
+}
+
+static void button_ISR(void *args)
+{
+
+  button_CB((Button_ID)(uintptr_t)args);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file      WiFi.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host stand-in of the WiFi submodule. It starts the host station and
+ *            routes its events to the given handlers.
+ */
+
+#ifndef HOST_WIFI_H_
+#define HOST_WIFI_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_wifi.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that the WiFi module can return. */
+#define WIFI_RETURNS                   \
+  /* Info codes */                     \
+  WIFI_RETURN(CORE_WIFI_OK)            \
+  /* Error codes */                    \
+  WIFI_RETURN(CORE_WIFI_INIT_ERR)      \
+  WIFI_RETURN(CORE_WIFI_DE_INIT_ERR)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define WIFI_RETURN(enumerate) enumerate,
+    WIFI_RETURNS
+  #undef WIFI_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_WIFI_RETURNS,
+} WiFi_return;
+
+/* Structure that contains the handlers of the WiFi and IP events. */
+typedef struct
+{
+  int32_t WiFi_events_to_handle;
+  esp_event_handler_t WiFi_event_handler;
+  int32_t IP_events_to_handle;
+  esp_event_handler_t IP_event_handler;
+} event_handlers;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Starts the station, WIFI_EVENT_STA_START is posted from the event thread.
+ *
+ * @param mode Only WIFI_MODE_STA is supported.
+ *
+ * @param config Configuration of the station.
+ *
+ * @param handlers Handlers of the events.
+ *
+ * @return CORE_WIFI_OK if the operation went well, otherwise CORE_WIFI_INIT_ERR.
+ */
+WiFi_return WiFi_init(const wifi_mode_t mode, const wifi_config_t config,
+  const event_handlers handlers);
+
+/**
+ * @brief Stops the station, the handlers do not receive more events.
+ *
+ * @param void
+ *
+ * @return CORE_WIFI_OK
+ */
+WiFi_return de_init_WiFi(void);
+
+/**
+ * @brief Prints the return of a WiFi module function in debug mode.
+ *
+ * @param ret Received return from a WiFi module function.
+ *
+ * @return The given return.
+ */
+WiFi_return core_WiFi_LOG(const WiFi_return ret);
+
+#endif /* HOST_WIFI_H_ */
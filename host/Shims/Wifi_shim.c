@@ -0,0 +1,452 @@
+/**
+ * @file      Wifi_shim.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the host shims of the WiFi driver, esp_netif and
+ *            the WiFi module. The station associates with a fake access point and gets
+ *            a lease of the loopback interface, so the gateway is a local server. The
+ *            events are dispatched from their own thread, as the event loop of ESP-IDF.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Host_shims.h>
+#include <WiFi.h>
+#include <Debug.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <string.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Maximum number of events waiting to be dispatched. */
+#define EVENT_QUEUE_LEN 16u
+
+/* Channel of the fake access point. */
+#define AP_CHANNEL 6u
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that contains a posted event. */
+typedef struct
+{
+  esp_event_base_t base;
+  int32_t ID;
+  union
+  {
+    wifi_event_sta_connected_t connected;
+    wifi_event_sta_disconnected_t disconnected;
+    ip_event_got_ip_t got_IP;
+  } data;
+} host_event;
+
+/* The only network interface, the station. */
+struct esp_netif_obj
+{
+  esp_netif_ip_info_t ip_info;
+  esp_netif_dns_info_t dns_info;
+  bool DHCP_started;
+};
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+esp_event_base_t const WIFI_EVENT = "WIFI_EVENT";
+esp_event_base_t const IP_EVENT = "IP_EVENT";
+
+/* Lock of the state of the driver, the events are dispatched without it. */
+static pthread_mutex_t WiFi_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Handlers of the WiFi module. */
+static event_handlers handlers;
+
+/* Events waiting to be dispatched and thread that dispatches them. */
+static QueueHandle_t event_queue;
+static pthread_t event_thread;
+
+/* State of the station and of the fake link. */
+static bool started;
+static bool associated;
+static bool link_up = true;
+static bool connect_pending;
+static wifi_config_t station_config;
+
+/* Gateway of the leases, network byte order. */
+static uint32_t lease_gateway_IP;
+
+/* Interface of the station and IP of its last lease. */
+static struct esp_netif_obj station_netif = { .DHCP_started = true };
+static uint32_t last_lease_IP;
+
+/* BSSID of the fake access point. */
+static const uint8_t AP_BSSID[6] = { 0x02u, 0x00u, 0x00u, 0x00u, 0x00u, 0x01u };
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Thread that dispatches the posted events to the handlers.
+ *
+ * @param args Unused.
+ *
+ * @return NULL
+ */
+static void *event_func(void *args);
+
+/**
+ * @brief Posts an event, it waits if the queue is full.
+ *
+ * @return void
+ */
+static void post_event(const host_event *event);
+
+/**
+ * @brief Associates the station and gives it a lease. The lock must be taken.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void associate(void);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+WiFi_return WiFi_init(const wifi_mode_t mode, const wifi_config_t config,
+  const event_handlers event_handlers)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+
+  if(started || mode != WIFI_MODE_STA)
+  {
+    pthread_mutex_unlock(&WiFi_lock);
+    return CORE_WIFI_INIT_ERR;
+  }
+
+  if(event_queue == NULL)
+  {
+    event_queue = xQueueCreate(EVENT_QUEUE_LEN, sizeof(host_event));
+    if(event_queue == NULL || pthread_create(&event_thread, NULL, event_func, NULL) != 0)
+    {
+      pthread_mutex_unlock(&WiFi_lock);
+      return CORE_WIFI_INIT_ERR;
+    }
+    pthread_detach(event_thread);
+  }
+
+  if(lease_gateway_IP == 0u)
+  {
+    lease_gateway_IP = htonl(INADDR_LOOPBACK);
+  }
+
+  handlers = event_handlers;
+  station_config = config;
+  started = true;
+
+  const host_event event = { .base = WIFI_EVENT, .ID = WIFI_EVENT_STA_START };
+  post_event(&event);
+
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return CORE_WIFI_OK;
+}
+
+WiFi_return de_init_WiFi(void)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  const bool was_started = started;
+  started = false;
+  associated = false;
+  connect_pending = false;
+  memset(&handlers, 0, sizeof(handlers));
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return was_started ? CORE_WIFI_OK : CORE_WIFI_DE_INIT_ERR;
+}
+
+WiFi_return core_WiFi_LOG(const WiFi_return ret)
+{
+
+  #if DEBUG_MODE_ENABLE == 1
+    static const char *WIFI_RETURN_NAMES[] =
+    {
+      #define WIFI_RETURN(enumerate) #enumerate,
+        WIFI_RETURNS
+      #undef WIFI_RETURN
+    };
+    if(ret != CORE_WIFI_OK && ret < NUM_OF_WIFI_RETURNS)
+    {
+      ESP_LOGE("WiFi", "%s", WIFI_RETURN_NAMES[ret]);
+    }
+  #endif
+
+  return ret;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+
+  esp_err_t ret = ESP_OK;
+  if(!started)
+  {
+    ret = ESP_ERR_INVALID_STATE;
+  }
+  else if(link_up)
+  {
+    associate();
+  }
+  else
+  {
+    /* The attempt waits until the link comes up. */
+    connect_pending = true;
+  }
+
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ret;
+}
+
+esp_err_t esp_wifi_disconnect(void)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  connect_pending = false;
+  if(associated)
+  {
+    associated = false;
+    const host_event event = { .base = WIFI_EVENT, .ID = WIFI_EVENT_STA_DISCONNECTED };
+    post_event(&event);
+  }
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(const wifi_interface_t interface, wifi_config_t *conf)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  *conf = station_config;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(const wifi_interface_t interface, wifi_config_t *conf)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  station_config = *conf;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_ps(const wifi_ps_type_t type)
+{
+
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_channel(const uint8_t primary, const wifi_second_chan_t second)
+{
+
+  return ESP_OK;
+}
+
+esp_netif_t *esp_netif_get_handle_from_ifkey(const char *if_key)
+{
+
+  return (strcmp(if_key, "WIFI_STA_DEF") == 0) ? &station_netif : NULL;
+}
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  *ip_info = esp_netif->ip_info;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t esp_netif_set_ip_info(esp_netif_t *esp_netif,
+  const esp_netif_ip_info_t *ip_info)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  const bool DHCP_started = esp_netif->DHCP_started;
+  if(!DHCP_started)
+  {
+    esp_netif->ip_info = *ip_info;
+  }
+  pthread_mutex_unlock(&WiFi_lock);
+
+  /* As in esp_netif, a static IP needs the DHCP client stopped. */
+  return DHCP_started ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_err_t esp_netif_get_dns_info(esp_netif_t *esp_netif,
+  const esp_netif_dns_type_t type, esp_netif_dns_info_t *dns)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  *dns = esp_netif->dns_info;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t esp_netif_set_dns_info(esp_netif_t *esp_netif,
+  const esp_netif_dns_type_t type, esp_netif_dns_info_t *dns)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  esp_netif->dns_info = *dns;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return ESP_OK;
+}
+
+esp_err_t esp_netif_dhcpc_start(esp_netif_t *esp_netif)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  const bool was_started = esp_netif->DHCP_started;
+  esp_netif->DHCP_started = true;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return was_started ? ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED : ESP_OK;
+}
+
+esp_err_t esp_netif_dhcpc_stop(esp_netif_t *esp_netif)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  const bool was_started = esp_netif->DHCP_started;
+  esp_netif->DHCP_started = false;
+  pthread_mutex_unlock(&WiFi_lock);
+
+  return was_started ? ESP_OK : ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED;
+}
+
+void host_set_WiFi_link(const bool up)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  if(up && !link_up)
+  {
+    link_up = true;
+    if(connect_pending)
+    {
+      connect_pending = false;
+      associate();
+    }
+  }
+  else if(!up && link_up)
+  {
+    link_up = false;
+    if(associated)
+    {
+      associated = false;
+      const host_event event =
+        { .base = WIFI_EVENT, .ID = WIFI_EVENT_STA_DISCONNECTED };
+      post_event(&event);
+    }
+  }
+  pthread_mutex_unlock(&WiFi_lock);
+}
+
+void host_set_lease_gateway(const uint32_t gateway_IP)
+{
+
+  pthread_mutex_lock(&WiFi_lock);
+  lease_gateway_IP = gateway_IP;
+  pthread_mutex_unlock(&WiFi_lock);
+}
+
+static void *event_func(void *args)
+{
+
+  host_event event;
+  while(true)
+  {
+    xQueueReceive(event_queue, &event, portMAX_DELAY);
+
+    pthread_mutex_lock(&WiFi_lock);
+    int32_t events_to_handle = handlers.WiFi_events_to_handle;
+    esp_event_handler_t handler = handlers.WiFi_event_handler;
+    if(event.base == IP_EVENT)
+    {
+      events_to_handle = handlers.IP_events_to_handle;
+      handler = handlers.IP_event_handler;
+    }
+    pthread_mutex_unlock(&WiFi_lock);
+
+    if(handler != NULL && (events_to_handle == ESP_EVENT_ANY_ID ||
+       events_to_handle == event.ID))
+    {
+      handler(NULL, event.base, event.ID, &event.data);
+    }
+  }
+
+  return NULL;
+}
+
+static void post_event(const host_event *event)
+{
+
+  xQueueSend(event_queue, event, portMAX_DELAY);
+}
+
+static void associate(void)
+{
+
+  if(associated)
+  {
+    return;
+  }
+  associated = true;
+
+  host_event event = { .base = WIFI_EVENT, .ID = WIFI_EVENT_STA_CONNECTED };
+  const size_t ssid_len = strnlen((const char *)station_config.sta.ssid,
+    sizeof(station_config.sta.ssid));
+  memcpy(event.data.connected.ssid, station_config.sta.ssid, ssid_len);
+  event.data.connected.ssid_len = (uint8_t)ssid_len;
+  memcpy(event.data.connected.bssid, AP_BSSID, sizeof(AP_BSSID));
+  event.data.connected.channel = AP_CHANNEL;
+  event.data.connected.authmode = station_config.sta.threshold.authmode;
+  post_event(&event);
+
+  /* The DHCP client gets a lease of the loopback network, a static IP stays. */
+  if(station_netif.DHCP_started)
+  {
+    station_netif.ip_info.ip.addr = htonl(INADDR_LOOPBACK);
+    station_netif.ip_info.netmask.addr = htonl(0xFF000000u);
+    station_netif.ip_info.gw.addr = lease_gateway_IP;
+    station_netif.dns_info.ip.type = ESP_IPADDR_TYPE_V4;
+    station_netif.dns_info.ip.u_addr.ip4.addr = htonl(INADDR_LOOPBACK);
+  }
+
+  event = (host_event){ .base = IP_EVENT, .ID = IP_EVENT_STA_GOT_IP };
+  event.data.got_IP.esp_netif = &station_netif;
+  event.data.got_IP.ip_info = station_netif.ip_info;
+  event.data.got_IP.ip_changed = (station_netif.ip_info.ip.addr != last_lease_IP);
+  last_lease_IP = station_netif.ip_info.ip.addr;
+  post_event(&event);
+}
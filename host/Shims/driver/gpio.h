@@ -0,0 +1,132 @@
+/**
+ * @file      gpio.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the GPIO driver. The levels are set with host_set_GPIO_level
+ *            -> Host_shims.h, that also runs the interruption handlers.
+ */
+
+#ifndef HOST_DRIVER_GPIO_H_
+#define HOST_DRIVER_GPIO_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_err.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+typedef enum
+{
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_1 = 1,
+  GPIO_NUM_2 = 2,
+  GPIO_NUM_3 = 3,
+  GPIO_NUM_4 = 4,
+  GPIO_NUM_5 = 5,
+  GPIO_NUM_6 = 6,
+  GPIO_NUM_7 = 7,
+  GPIO_NUM_8 = 8,
+  GPIO_NUM_9 = 9,
+  GPIO_NUM_10 = 10,
+  GPIO_NUM_11 = 11,
+  GPIO_NUM_12 = 12,
+  GPIO_NUM_13 = 13,
+  GPIO_NUM_14 = 14,
+  GPIO_NUM_15 = 15,
+  GPIO_NUM_16 = 16,
+  GPIO_NUM_17 = 17,
+  GPIO_NUM_18 = 18,
+  GPIO_NUM_19 = 19,
+  GPIO_NUM_20 = 20,
+  GPIO_NUM_21 = 21,
+  GPIO_NUM_22 = 22,
+  GPIO_NUM_23 = 23,
+  GPIO_NUM_24 = 24,
+  GPIO_NUM_25 = 25,
+  GPIO_NUM_26 = 26,
+  GPIO_NUM_27 = 27,
+  GPIO_NUM_28 = 28,
+  GPIO_NUM_29 = 29,
+  GPIO_NUM_30 = 30,
+  GPIO_NUM_31 = 31,
+  GPIO_NUM_32 = 32,
+  GPIO_NUM_33 = 33,
+  GPIO_NUM_34 = 34,
+  GPIO_NUM_35 = 35,
+  GPIO_NUM_36 = 36,
+  GPIO_NUM_37 = 37,
+  GPIO_NUM_38 = 38,
+  GPIO_NUM_39 = 39,
+  GPIO_NUM_MAX,
+} gpio_num_t;
+
+typedef enum
+{
+  GPIO_MODE_DISABLE,
+  GPIO_MODE_INPUT,
+  GPIO_MODE_OUTPUT,
+} gpio_mode_t;
+
+typedef enum
+{
+  GPIO_PULLUP_ONLY,
+  GPIO_PULLDOWN_ONLY,
+  GPIO_PULLUP_PULLDOWN,
+  GPIO_FLOATING,
+} gpio_pull_mode_t;
+
+typedef enum
+{
+  GPIO_PULLUP_DISABLE,
+  GPIO_PULLUP_ENABLE,
+} gpio_pullup_t;
+
+typedef enum
+{
+  GPIO_PULLDOWN_DISABLE,
+  GPIO_PULLDOWN_ENABLE,
+} gpio_pulldown_t;
+
+typedef enum
+{
+  GPIO_INTR_DISABLE,
+  GPIO_INTR_POSEDGE,
+  GPIO_INTR_NEGEDGE,
+  GPIO_INTR_ANYEDGE,
+  GPIO_INTR_LOW_LEVEL,
+  GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+typedef struct
+{
+  uint64_t pin_bit_mask;
+  gpio_mode_t mode;
+  gpio_pullup_t pull_up_en;
+  gpio_pulldown_t pull_down_en;
+  gpio_int_type_t intr_type;
+} gpio_config_t;
+
+typedef void (*gpio_isr_t)(void *arg);
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+esp_err_t gpio_config(const gpio_config_t *config);
+int gpio_get_level(const gpio_num_t GPIO);
+esp_err_t gpio_set_intr_type(const gpio_num_t GPIO, const gpio_int_type_t intr_type);
+esp_err_t gpio_intr_enable(const gpio_num_t GPIO);
+esp_err_t gpio_intr_disable(const gpio_num_t GPIO);
+esp_err_t gpio_install_isr_service(const int intr_alloc_flags);
+esp_err_t gpio_isr_handler_add(const gpio_num_t GPIO, gpio_isr_t isr_handler,
+  void *args);
+esp_err_t gpio_isr_handler_remove(const gpio_num_t GPIO);
+esp_err_t gpio_wakeup_enable(const gpio_num_t GPIO, const gpio_int_type_t intr_type);
+esp_err_t gpio_wakeup_disable(const gpio_num_t GPIO);
+
+#endif /* HOST_DRIVER_GPIO_H_ */
@@ -0,0 +1,16 @@
+/**
+ * @file      esp_attr.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the ESP-IDF attributes, the host has a single memory.
+ */
+
+#ifndef HOST_ESP_ATTR_H_
+#define HOST_ESP_ATTR_H_
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+
+#endif /* HOST_ESP_ATTR_H_ */
@@ -0,0 +1,25 @@
+/**
+ * @file      esp_err.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the ESP-IDF error codes that the core checks.
+ */
+
+#ifndef HOST_ESP_ERR_H_
+#define HOST_ESP_ERR_H_
+
+typedef int esp_err_t;
+
+#define ESP_OK                                 0
+#define ESP_FAIL                               -1
+#define ESP_ERR_NO_MEM                         0x101
+#define ESP_ERR_INVALID_ARG                    0x102
+#define ESP_ERR_INVALID_STATE                  0x103
+#define ESP_ERR_INVALID_SIZE                   0x104
+#define ESP_ERR_NOT_FOUND                      0x105
+#define ESP_ERR_NVS_NOT_FOUND                  0x1102
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED 0x5003
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED 0x5004
+
+#endif /* HOST_ESP_ERR_H_ */
@@ -0,0 +1,42 @@
+/**
+ * @file      esp_event.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the ESP-IDF event types. The host WiFi posts its events from
+ *            one thread, as the default event loop does.
+ */
+
+#ifndef HOST_ESP_EVENT_H_
+#define HOST_ESP_EVENT_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <freertos/FreeRTOS.h>
+#include <esp_err.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#define ESP_EVENT_ANY_ID -1
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+typedef const char *esp_event_base_t;
+
+typedef void (*esp_event_handler_t)(void *event_handler_arg, esp_event_base_t event_base,
+  int32_t event_id, void *event_data);
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+extern esp_event_base_t const WIFI_EVENT;
+extern esp_event_base_t const IP_EVENT;
+
+#endif /* HOST_ESP_EVENT_H_ */
@@ -0,0 +1,98 @@
+/**
+ * @file      esp_netif.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the station network interface. Its lease is the one that
+ *            the host WiFi gives when it associates.
+ */
+
+#ifndef HOST_ESP_NETIF_H_
+#define HOST_ESP_NETIF_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_event.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#define ESP_IPADDR_TYPE_V4 0u
+
+/* Format and arguments to print an address in network byte order. */
+#define IPSTR "%d.%d.%d.%d"
+#define esp_ip4_addr_get_byte(ipaddr, idx) (((const uint8_t *)(&(ipaddr)->addr))[idx])
+#define IP2STR(ipaddr) esp_ip4_addr_get_byte(ipaddr, 0), \
+  esp_ip4_addr_get_byte(ipaddr, 1), esp_ip4_addr_get_byte(ipaddr, 2), \
+  esp_ip4_addr_get_byte(ipaddr, 3)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+typedef struct esp_netif_obj esp_netif_t;
+
+typedef struct
+{
+  uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct
+{
+  esp_ip4_addr_t ip;
+  esp_ip4_addr_t netmask;
+  esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+typedef struct
+{
+  struct
+  {
+    union
+    {
+      esp_ip4_addr_t ip4;
+    } u_addr;
+    uint8_t type;
+  } ip;
+} esp_netif_dns_info_t;
+
+typedef enum
+{
+  ESP_NETIF_DNS_MAIN,
+  ESP_NETIF_DNS_BACKUP,
+  ESP_NETIF_DNS_FALLBACK,
+} esp_netif_dns_type_t;
+
+typedef enum
+{
+  IP_EVENT_STA_GOT_IP,
+  IP_EVENT_STA_LOST_IP,
+} ip_event_t;
+
+typedef struct
+{
+  esp_netif_t *esp_netif;
+  esp_netif_ip_info_t ip_info;
+  bool ip_changed;
+} ip_event_got_ip_t;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+esp_netif_t *esp_netif_get_handle_from_ifkey(const char *if_key);
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info);
+esp_err_t esp_netif_set_ip_info(esp_netif_t *esp_netif,
+  const esp_netif_ip_info_t *ip_info);
+esp_err_t esp_netif_get_dns_info(esp_netif_t *esp_netif,
+  const esp_netif_dns_type_t type, esp_netif_dns_info_t *dns);
+esp_err_t esp_netif_set_dns_info(esp_netif_t *esp_netif,
+  const esp_netif_dns_type_t type, esp_netif_dns_info_t *dns);
+esp_err_t esp_netif_dhcpc_start(esp_netif_t *esp_netif);
+esp_err_t esp_netif_dhcpc_stop(esp_netif_t *esp_netif);
+
+#endif /* HOST_ESP_NETIF_H_ */
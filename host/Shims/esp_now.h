@@ -0,0 +1,15 @@
+/**
+ * @file      esp_now.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of ESP-NOW, the host has no radio.
+ */
+
+#ifndef HOST_ESP_NOW_H_
+#define HOST_ESP_NOW_H_
+
+#error "The host build has no ESP-NOW radio:"
+#error "refer to (TCP_CLIENT_TRANSPORT)"
+
+#endif /* HOST_ESP_NOW_H_ */
@@ -0,0 +1,15 @@
+/**
+ * @file      esp_pm.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the power management, the host CPU can not sleep.
+ */
+
+#ifndef HOST_ESP_PM_H_
+#define HOST_ESP_PM_H_
+
+#error "The host build has no light sleep:"
+#error "refer to (SYSTEM_LOW_POWER)"
+
+#endif /* HOST_ESP_PM_H_ */
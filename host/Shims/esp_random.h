@@ -0,0 +1,17 @@
+/**
+ * @file      esp_random.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the hardware random number generator, taken from the libc
+ *            generator.
+ */
+
+#ifndef HOST_ESP_RANDOM_H_
+#define HOST_ESP_RANDOM_H_
+
+#include <stdint.h>
+
+uint32_t esp_random(void);
+
+#endif /* HOST_ESP_RANDOM_H_ */
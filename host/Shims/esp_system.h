@@ -0,0 +1,19 @@
+/**
+ * @file      esp_system.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the heap sizes of esp_system. The host has no fixed heap,
+ *            both sizes are the same constant.
+ */
+
+#ifndef HOST_ESP_SYSTEM_H_
+#define HOST_ESP_SYSTEM_H_
+
+#include <stdint.h>
+
+uint32_t esp_get_free_heap_size(void);
+
+uint32_t esp_get_minimum_free_heap_size(void);
+
+#endif /* HOST_ESP_SYSTEM_H_ */
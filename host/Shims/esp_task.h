@@ -0,0 +1,18 @@
+/**
+ * @file      esp_task.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the priorities of the ESP-IDF system tasks.
+ */
+
+#ifndef HOST_ESP_TASK_H_
+#define HOST_ESP_TASK_H_
+
+#include <freertos/FreeRTOS.h>
+
+#define ESP_TASK_PRIO_MAX   (configMAX_PRIORITIES)
+#define ESP_TASK_PRIO_MIN   (0)
+#define ESP_TASK_TCPIP_PRIO (ESP_TASK_PRIO_MAX - 7)
+
+#endif /* HOST_ESP_TASK_H_ */
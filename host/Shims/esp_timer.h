@@ -0,0 +1,56 @@
+/**
+ * @file      esp_timer.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of esp_timer. The time is taken from CLOCK_MONOTONIC since the
+ *            start of the program and every timer runs its callbacks in its own thread.
+ */
+
+#ifndef HOST_ESP_TIMER_H_
+#define HOST_ESP_TIMER_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_err.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+typedef struct esp_timer *esp_timer_handle_t;
+
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum
+{
+  ESP_TIMER_TASK,
+  ESP_TIMER_ISR,
+} esp_timer_dispatch_t;
+
+typedef struct
+{
+  esp_timer_cb_t callback;
+  void *arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char *name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+int64_t esp_timer_get_time(void);
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args,
+  esp_timer_handle_t *out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, const uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, const uint64_t period_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+bool esp_timer_is_active(esp_timer_handle_t timer);
+
+#endif /* HOST_ESP_TIMER_H_ */
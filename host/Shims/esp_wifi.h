@@ -0,0 +1,123 @@
+/**
+ * @file      esp_wifi.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the WiFi station. An association always reaches the same
+ *            access point, see host_set_WiFi_link -> Host_shims.h
+ */
+
+#ifndef HOST_ESP_WIFI_H_
+#define HOST_ESP_WIFI_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_event.h>
+#include <esp_netif.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+typedef enum
+{
+  WIFI_MODE_NULL,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+typedef enum
+{
+  WIFI_IF_STA,
+  WIFI_IF_AP,
+} wifi_interface_t;
+
+typedef enum
+{
+  WIFI_AUTH_OPEN,
+  WIFI_AUTH_WEP,
+  WIFI_AUTH_WPA_PSK,
+  WIFI_AUTH_WPA2_PSK,
+  WIFI_AUTH_WPA_WPA2_PSK,
+  WIFI_AUTH_WPA3_PSK,
+} wifi_auth_mode_t;
+
+typedef enum
+{
+  WIFI_PS_NONE,
+  WIFI_PS_MIN_MODEM,
+  WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+typedef enum
+{
+  WIFI_SECOND_CHAN_NONE,
+  WIFI_SECOND_CHAN_ABOVE,
+  WIFI_SECOND_CHAN_BELOW,
+} wifi_second_chan_t;
+
+typedef struct
+{
+  uint8_t ssid[32];
+  uint8_t password[64];
+  bool bssid_set;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint16_t listen_interval;
+  struct
+  {
+    int8_t rssi;
+    wifi_auth_mode_t authmode;
+  } threshold;
+} wifi_sta_config_t;
+
+typedef union
+{
+  wifi_sta_config_t sta;
+} wifi_config_t;
+
+typedef enum
+{
+  WIFI_EVENT_WIFI_READY,
+  WIFI_EVENT_SCAN_DONE,
+  WIFI_EVENT_STA_START,
+  WIFI_EVENT_STA_STOP,
+  WIFI_EVENT_STA_CONNECTED,
+  WIFI_EVENT_STA_DISCONNECTED,
+} wifi_event_t;
+
+typedef struct
+{
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t channel;
+  wifi_auth_mode_t authmode;
+  uint16_t aid;
+} wifi_event_sta_connected_t;
+
+typedef struct
+{
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t reason;
+  int8_t rssi;
+} wifi_event_sta_disconnected_t;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+esp_err_t esp_wifi_connect(void);
+esp_err_t esp_wifi_disconnect(void);
+esp_err_t esp_wifi_get_config(const wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_set_config(const wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_set_ps(const wifi_ps_type_t type);
+esp_err_t esp_wifi_set_channel(const uint8_t primary, const wifi_second_chan_t second);
+
+#endif /* HOST_ESP_WIFI_H_ */
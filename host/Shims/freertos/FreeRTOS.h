@@ -0,0 +1,232 @@
+/**
+ * @file      FreeRTOS.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the FreeRTOS API that the core uses, built over POSIX
+ *            threads. The ESP-IDF headers reach the task, queue and event group APIs
+ *            through each other, so all of them are declared here and task.h, queue.h
+ *            and event_groups.h only include this file.
+ */
+
+#ifndef HOST_FREERTOS_H_
+#define HOST_FREERTOS_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <sdkconfig.h>
+#include <esp_attr.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Tick rate of the scheduler, taken from the menuconfig as in ESP-IDF. */
+#define configTICK_RATE_HZ ((uint32_t)CONFIG_FREERTOS_HZ)
+
+#define configMAX_PRIORITIES 25
+
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS (1000u/configTICK_RATE_HZ)
+
+#define pdMS_TO_TICKS(ms) \
+  ((TickType_t)(((uint64_t)(ms)*configTICK_RATE_HZ)/1000u))
+#define pdTICKS_TO_MS(ticks) \
+  ((uint32_t)(((uint64_t)(ticks)*1000u)/configTICK_RATE_HZ))
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE  ((BaseType_t)1)
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define errQUEUE_FULL  pdFAIL
+#define errQUEUE_EMPTY pdFAIL
+
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#define BIT0 0x00000001u
+#define BIT1 0x00000002u
+#define BIT2 0x00000004u
+#define BIT3 0x00000008u
+#define BIT4 0x00000010u
+#define BIT5 0x00000020u
+#define BIT6 0x00000040u
+#define BIT7 0x00000080u
+
+/* A spinlock is initialized without owner. */
+#define portMUX_INITIALIZER_UNLOCKED { .owner = 0u, .count = 0u }
+
+/* The critical sections only take the spinlock, there are no interrupts to mask. */
+#define portENTER_CRITICAL(mux)      host_enter_critical(mux)
+#define portEXIT_CRITICAL(mux)       host_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux)  host_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux)   host_exit_critical(mux)
+#define portENTER_CRITICAL_SAFE(mux) host_enter_critical(mux)
+#define portEXIT_CRITICAL_SAFE(mux)  host_exit_critical(mux)
+
+/* The threads are preempted by the host, an ISR does not need to yield. */
+#define portYIELD_FROM_ISR(higher_priority_task_woken) \
+  ((void)(higher_priority_task_woken))
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+/* The ESP-IDF stacks are measured in bytes. */
+typedef uint8_t StackType_t;
+
+typedef uint32_t EventBits_t;
+
+/* Recursive spinlock of a critical section. */
+typedef struct
+{
+  /* Token of the thread that holds it, 0 if it is free. */
+  uint32_t owner;
+  /* Number of times that the owner took it. */
+  uint32_t count;
+} portMUX_TYPE;
+
+/* Actions of a task notification. */
+typedef enum
+{
+  eNoAction,
+  eSetBits,
+  eIncrement,
+  eSetValueWithOverwrite,
+  eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+/* Control block of a task, a thread of the host. */
+typedef struct
+{
+  pthread_t thread;
+  void (*func)(void *);
+  void *args;
+  const char *name;
+  uint32_t stack_size;
+  pthread_mutex_t lock;
+  pthread_cond_t notified;
+  uint32_t notify_value;
+  bool notify_pending;
+  bool allocated;
+} StaticTask_t;
+
+typedef StaticTask_t *TaskHandle_t;
+
+typedef void (*TaskFunction_t)(void *);
+
+/* Control block of a queue, the items are stored in a separated buffer. */
+typedef struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+  uint8_t *storage;
+  size_t item_size;
+  UBaseType_t length;
+  UBaseType_t head;
+  UBaseType_t count;
+  bool allocated;
+} StaticQueue_t;
+
+typedef StaticQueue_t *QueueHandle_t;
+
+/* Control block of an event group. */
+typedef struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  EventBits_t bits;
+  bool allocated;
+} StaticEventGroup_t;
+
+typedef StaticEventGroup_t *EventGroupHandle_t;
+
+/* State of a time out, see xTaskCheckForTimeOut. */
+typedef struct
+{
+  TickType_t entry_tick;
+} TimeOut_t;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/* Critical sections and ISR context. */
+void host_enter_critical(portMUX_TYPE *mux);
+void host_exit_critical(portMUX_TYPE *mux);
+BaseType_t xPortInIsrContext(void);
+
+/* Tasks. */
+BaseType_t xTaskCreate(TaskFunction_t func, const char *name, const uint32_t stack_size,
+  void *args, UBaseType_t priority, TaskHandle_t *handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, UBaseType_t priority, TaskHandle_t *handle,
+  const BaseType_t core);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, UBaseType_t priority, StackType_t *stack,
+  StaticTask_t *TCB);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t func, const char *name,
+  const uint32_t stack_size, void *args, UBaseType_t priority, StackType_t *stack,
+  StaticTask_t *TCB, const BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(const TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previous_wake_tick, const TickType_t period);
+void vTaskSetTimeOutState(TimeOut_t *time_out);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *time_out, TickType_t *ticks_to_wait);
+
+/* Task notifications. */
+BaseType_t xTaskNotify(TaskHandle_t task, const uint32_t value,
+  const eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, const uint32_t value,
+  const eNotifyAction action, BaseType_t *higher_priority_task_woken);
+BaseType_t xTaskNotifyWait(const uint32_t bits_to_clear_on_entry,
+  const uint32_t bits_to_clear_on_exit, uint32_t *value, const TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(const BaseType_t clear_on_exit, const TickType_t ticks);
+
+/* Queues. */
+QueueHandle_t xQueueCreate(const UBaseType_t length, const UBaseType_t item_size);
+QueueHandle_t xQueueCreateStatic(const UBaseType_t length, const UBaseType_t item_size,
+  uint8_t *storage, StaticQueue_t *queue_buffer);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, const TickType_t ticks);
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item,
+  const TickType_t ticks);
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item,
+  const TickType_t ticks);
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item,
+  BaseType_t *higher_priority_task_woken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, const TickType_t ticks);
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void *item,
+  BaseType_t *higher_priority_task_woken);
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, const TickType_t ticks);
+BaseType_t xQueuePeekFromISR(QueueHandle_t queue, void *item);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+/* Event groups. */
+EventGroupHandle_t xEventGroupCreate(void);
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *event_group_buffer);
+void vEventGroupDelete(EventGroupHandle_t event_group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t event_group, const EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t event_group,
+  const EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t event_group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t event_group, const EventBits_t bits,
+  const BaseType_t clear_on_exit, const BaseType_t wait_for_all,
+  const TickType_t ticks);
+
+#endif /* HOST_FREERTOS_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file      event_groups.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim, the API is declared in FreeRTOS.h.
+ */
+
+#ifndef HOST_EVENT_GROUPS_H_
+#define HOST_EVENT_GROUPS_H_
+
+#include <freertos/FreeRTOS.h>
+
+#endif /* HOST_EVENT_GROUPS_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file      queue.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim, the API is declared in FreeRTOS.h.
+ */
+
+#ifndef HOST_QUEUE_H_
+#define HOST_QUEUE_H_
+
+#include <freertos/FreeRTOS.h>
+
+#endif /* HOST_QUEUE_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file      task.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim, the API is declared in FreeRTOS.h.
+ */
+
+#ifndef HOST_TASK_H_
+#define HOST_TASK_H_
+
+#include <freertos/FreeRTOS.h>
+
+#endif /* HOST_TASK_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file      dns.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the lwIP DNS client, see netdb.h.
+ */
+
+#ifndef HOST_LWIP_DNS_H_
+#define HOST_LWIP_DNS_H_
+
+#include <lwip/netdb.h>
+
+#endif /* HOST_LWIP_DNS_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file      err.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the lwIP errors, the core only reads errno.
+ */
+
+#ifndef HOST_LWIP_ERR_H_
+#define HOST_LWIP_ERR_H_
+
+#include <errno.h>
+
+#endif /* HOST_LWIP_ERR_H_ */
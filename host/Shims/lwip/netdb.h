@@ -0,0 +1,14 @@
+/**
+ * @file      netdb.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the lwIP resolver, the one of the host.
+ */
+
+#ifndef HOST_LWIP_NETDB_H_
+#define HOST_LWIP_NETDB_H_
+
+#include <netdb.h>
+
+#endif /* HOST_LWIP_NETDB_H_ */
@@ -0,0 +1,14 @@
+/**
+ * @file      sys.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the lwIP system layer, the core does not use it.
+ */
+
+#ifndef HOST_LWIP_SYS_H_
+#define HOST_LWIP_SYS_H_
+
+#include <stdint.h>
+
+#endif /* HOST_LWIP_SYS_H_ */
@@ -0,0 +1,15 @@
+/**
+ * @file      tcp.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the raw TCP API of lwIP, the host has no lwIP core.
+ */
+
+#ifndef HOST_LWIP_TCP_H_
+#define HOST_LWIP_TCP_H_
+
+#error "The host build has no lwIP core:"
+#error "refer to (TCP_CLIENT_LWIP_API)"
+
+#endif /* HOST_LWIP_TCP_H_ */
@@ -0,0 +1,16 @@
+/**
+ * @file      nvs_flash.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the NVS partition, it lives in RAM.
+ */
+
+#ifndef HOST_NVS_FLASH_H_
+#define HOST_NVS_FLASH_H_
+
+#include <esp_err.h>
+
+esp_err_t nvs_flash_init(void);
+
+#endif /* HOST_NVS_FLASH_H_ */
@@ -0,0 +1,22 @@
+/**
+ * @file      sdkconfig.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     Host shim of the menuconfig. The host has no power management, so the
+ *            low power mode can not be built.
+ */
+
+#ifndef HOST_SDKCONFIG_H_
+#define HOST_SDKCONFIG_H_
+
+/* Tick rate of the scheduler, the same as the default one of ESP-IDF so the waits
+ * round to ticks as in the device.
+ */
+#ifndef CONFIG_FREERTOS_HZ
+  #define CONFIG_FREERTOS_HZ 100
+#endif
+
+/* CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE are not defined. */
+
+#endif /* HOST_SDKCONFIG_H_ */
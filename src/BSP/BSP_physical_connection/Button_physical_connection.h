@@ -37,12 +37,14 @@
  *      in gpio_pull_mode_t enum -> gpio_types.h
  *   4) Which wntruption mode will be set to the button GPIO. It is mandatory to use
  *      an enumerate defined in gpio_int_type_t -> gpio_types.h
- *   5) Debounce time in milliseconds. To remove unwanted input noise. 
+ *   5) Debounce time in milliseconds. To remove unwanted input noise. With
+ *      SYSTEM_DEBOUNCE_ENGINE it is the integration time after every edge, a few
+ *      milliseconds cover the bounces of a mechanical contact.
  *   
  */
 #define BUTTONS_CONFIGURATIONS                                                     \
-  BUTTON_CONFIG(BUTTON_0, GPIO_NUM_4, GPIO_PULLDOWN_ONLY, GPIO_INTR_POSEDGE, 800u) \
-  BUTTON_CONFIG(BUTTON_1, GPIO_NUM_20, GPIO_PULLDOWN_ONLY, GPIO_INTR_POSEDGE, 800u)   
+  BUTTON_CONFIG(BUTTON_0, GPIO_NUM_4, GPIO_PULLDOWN_ONLY, GPIO_INTR_POSEDGE, 5u)   \
+  BUTTON_CONFIG(BUTTON_1, GPIO_NUM_20, GPIO_PULLDOWN_ONLY, GPIO_INTR_POSEDGE, 5u)   
 
 /***************************************************************************************
  * Data Type Definitions
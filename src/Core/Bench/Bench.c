@@ -0,0 +1,289 @@
+/**
+ * @file      Bench.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions of the benchmark mode, that
+ *            injects synthetic presses in button_CB and reports their throughput,
+ *            drops and latency. It is only compiled with SYSTEM_BENCH_MODE.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Bench.h>
+
+#if SYSTEM_BENCH_MODE == 1
+
+#include <Button.h>
+#include <TCP_client.h>
+#include <Latency.h>
+#include <System_memory.h>
+#include <System_tasks.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Time in ticks between two checks of the client while it is not initialized. */
+#define CLIENT_POLL_TICKS pdMS_TO_TICKS(100u)
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core bench module. */
+  #define TAG "CORE_BENCH"
+#else
+  #error "The benchmark mode prints its reports in debug mode:"
+  #error "refer to (SYSTEM_BENCH_MODE) and (DEBUG_MODE_ENABLE)"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that describes a benchmark run from BENCH_RUNS. */
+typedef struct
+{
+  /* Presses per second of every button. */
+  uint32_t rate_Hz;
+  /* Number of presses of every button that are injected back to back. */
+  uint32_t burst_len;
+  /* Buttons pressed at the same time, a bit per button. */
+  uint32_t buttons;
+  /* Number of presses of every button. */
+  uint32_t num_of_presses;
+} bench_run;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Runs of the benchmark, in the order of BENCH_RUNS. */
+static const bench_run bench_runs[] =
+{
+  #define BENCH_RUN(rate, burst, buttons_mask, presses) \
+    {                                                   \
+      .rate_Hz = rate,                                  \
+      .burst_len = burst,                               \
+      .buttons = buttons_mask,                          \
+      .num_of_presses = presses,                        \
+    },
+    BENCH_RUNS
+  #undef BENCH_RUN
+};
+
+/* Number of runs of the benchmark. */
+#define NUM_OF_BENCH_RUNS (sizeof(bench_runs)/sizeof(bench_runs[0]))
+
+/* Checks if every run has valid values. */
+#define BENCH_RUN(rate, burst, buttons_mask, presses)                                \
+  _Static_assert((rate) >= 1u && (rate) <= 100u,                                     \
+    "Invalid benchmark rate: [1-100] presses per second: refer to (BENCH_RUNS)");    \
+  _Static_assert((burst) >= 1u && (presses) >= 1u,                                   \
+    "Invalid benchmark run: at least one press: refer to (BENCH_RUNS)");             \
+  _Static_assert((buttons_mask) != 0u && (buttons_mask) < (1u << NUM_OF_BUTTONS),    \
+    "Invalid benchmark buttons: refer to (BENCH_RUNS)");
+  BENCH_RUNS
+#undef BENCH_RUN
+
+/* Handler of the task that runs the benchmarks. */
+static TaskHandle_t bench_task_handler;
+
+#if SYSTEM_STATIC_ALLOCATION == 1
+  /* Stack and control block of the benchmark task. */
+  static StackType_t bench_task_stack[BENCH_STACK_SIZE];
+  static StaticTask_t bench_task_TCB;
+#endif
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Function that runs every benchmark of BENCH_RUNS once the link is up.
+ *
+ * @param args arguments to pass to the function.
+ *
+ * @return void
+ */
+static void bench_func(void *args);
+
+/**
+ * @brief Injects the presses of a run at its rate.
+ *
+ * @param run Run to inject.
+ *
+ * @return Number of presses injected, of all the buttons.
+ */
+static uint32_t inject_bench_run(const bench_run *run);
+
+/**
+ * @brief Prints the report of a run: presses that reached the dispatcher, presses lost
+ *        before it, batches written, throughput and the percentiles of every stage.
+ *
+ * @param run_index Index of the run in BENCH_RUNS.
+ *
+ * @param injected Number of presses injected.
+ *
+ * @param elapsed_us Time in microseconds that the injection of the presses took.
+ *
+ * @return void
+ */
+static void report_bench_run(const uint32_t run_index, const uint32_t injected,
+  const int64_t elapsed_us);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Bench_return start_bench(void)
+{
+
+  if(bench_task_handler != NULL)
+  {
+    return CORE_BENCH_OK;
+  }
+
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    bench_task_handler = xTaskCreateStaticPinnedToCore(bench_func, "bench_func",
+      BENCH_STACK_SIZE, (void *) 0, (UBaseType_t)BENCH_TASK_PRIORITY,
+      bench_task_stack, &bench_task_TCB, BENCH_TASK_CORE);
+  #else
+    if(xTaskCreatePinnedToCore(bench_func, "bench_func", BENCH_STACK_SIZE,
+         (void *) 0, (UBaseType_t)BENCH_TASK_PRIORITY, &bench_task_handler,
+         BENCH_TASK_CORE) != pdPASS)
+    {
+      bench_task_handler = NULL;
+    }
+  #endif
+  if(bench_task_handler == NULL)
+  {
+    return CORE_BENCH_INIT_TASK_ERR;
+  }
+
+  return CORE_BENCH_OK;
+}
+
+inline Bench_return core_bench_LOG(const Bench_return ret)
+{
+  switch(ret)
+  {
+    #define BENCH_RETURN(enumerate)   \
+      case enumerate:                 \
+        if(ret > 0)                   \
+        {                             \
+          CORE_LOGE(TAG, #enumerate); \
+        }                             \
+        else                          \
+        {                             \
+          CORE_LOGI(TAG, #enumerate); \
+        }                             \
+        break;
+      BENCH_RETURNS
+    #undef BENCH_RETURN
+    default:
+      CORE_LOGE(TAG, "Undefined return.");
+      break;
+  }
+  return ret;
+}
+
+static void bench_func(void *args)
+{
+
+  /* The client can be started after the benchmark. */
+  while(wait_for_connection(portMAX_DELAY) != CORE_TCP_CLIENT_OK)
+  {
+    vTaskDelay(CLIENT_POLL_TICKS);
+  }
+  vTaskDelay(pdMS_TO_TICKS(BENCH_START_DELAY_MS));
+
+  for(uint32_t run = 0u; run < NUM_OF_BENCH_RUNS; run++)
+  {
+    reset_latency_stats();
+
+    const int64_t start_us = esp_timer_get_time();
+    const uint32_t injected = inject_bench_run(&bench_runs[run]);
+    const int64_t elapsed_us = esp_timer_get_time() - start_us;
+
+    /* The presses that are still queued are delivered before the report. */
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+
+    report_bench_run(run, injected, elapsed_us);
+  }
+
+  ESP_LOGI(TAG, "Benchmark finished.");
+
+  bench_task_handler = NULL;
+  vTaskDelete(NULL);
+}
+
+static uint32_t inject_bench_run(const bench_run *run)
+{
+
+  uint32_t injected = 0u;
+  TickType_t last_wake_tick = xTaskGetTickCount();
+
+  for(uint32_t press = 0u; press < run->num_of_presses;)
+  {
+    /* The presses of a burst and the buttons of a press come together, as the ISRs
+     * of several buttons would report them.
+     */
+    uint32_t burst_presses = 0u;
+    for(; burst_presses < run->burst_len && press < run->num_of_presses;
+        burst_presses++, press++)
+    {
+      for(uint32_t ID = 0u; ID < NUM_OF_BUTTONS; ID++)
+      {
+        if((run->buttons & (1u << ID)) != 0u)
+        {
+          button_CB((Button_ID)ID);
+          injected++;
+        }
+      }
+    }
+
+    /* Wait the time of the whole burst, measured from the previous one so the rate
+     * does not drift.
+     */
+    const TickType_t burst_ticks = pdMS_TO_TICKS((burst_presses*1000u)/run->rate_Hz);
+    vTaskDelayUntil(&last_wake_tick, (burst_ticks > 0u) ? burst_ticks : 1u);
+  }
+
+  return injected;
+}
+
+static void report_bench_run(const uint32_t run_index, const uint32_t injected,
+  const int64_t elapsed_us)
+{
+
+  const bench_run *run = &bench_runs[run_index];
+  Latency_stats dispatched;
+  Latency_stats written;
+  get_latency_stats(LATENCY_PRESS_TO_DISPATCH, &dispatched);
+  get_latency_stats(LATENCY_PRESS_TO_WRITE, &written);
+
+  const uint32_t lost = (injected > dispatched.count) ? injected - dispatched.count : 0u;
+  const uint32_t throughput = (elapsed_us > 0) ?
+    (uint32_t)(((int64_t)dispatched.count*1000000)/elapsed_us) : 0u;
+
+  ESP_LOGI(TAG, "Run %u: %u Hz, bursts of %u, buttons 0x%x, %u presses per button",
+    (unsigned int)run_index, (unsigned int)run->rate_Hz, (unsigned int)run->burst_len,
+    (unsigned int)run->buttons, (unsigned int)run->num_of_presses);
+  ESP_LOGI(TAG, "Run %u: injected=%u dispatched=%u lost=%u batches=%u "
+    "throughput=%u presses/s", (unsigned int)run_index, (unsigned int)injected,
+    (unsigned int)dispatched.count, (unsigned int)lost, (unsigned int)written.count,
+    (unsigned int)throughput);
+  ESP_LOGI(TAG, "Run %u: press to write p50<=%uus p99<=%uus max=%uus",
+    (unsigned int)run_index, (unsigned int)written.p50_us,
+    (unsigned int)written.p99_us, (unsigned int)written.max_us);
+
+  /* The rest of the stages tell where the time went. */
+  print_latency_stats();
+}
+
+#endif /* SYSTEM_BENCH_MODE == 1 */
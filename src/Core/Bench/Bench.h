@@ -0,0 +1,73 @@
+/**
+ * @file      Bench.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions of the benchmark mode, that
+ *            injects synthetic presses in button_CB and reports their throughput,
+ *            drops and latency. It is only compiled with SYSTEM_BENCH_MODE.
+ */
+
+#ifndef CORE_BENCH_H_
+#define CORE_BENCH_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_bench.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module bench can return. */
+#define BENCH_RETURNS                                 \
+  /* Info codes */                                    \
+  BENCH_RETURN(CORE_BENCH_OK)                         \
+  /* Error codes */                                   \
+  BENCH_RETURN(CORE_BENCH_INIT_TASK_ERR)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define BENCH_RETURN(enumerate) enumerate,
+    BENCH_RETURNS
+  #undef BENCH_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_BENCH_RETURNS,
+} Bench_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Creates the task that runs the benchmarks of BENCH_RUNS. The task waits for
+ *        the link, so it can be called before the client is started. The remote
+ *        switches of the benchmark buttons must be initialized before the first run.
+ *
+ * @param void
+ *
+ * @return CORE_BENCH_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_BENCH_INIT_TASK_ERR:
+ *               Error trying to create the benchmark task.
+ */
+Bench_return start_bench(void);
+
+/**
+ * @brief Prints the return of a bench module function if the system was configured in
+ *        debug mode.
+ *
+ * @param ret Received return from a bench module function.
+ *
+ * @return The given return.
+ */
+Bench_return core_bench_LOG(const Bench_return ret);
+
+#endif /* CORE_BENCH_H_ */
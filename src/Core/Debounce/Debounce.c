@@ -0,0 +1,389 @@
+/**
+ * @file      Debounce.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions of the engine that debounces the
+ *            buttons and reports their presses and releases. It is only compiled with
+ *            SYSTEM_DEBOUNCE_ENGINE.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Debounce.h>
+
+#if SYSTEM_DEBOUNCE_ENGINE == 1
+
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <freertos/FreeRTOS.h>
+#include <driver/gpio.h>
+#include <esp_timer.h>
+#include <stdbool.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Number of samples that integrate the given debounce time in milliseconds, one at
+ * least.
+ */
+#define DEBOUNCE_SAMPLES(debounce_ms)                                           \
+  ((((debounce_ms)*1000u) / DEBOUNCE_SAMPLE_PERIOD_US > 0u) ?                  \
+    (((debounce_ms)*1000u) / DEBOUNCE_SAMPLE_PERIOD_US) : 1u)
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core debounce module. */
+  #define TAG "CORE_DEBOUNCE"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that describes how to read and debounce a button. */
+typedef struct
+{
+  /* GPIO that reads the button state. */
+  gpio_num_t GPIO;
+  /* Pull mode of the GPIO. */
+  gpio_pull_mode_t pull_mode;
+  /* Level of the GPIO while the button is pressed. */
+  int pressed_level;
+  /* Number of samples of the debounce time. */
+  uint32_t num_of_samples;
+} debounce_input;
+
+/* Structure that contains the debounce state of a button. */
+typedef struct
+{
+  /* Debounced state, the last one reported. */
+  Button_state state;
+  /* Integrator of the samples, from 0 (released) to num_of_samples (pressed). */
+  uint32_t integrator;
+  /* Number of consecutive samples that matched the debounced state. */
+  uint32_t quiet_samples;
+  /* Indicates if the button was initialized. */
+  bool initialized;
+} debounce_state;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Inputs of the buttons, a pulled down button reads a high level while pressed. */
+static const debounce_input debounce_inputs[NUM_OF_BUTTONS] =
+{
+  #define BUTTON_CONFIG(button_ID, GPIO_num, pull, intr_type, debounce) \
+    [button_ID] =                                                       \
+    {                                                                   \
+      .GPIO = GPIO_num,                                                 \
+      .pull_mode = pull,                                                \
+      .pressed_level = (pull == GPIO_PULLUP_ONLY) ? 0 : 1,              \
+      .num_of_samples = DEBOUNCE_SAMPLES(debounce),                     \
+    },
+    BUTTONS_CONFIGURATIONS
+  #undef BUTTON_CONFIG
+};
+
+/* Debounce state of every button. */
+static debounce_state debounce_states[NUM_OF_BUTTONS];
+
+/* Buttons that are being sampled, a bit per button. Their GPIO interruption is
+ * disabled until they settle.
+ */
+static uint32_t sampling_buttons;
+
+/* Spinlock to ensure atomicity between the GPIO ISR and the sample timer. */
+static portMUX_TYPE debounce_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Timer that samples the buttons, it only runs while a button is being sampled. */
+static esp_timer_handle_t sample_timer;
+
+_Static_assert(NUM_OF_BUTTONS <= 32, "The sampled buttons do not fit in a bit mask");
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Reads the current state of a button from its GPIO, without debouncing.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return The state of the button.
+ */
+static Button_state read_button_state(const Button_ID ID);
+
+/**
+ * @brief ISR of the edges of a button. It reports the first edge right away and
+ *        starts sampling the button.
+ *
+ * @param arg Identifier of the button.
+ *
+ * @return void
+ */
+static void edge_ISR(void *arg);
+
+/**
+ * @brief Callback of the sample timer. It integrates a sample of every sampled
+ *        button, reports the edges that the integrator confirms and gives back the
+ *        GPIO interruption to the buttons that settled.
+ *
+ * @param arg Not used.
+ *
+ * @return void
+ */
+static void sample_buttons_CB(void *arg);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Debounce_return init_debounce(const Button_ID ID)
+{
+
+  if(ID >= NUM_OF_BUTTONS)
+  {
+    return CORE_DEBOUNCE_INVALID_BUTTON_ERR;
+  }
+
+  /* The timer serves all the buttons, create it with the first one. */
+  if(sample_timer == NULL)
+  {
+    const esp_timer_create_args_t timer_args =
+    {
+      .callback = sample_buttons_CB,
+      .dispatch_method = ESP_TIMER_TASK,
+      .name = "debounce",
+    };
+    if(esp_timer_create(&timer_args, &sample_timer) != ESP_OK)
+    {
+      sample_timer = NULL;
+      return CORE_DEBOUNCE_INIT_TIMER_ERR;
+    }
+  }
+
+  const debounce_input *input = &debounce_inputs[ID];
+  const gpio_config_t config =
+  {
+    .pin_bit_mask = (uint64_t)1u << input->GPIO,
+    .mode = GPIO_MODE_INPUT,
+    .pull_up_en = (input->pull_mode == GPIO_PULLUP_ONLY) ?
+      GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+    .pull_down_en = (input->pull_mode == GPIO_PULLDOWN_ONLY) ?
+      GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
+    .intr_type = GPIO_INTR_ANYEDGE,
+  };
+  if(gpio_config(&config) != ESP_OK)
+  {
+    return CORE_DEBOUNCE_INIT_GPIO_ERR;
+  }
+
+  /* Another module could have installed the ISR service already. */
+  const esp_err_t ret = gpio_install_isr_service(0);
+  if(ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+  {
+    return CORE_DEBOUNCE_INIT_GPIO_ERR;
+  }
+
+  /* Start from the current state, a button held at boot is not a press. */
+  portENTER_CRITICAL(&debounce_lock);
+  debounce_state *button = &debounce_states[ID];
+  button->state = read_button_state(ID);
+  button->integrator = (button->state == BUTTON_IS_PRESSED) ?
+    input->num_of_samples : 0u;
+  button->quiet_samples = 0u;
+  button->initialized = true;
+  sampling_buttons &= ~((uint32_t)1u << ID);
+  portEXIT_CRITICAL(&debounce_lock);
+
+  if(gpio_isr_handler_add(input->GPIO, edge_ISR, (void *)(uintptr_t)ID) != ESP_OK ||
+     gpio_intr_enable(input->GPIO) != ESP_OK)
+  {
+    debounce_states[ID].initialized = false;
+    return CORE_DEBOUNCE_INIT_GPIO_ERR;
+  }
+
+  return CORE_DEBOUNCE_OK;
+}
+
+Debounce_return de_init_debounce(const Button_ID ID)
+{
+
+  if(ID >= NUM_OF_BUTTONS)
+  {
+    return CORE_DEBOUNCE_INVALID_BUTTON_ERR;
+  }
+
+  gpio_intr_disable(debounce_inputs[ID].GPIO);
+
+  portENTER_CRITICAL(&debounce_lock);
+  debounce_states[ID].initialized = false;
+  sampling_buttons &= ~((uint32_t)1u << ID);
+  portEXIT_CRITICAL(&debounce_lock);
+
+  if(gpio_isr_handler_remove(debounce_inputs[ID].GPIO) != ESP_OK)
+  {
+    return CORE_DEBOUNCE_DE_INIT_GPIO_ERR;
+  }
+
+  return CORE_DEBOUNCE_OK;
+}
+
+inline Debounce_return core_debounce_LOG(const Debounce_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define DEBOUNCE_RETURN(enumerate) \
+        case enumerate:                  \
+          if(ret > 0)                    \
+          {                              \
+            CORE_LOGE(TAG, #enumerate);  \
+          }                              \
+          else                           \
+          {                              \
+            CORE_LOGI(TAG, #enumerate);  \
+          }                              \
+          break;
+        DEBOUNCE_RETURNS
+      #undef DEBOUNCE_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+static Button_state read_button_state(const Button_ID ID)
+{
+
+  const debounce_input *input = &debounce_inputs[ID];
+  return (gpio_get_level(input->GPIO) == input->pressed_level) ?
+    BUTTON_IS_PRESSED : BUTTON_IS_NOT_PRESSED;
+}
+
+static void edge_ISR(void *arg)
+{
+
+  const Button_ID ID = (Button_ID)(uintptr_t)arg;
+  const int64_t timestamp = esp_timer_get_time();
+  const uint32_t button_bit = (uint32_t)1u << ID;
+  debounce_state *button = &debounce_states[ID];
+  bool report = false;
+  Button_state state;
+
+  portENTER_CRITICAL_ISR(&debounce_lock);
+
+  /* The GPIO is sampled until it settles, the bounces do not interrupt meanwhile. */
+  gpio_intr_disable(debounce_inputs[ID].GPIO);
+
+  state = read_button_state(ID);
+  if(button->initialized && state != button->state)
+  {
+    /* The first edge is trusted, the integrator holds it for the debounce time. */
+    button->state = state;
+    button->integrator = (state == BUTTON_IS_PRESSED) ?
+      debounce_inputs[ID].num_of_samples : 0u;
+    report = true;
+  }
+  button->quiet_samples = 0u;
+
+  if(button->initialized && (sampling_buttons & button_bit) == 0u)
+  {
+    if(sampling_buttons == 0u)
+    {
+      esp_timer_start_periodic(sample_timer, DEBOUNCE_SAMPLE_PERIOD_US);
+    }
+    sampling_buttons |= button_bit;
+  }
+
+  portEXIT_CRITICAL_ISR(&debounce_lock);
+
+  if(report)
+  {
+    debounce_CB(ID, state, timestamp);
+  }
+}
+
+static void sample_buttons_CB(void *arg)
+{
+
+  for(uint32_t ID = 0u; ID < NUM_OF_BUTTONS; ID++)
+  {
+    const uint32_t button_bit = (uint32_t)1u << ID;
+    const uint32_t num_of_samples = debounce_inputs[ID].num_of_samples;
+    debounce_state *button = &debounce_states[ID];
+    bool report = false;
+    Button_state state;
+
+    portENTER_CRITICAL(&debounce_lock);
+
+    if((sampling_buttons & button_bit) == 0u)
+    {
+      portEXIT_CRITICAL(&debounce_lock);
+      continue;
+    }
+
+    const Button_state sample = read_button_state((Button_ID)ID);
+    if(sample == BUTTON_IS_PRESSED && button->integrator < num_of_samples)
+    {
+      button->integrator++;
+    }
+    else if(sample == BUTTON_IS_NOT_PRESSED && button->integrator > 0u)
+    {
+      button->integrator--;
+    }
+
+    /* Only an integrator at one end changes the state, a bounce moves it a bit. */
+    if(button->state == BUTTON_IS_NOT_PRESSED && button->integrator == num_of_samples)
+    {
+      button->state = BUTTON_IS_PRESSED;
+      report = true;
+    }
+    else if(button->state == BUTTON_IS_PRESSED && button->integrator == 0u)
+    {
+      button->state = BUTTON_IS_NOT_PRESSED;
+      report = true;
+    }
+    state = button->state;
+
+    button->quiet_samples = (sample == state) ? button->quiet_samples + 1u : 0u;
+    if(button->quiet_samples >= num_of_samples)
+    {
+      /* Settled, the next edge interrupts again. An edge that came before the
+       * interruption was enabled is seen by the check that follows.
+       */
+      gpio_intr_enable(debounce_inputs[ID].GPIO);
+      if(read_button_state((Button_ID)ID) == state)
+      {
+        sampling_buttons &= ~button_bit;
+      }
+      else
+      {
+        gpio_intr_disable(debounce_inputs[ID].GPIO);
+        button->quiet_samples = 0u;
+      }
+    }
+
+    portEXIT_CRITICAL(&debounce_lock);
+
+    if(report)
+    {
+      debounce_CB((Button_ID)ID, state, esp_timer_get_time());
+    }
+  }
+
+  /* The timer only runs while there is something to sample. */
+  portENTER_CRITICAL(&debounce_lock);
+  if(sampling_buttons == 0u)
+  {
+    esp_timer_stop(sample_timer);
+  }
+  portEXIT_CRITICAL(&debounce_lock);
+}
+
+#endif /* SYSTEM_DEBOUNCE_ENGINE == 1 */
@@ -0,0 +1,113 @@
+/**
+ * @file      Debounce.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions of the engine that debounces the
+ *            buttons and reports their presses and releases.
+ */
+
+#ifndef CORE_DEBOUNCE_H_
+#define CORE_DEBOUNCE_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_debounce.h>
+#include <Button_physical_connection.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module debounce can return. */
+#define DEBOUNCE_RETURNS                                    \
+  /* Info codes */                                          \
+  DEBOUNCE_RETURN(CORE_DEBOUNCE_OK)                         \
+  /* Error codes */                                         \
+  DEBOUNCE_RETURN(CORE_DEBOUNCE_INVALID_BUTTON_ERR)         \
+  DEBOUNCE_RETURN(CORE_DEBOUNCE_INIT_TIMER_ERR)             \
+  DEBOUNCE_RETURN(CORE_DEBOUNCE_INIT_GPIO_ERR)              \
+  DEBOUNCE_RETURN(CORE_DEBOUNCE_DE_INIT_GPIO_ERR)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define DEBOUNCE_RETURN(enumerate) enumerate,
+    DEBOUNCE_RETURNS
+  #undef DEBOUNCE_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_DEBOUNCE_RETURNS,
+} Debounce_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Configures the GPIO of a button from BUTTONS_CONFIGURATIONS and starts to
+ *        report its edges through debounce_CB.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return CORE_DEBOUNCE_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_DEBOUNCE_INVALID_BUTTON_ERR:
+ *               The given button does not exist.
+ *
+ *           - CORE_DEBOUNCE_INIT_TIMER_ERR:
+ *               Error trying to create the sample timer.
+ *
+ *           - CORE_DEBOUNCE_INIT_GPIO_ERR:
+ *               Error trying to configure the GPIO or its interruption.
+ */
+Debounce_return init_debounce(const Button_ID ID);
+
+/**
+ * @brief Stops reporting the edges of a button.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @return CORE_DEBOUNCE_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_DEBOUNCE_INVALID_BUTTON_ERR:
+ *               The given button does not exist.
+ *
+ *           - CORE_DEBOUNCE_DE_INIT_GPIO_ERR:
+ *               Error trying to remove the interruption of the GPIO.
+ */
+Debounce_return de_init_debounce(const Button_ID ID);
+
+/**
+ * @brief Callback executed when a button is pressed or released. The first edge is
+ *        reported from the GPIO ISR, the ones found while sampling from the esp_timer
+ *        task, so it must be safe in both contexts.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @param state New state of the button.
+ *
+ * @param timestamp Time in microseconds since boot of the edge.
+ *
+ * @return void
+ */
+void debounce_CB(const Button_ID ID, const Button_state state, const int64_t timestamp);
+
+/**
+ * @brief Prints the return of a debounce module function if the system was configured
+ *        in debug mode.
+ *
+ * @param ret Received return from a debounce module function.
+ *
+ * @return The given return.
+ */
+Debounce_return core_debounce_LOG(const Debounce_return ret);
+
+#endif /* CORE_DEBOUNCE_H_ */
@@ -0,0 +1,325 @@
+/**
+ * @file      Deferred_log.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to print the traces of the core
+ *            modules out of the hot path. The traces are stored as compact records in
+ *            a lock-free ring buffer and a low priority task prints them.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Deferred_log.h>
+#include <System_memory.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* The records are only stored in debug mode, so only then the ring buffer and the
+ * task that prints it are compiled.
+ */
+#if SYSTEM_DEFERRED_LOG == 1 && DEBUG_MODE_ENABLE == 1
+  #define DEFERRED_LOG_TASK 1
+#else
+  #define DEFERRED_LOG_TASK 0
+#endif
+
+/* Mask that turns a record index into its slot of the ring buffer. */
+#define SLOT_MASK (DEFERRED_LOG_LEN - 1u)
+
+/* Maximum length of a printed text, its argument included. */
+#define MAX_TEXT_LEN 96u
+
+/* Bit of the task notification value that the producers set for every record. */
+#define NEW_RECORD_BIT BIT0
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core deferred log module. */
+  #define TAG "CORE_DEFERRED_LOG"
+#endif
+
+#if DEFERRED_LOG_TASK == 1
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Slot of the ring buffer. Its sequence is 2*index + 1 while the record of that index
+ * is written and 2*index + 2 once it is complete, so the task can tell a complete
+ * record from one that is being written or that was overwritten.
+ */
+typedef struct
+{
+  _Atomic uint32_t seq;
+  _Atomic uint32_t timestamp_us;
+  _Atomic(const char *) tag;
+  _Atomic(const char *) text;
+  _Atomic int arg;
+  _Atomic uint8_t level;
+} log_slot;
+
+/* Copy of a record taken from the ring buffer. */
+typedef struct
+{
+  uint32_t timestamp_us;
+  const char *tag;
+  const char *text;
+  int arg;
+  Deferred_log_level level;
+} log_record;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Ring buffer of the records, shared by all the producers without locking. */
+static log_slot log_ring[DEFERRED_LOG_LEN];
+
+/* Index of the next record to store, the producers take it with an atomic add. */
+static _Atomic uint32_t write_index;
+
+/* Index of the next record to print, only the task accesses it. */
+static uint32_t read_index;
+
+/* Handler of the task that prints the records. */
+static TaskHandle_t deferred_log_task_handler;
+
+#if SYSTEM_STATIC_ALLOCATION == 1
+  /* Stack and control block of the task that prints the records. */
+  static StackType_t deferred_log_task_stack[DEFERRED_LOG_STACK_SIZE];
+  static StaticTask_t deferred_log_task_TCB;
+#endif
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Function that will print the records of the ring buffer periodically.
+ *
+ * @param args arguments to pass to the function.
+ *
+ * @return void
+ */
+static void deferred_log_func(void *args);
+
+/**
+ * @brief Takes the next complete record of the ring buffer. The records that were
+ *        overwritten before they were taken are skipped and counted.
+ *
+ * @param record Where the record is copied.
+ *
+ * @param lost Number of records that were overwritten, it is increased.
+ *
+ * @return True if a record was taken, otherwise false.
+ */
+static bool take_log_record(log_record *record, uint32_t *lost);
+
+#endif /* DEFERRED_LOG_TASK == 1 */
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Deferred_log_return init_deferred_log(void)
+{
+
+  #if DEFERRED_LOG_TASK == 0
+    /* Nothing is stored, there is nothing to print. */
+    return CORE_DEFERRED_LOG_OK;
+  #else
+
+  /* The task lives as long as the system, it is only created once. */
+  if(deferred_log_task_handler != NULL)
+  {
+    return CORE_DEFERRED_LOG_OK;
+  }
+
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    deferred_log_task_handler = xTaskCreateStatic(deferred_log_func,
+      "deferred_log_func", DEFERRED_LOG_STACK_SIZE, (void *) 0,
+      (UBaseType_t)DEFERRED_LOG_TASK_PRIORITY, deferred_log_task_stack,
+      &deferred_log_task_TCB);
+  #else
+    if(xTaskCreate(deferred_log_func, "deferred_log_func", DEFERRED_LOG_STACK_SIZE,
+         (void *) 0, (UBaseType_t)DEFERRED_LOG_TASK_PRIORITY,
+         &deferred_log_task_handler) != pdPASS)
+    {
+      deferred_log_task_handler = NULL;
+    }
+  #endif
+  if(deferred_log_task_handler == NULL)
+  {
+    return CORE_DEFERRED_LOG_INIT_TASK_ERR;
+  }
+
+  return CORE_DEFERRED_LOG_OK;
+
+  #endif
+}
+
+void deferred_log(const Deferred_log_level level, const char *tag, const char *text,
+  const int arg)
+{
+
+  #if DEFERRED_LOG_TASK == 1
+
+  const uint32_t index = atomic_fetch_add_explicit(&write_index, 1u,
+    memory_order_relaxed);
+  log_slot *slot = &log_ring[index & SLOT_MASK];
+
+  /* Mark the slot as being written before touching the record. */
+  atomic_store_explicit(&slot->seq, (2u*index) + 1u, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  atomic_store_explicit(&slot->timestamp_us, (uint32_t)esp_timer_get_time(),
+    memory_order_relaxed);
+  atomic_store_explicit(&slot->tag, tag, memory_order_relaxed);
+  atomic_store_explicit(&slot->text, text, memory_order_relaxed);
+  atomic_store_explicit(&slot->arg, arg, memory_order_relaxed);
+  atomic_store_explicit(&slot->level, (uint8_t)level, memory_order_relaxed);
+
+  atomic_store_explicit(&slot->seq, (2u*index) + 2u, memory_order_release);
+
+  /* Wake up the task. It has the lowest priority, so the producer is not preempted. */
+  if(deferred_log_task_handler != NULL)
+  {
+    if(xPortInIsrContext())
+    {
+      BaseType_t higher_priority_task_woken = pdFALSE;
+      xTaskNotifyFromISR(deferred_log_task_handler, NEW_RECORD_BIT, eSetBits,
+        &higher_priority_task_woken);
+    }
+    else
+    {
+      xTaskNotify(deferred_log_task_handler, NEW_RECORD_BIT, eSetBits);
+    }
+  }
+
+  #endif
+}
+
+inline Deferred_log_return core_deferred_log_LOG(const Deferred_log_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define DEFERRED_LOG_RETURN(enumerate) \
+        case enumerate:                      \
+          if(ret > 0)                        \
+          {                                  \
+            ESP_LOGE(TAG, #enumerate);       \
+          }                                  \
+          else                               \
+          {                                  \
+            ESP_LOGI(TAG, #enumerate);       \
+          }                                  \
+          break;
+        DEFERRED_LOG_RETURNS
+      #undef DEFERRED_LOG_RETURN
+      default:
+        ESP_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+#if DEFERRED_LOG_TASK == 1
+static void deferred_log_func(void *args)
+{
+
+  log_record record;
+  char text[MAX_TEXT_LEN];
+  uint32_t notifications;
+
+  while(true)
+  {
+    /* The records stored before the task was created are printed first. */
+    uint32_t lost = 0u;
+    while(take_log_record(&record, &lost))
+    {
+      /* The text is a literal of the module, with one %d at most. */
+      snprintf(text, sizeof(text), record.text, record.arg);
+      if(record.level == DEFERRED_LOG_ERROR)
+      {
+        ESP_LOGE(record.tag, "[%u us] %s", (unsigned int)record.timestamp_us, text);
+      }
+      else
+      {
+        ESP_LOGI(record.tag, "[%u us] %s", (unsigned int)record.timestamp_us, text);
+      }
+    }
+
+    if(lost > 0u)
+    {
+      ESP_LOGE(TAG, "%u records were overwritten before they were printed.",
+        (unsigned int)lost);
+    }
+
+    /* Sleep until a producer stores a new record. */
+    xTaskNotifyWait(0u, UINT32_MAX, &notifications, portMAX_DELAY);
+  }
+
+  vTaskDelete(NULL);
+}
+
+static bool take_log_record(log_record *record, uint32_t *lost)
+{
+
+  while(true)
+  {
+    log_slot *slot = &log_ring[read_index & SLOT_MASK];
+    const uint32_t expected_seq = (2u*read_index) + 2u;
+
+    const uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if((int32_t)(seq - expected_seq) < 0)
+    {
+      /* The record is not complete yet. */
+      return false;
+    }
+
+    if(seq == expected_seq)
+    {
+      record->timestamp_us = atomic_load_explicit(&slot->timestamp_us,
+        memory_order_relaxed);
+      record->tag = atomic_load_explicit(&slot->tag, memory_order_relaxed);
+      record->text = atomic_load_explicit(&slot->text, memory_order_relaxed);
+      record->arg = atomic_load_explicit(&slot->arg, memory_order_relaxed);
+      record->level = (Deferred_log_level)atomic_load_explicit(&slot->level,
+        memory_order_relaxed);
+      atomic_thread_fence(memory_order_acquire);
+
+      /* If a producer did not overwrite it while it was copied, it is valid. */
+      if(atomic_load_explicit(&slot->seq, memory_order_relaxed) == expected_seq)
+      {
+        read_index++;
+        return true;
+      }
+    }
+
+    /* The producers went around the ring buffer, skip to the oldest record left. */
+    const uint32_t oldest_index = atomic_load_explicit(&write_index,
+      memory_order_relaxed) - DEFERRED_LOG_LEN;
+    if((int32_t)(oldest_index - read_index) > 0)
+    {
+      *lost += oldest_index - read_index;
+      read_index = oldest_index;
+    }
+    else
+    {
+      *lost += 1u;
+      read_index++;
+    }
+  }
+}
+#endif /* DEFERRED_LOG_TASK == 1 */
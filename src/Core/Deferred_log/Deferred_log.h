@@ -0,0 +1,115 @@
+/**
+ * @file      Deferred_log.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to print the traces of the core
+ *            modules out of the hot path. The traces are stored as compact records in
+ *            a lock-free ring buffer and a low priority task prints them.
+ */
+
+#ifndef CORE_DEFERRED_LOG_H_
+#define CORE_DEFERRED_LOG_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_log.h>
+#include <Debug.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module deferred log can return. */
+#define DEFERRED_LOG_RETURNS                                \
+  /* Info codes */                                          \
+  DEFERRED_LOG_RETURN(CORE_DEFERRED_LOG_OK)                 \
+  /* Error codes */                                         \
+  DEFERRED_LOG_RETURN(CORE_DEFERRED_LOG_INIT_TASK_ERR)
+
+/* Macros that the core modules use to print their traces. The text must be a string
+ * literal, the record only keeps its address. With an argument, the text can have
+ * one %d that is replaced by it when the record is printed.
+ */
+#if SYSTEM_DEFERRED_LOG == 1
+  #define CORE_LOGE(tag, text) deferred_log(DEFERRED_LOG_ERROR, tag, text, 0)
+  #define CORE_LOGI(tag, text) deferred_log(DEFERRED_LOG_INFO, tag, text, 0)
+  #define CORE_LOGE_ARG(tag, text, arg) \
+    deferred_log(DEFERRED_LOG_ERROR, tag, text, (int)(arg))
+  #define CORE_LOGI_ARG(tag, text, arg) \
+    deferred_log(DEFERRED_LOG_INFO, tag, text, (int)(arg))
+#else
+  #define CORE_LOGE(tag, text)          ESP_LOGE(tag, text)
+  #define CORE_LOGI(tag, text)          ESP_LOGI(tag, text)
+  #define CORE_LOGE_ARG(tag, text, arg) ESP_LOGE(tag, text, (int)(arg))
+  #define CORE_LOGI_ARG(tag, text, arg) ESP_LOGI(tag, text, (int)(arg))
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define DEFERRED_LOG_RETURN(enumerate) enumerate,
+    DEFERRED_LOG_RETURNS
+  #undef DEFERRED_LOG_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_DEFERRED_LOG_RETURNS,
+} Deferred_log_return;
+
+/* Enumerate that lists the levels of a record. */
+typedef enum
+{
+  DEFERRED_LOG_INFO,
+  DEFERRED_LOG_ERROR,
+} Deferred_log_level;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Creates the task that prints the records. The records stored before are
+ *        kept and printed once it runs. It can not be called from ISR.
+ *
+ * @param void
+ *
+ * @return CORE_DEFERRED_LOG_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_DEFERRED_LOG_INIT_TASK_ERR:
+ *               Error trying to create the task.
+ */
+Deferred_log_return init_deferred_log(void);
+
+/**
+ * @brief Stores a record in the ring buffer. It does not lock nor block, so it can be
+ *        called from any task or ISR. Use the CORE_LOG macros instead of calling it.
+ *
+ * @param level Level of the record.
+ *
+ * @param tag Tag of the module, it must be a string literal.
+ *
+ * @param text Text of the record, it must be a string literal.
+ *
+ * @param arg Value of the %d of the text, if it has one.
+ *
+ * @return void
+ */
+void deferred_log(const Deferred_log_level level, const char *tag, const char *text,
+  const int arg);
+
+/**
+ * @brief Prints the return of a deferred log module function if the system was
+ *        configured in debug mode. It prints it right away.
+ *
+ * @param ret Received return from a deferred log module function.
+ *
+ * @return The given return.
+ */
+Deferred_log_return core_deferred_log_LOG(const Deferred_log_return ret);
+
+#endif /* CORE_DEFERRED_LOG_H_ */
@@ -0,0 +1,510 @@
+/**
+ * @file      Latency.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to measure the time that a press
+ *            takes through every stage of the system, from button_CB to the write to
+ *            the gateway. It is only compiled with SYSTEM_LATENCY_TRACE.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Latency.h>
+
+#if SYSTEM_LATENCY_TRACE == 1
+
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <esp_timer.h>
+#include <stdatomic.h>
+
+#include <System_memory.h>
+#include <System_tasks.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  #include <TCP_client.h>
+  #include <esp_netif.h>
+  #include <lwip/sockets.h>
+#endif
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Number of buckets of every histogram. Bucket 0 counts the measures of 0 us and
+ * bucket n the ones in [2^(n-1), 2^n) us, the last one also counts the longer ones.
+ */
+#define NUM_OF_BUCKETS 26u
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  /* Key of the station network interface. */
+  #define STA_NETIF_KEY "WIFI_STA_DEF"
+
+  /* Time in ticks between two tries of the stress task while it can not send. */
+  #define STRESS_RETRY_TICKS pdMS_TO_TICKS(100u)
+#endif
+
+/* The reports are printed by a task of their own, only in debug mode. */
+#if LATENCY_REPORT_PRESSES > 0 && DEBUG_MODE_ENABLE == 1
+  #define LATENCY_REPORT_TASK 1
+#else
+  #define LATENCY_REPORT_TASK 0
+#endif
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core latency module. */
+  #define TAG "CORE_LATENCY"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Histogram of the measures of a stage. */
+typedef struct
+{
+  _Atomic uint32_t buckets[NUM_OF_BUCKETS];
+  _Atomic uint32_t count;
+  _Atomic uint32_t max_us;
+} latency_histogram;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Histogram of every stage, they are only updated with atomic operations. */
+static latency_histogram histograms[NUM_OF_LATENCY_STAGES];
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Name of every stage, for the reports. */
+  static const char *const stage_names[NUM_OF_LATENCY_STAGES] =
+  {
+    #define LATENCY_STAGE(enumerate) #enumerate,
+      LATENCY_STAGES
+    #undef LATENCY_STAGE
+  };
+#endif
+
+/* Time of the press that is being handled, 0 if there is not one. */
+static _Atomic uint32_t press_origin_us;
+
+#if LATENCY_REPORT_TASK == 1
+  /* Handler of the task that prints the reports. */
+  static TaskHandle_t report_task_handler;
+
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    /* Stack and control block of the report task. */
+    static StackType_t report_task_stack[LATENCY_REPORT_STACK_SIZE];
+    static StaticTask_t report_task_TCB;
+  #endif
+#endif
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  /* Handler of the task that loads the network while the latency is measured. */
+  static TaskHandle_t stress_task_handler;
+
+  /* Timer that wakes up the stress task every LATENCY_STRESS_PERIOD_MS. */
+  static esp_timer_handle_t stress_timer;
+
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    /* Stack and control block of the stress task. */
+    static StackType_t stress_task_stack[LATENCY_STRESS_STACK_SIZE];
+    static StaticTask_t stress_task_TCB;
+  #endif
+#endif
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Finds the bucket where a percentile of a histogram falls.
+ *
+ * @param histogram Histogram to read.
+ *
+ * @param count Number of measures of the histogram.
+ *
+ * @param perc Percentile to find, in terms of percentage.
+ *
+ * @return Upper bound in microseconds of the bucket of the percentile.
+ */
+static uint32_t find_percentile(const latency_histogram *histogram,
+  const uint32_t count, const uint32_t perc);
+
+#if LATENCY_REPORT_TASK == 1
+  /**
+   * @brief Function that will print the percentiles of every stage each time that a
+   *        report is requested.
+   *
+   * @param args arguments to pass to the function.
+   *
+   * @return void
+   */
+  static void latency_report_func(void *args);
+#endif
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  /**
+   * @brief Function that will send a datagram to the default gateway of the lease
+   *        every time that the stress timer expires, while the link is up.
+   *
+   * @param args arguments to pass to the function.
+   *
+   * @return void
+   */
+  static void stress_traffic_func(void *args);
+
+  /**
+   * @brief Callback of the stress timer, it wakes up the stress task.
+   *
+   * @param args arguments to pass to the function.
+   *
+   * @return void
+   */
+  static void stress_timer_CB(void *args);
+#endif
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+uint32_t latency_now(void)
+{
+
+  return (uint32_t)esp_timer_get_time();
+}
+
+void record_latency(const Latency_stage stage, const uint32_t start_us)
+{
+
+  if(stage >= NUM_OF_LATENCY_STAGES)
+  {
+    return;
+  }
+
+  /* The subtraction is right even if the time wrapped during the stage. */
+  const uint32_t elapsed_us = latency_now() - start_us;
+  latency_histogram *histogram = &histograms[stage];
+
+  uint32_t bucket = (elapsed_us == 0u) ? 0u : 32u - (uint32_t)__builtin_clz(elapsed_us);
+  if(bucket >= NUM_OF_BUCKETS)
+  {
+    bucket = NUM_OF_BUCKETS - 1u;
+  }
+  atomic_fetch_add_explicit(&histogram->buckets[bucket], 1u, memory_order_relaxed);
+  atomic_fetch_add_explicit(&histogram->count, 1u, memory_order_relaxed);
+
+  uint32_t max_us = atomic_load_explicit(&histogram->max_us, memory_order_relaxed);
+  while(elapsed_us > max_us &&
+        !atomic_compare_exchange_weak_explicit(&histogram->max_us, &max_us, elapsed_us,
+          memory_order_relaxed, memory_order_relaxed))
+  {
+  }
+}
+
+void set_latency_origin(const uint32_t origin_us)
+{
+
+  atomic_store_explicit(&press_origin_us, origin_us, memory_order_relaxed);
+}
+
+uint32_t latency_origin(void)
+{
+
+  const uint32_t origin_us = atomic_load_explicit(&press_origin_us, 
+    memory_order_relaxed);
+
+  return (origin_us != 0u) ? origin_us : latency_now();
+}
+
+void reset_latency_stats(void)
+{
+
+  for(uint32_t stage = 0u; stage < NUM_OF_LATENCY_STAGES; stage++)
+  {
+    latency_histogram *histogram = &histograms[stage];
+    for(uint32_t bucket = 0u; bucket < NUM_OF_BUCKETS; bucket++)
+    {
+      atomic_store_explicit(&histogram->buckets[bucket], 0u, memory_order_relaxed);
+    }
+    atomic_store_explicit(&histogram->count, 0u, memory_order_relaxed);
+    atomic_store_explicit(&histogram->max_us, 0u, memory_order_relaxed);
+  }
+}
+
+Latency_return get_latency_stats(const Latency_stage stage, Latency_stats *stats)
+{
+
+  if(stage >= NUM_OF_LATENCY_STAGES)
+  {
+    return CORE_LATENCY_INVALID_STAGE_ERR;
+  }
+
+  const latency_histogram *histogram = &histograms[stage];
+
+  /* The measures that arrive while reading only move the percentiles a bit. */
+  stats->count = atomic_load_explicit(&histogram->count, memory_order_relaxed);
+  stats->max_us = atomic_load_explicit(&histogram->max_us, memory_order_relaxed);
+  stats->p50_us = find_percentile(histogram, stats->count, 50u);
+  stats->p99_us = find_percentile(histogram, stats->count, 99u);
+
+  /* A percentile can not be above the longest measure. */
+  if(stats->p50_us > stats->max_us)
+  {
+    stats->p50_us = stats->max_us;
+  }
+  if(stats->p99_us > stats->max_us)
+  {
+    stats->p99_us = stats->max_us;
+  }
+
+  return CORE_LATENCY_OK;
+}
+
+void print_latency_stats(void)
+{
+
+  #if DEBUG_MODE_ENABLE == 1
+    Latency_stats stats;
+    for(uint32_t stage = 0u; stage < NUM_OF_LATENCY_STAGES; stage++)
+    {
+      if(get_latency_stats((Latency_stage)stage, &stats) == CORE_LATENCY_OK)
+      {
+        ESP_LOGI(TAG, "%s: n=%u p50<=%uus p99<=%uus max=%uus", stage_names[stage],
+          (unsigned int)stats.count, (unsigned int)stats.p50_us,
+          (unsigned int)stats.p99_us, (unsigned int)stats.max_us);
+      }
+    }
+  #endif
+}
+
+Latency_return start_latency_report(void)
+{
+
+  #if LATENCY_REPORT_TASK == 1
+    if(report_task_handler != NULL)
+    {
+      return CORE_LATENCY_OK;
+    }
+
+    #if SYSTEM_STATIC_ALLOCATION == 1
+      report_task_handler = xTaskCreateStaticPinnedToCore(latency_report_func,
+        "latency_report_func", LATENCY_REPORT_STACK_SIZE, (void *) 0,
+        (UBaseType_t)LATENCY_REPORT_TASK_PRIORITY, report_task_stack,
+        &report_task_TCB, LATENCY_REPORT_TASK_CORE);
+    #else
+      if(xTaskCreatePinnedToCore(latency_report_func, "latency_report_func",
+           LATENCY_REPORT_STACK_SIZE, (void *) 0,
+           (UBaseType_t)LATENCY_REPORT_TASK_PRIORITY, &report_task_handler,
+           LATENCY_REPORT_TASK_CORE) != pdPASS)
+      {
+        report_task_handler = NULL;
+      }
+    #endif
+    if(report_task_handler == NULL)
+    {
+      return CORE_LATENCY_INIT_REPORT_TASK_ERR;
+    }
+  #endif
+
+  return CORE_LATENCY_OK;
+}
+
+void request_latency_report(void)
+{
+
+  #if LATENCY_REPORT_TASK == 1
+    if(report_task_handler != NULL)
+    {
+      xTaskNotifyGive(report_task_handler);
+    }
+  #endif
+}
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  Latency_return start_stress_traffic(void)
+  {
+
+    if(stress_task_handler != NULL)
+    {
+      return CORE_LATENCY_OK;
+    }
+
+    /* A task delay can not be shorter than a tick, the timer keeps the period. */
+    if(stress_timer == NULL)
+    {
+      const esp_timer_create_args_t timer_args =
+      {
+        .callback = stress_timer_CB,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "latency_stress",
+      };
+      if(esp_timer_create(&timer_args, &stress_timer) != ESP_OK)
+      {
+        stress_timer = NULL;
+        return CORE_LATENCY_INIT_STRESS_TIMER_ERR;
+      }
+    }
+
+    #if SYSTEM_STATIC_ALLOCATION == 1
+      stress_task_handler = xTaskCreateStaticPinnedToCore(stress_traffic_func,
+        "stress_traffic_func", LATENCY_STRESS_STACK_SIZE, (void *) 0,
+        (UBaseType_t)STRESS_TASK_PRIORITY, stress_task_stack, &stress_task_TCB,
+        STRESS_TASK_CORE);
+    #else
+      if(xTaskCreatePinnedToCore(stress_traffic_func, "stress_traffic_func",
+           LATENCY_STRESS_STACK_SIZE, (void *) 0, (UBaseType_t)STRESS_TASK_PRIORITY,
+           &stress_task_handler, STRESS_TASK_CORE) != pdPASS)
+      {
+        stress_task_handler = NULL;
+      }
+    #endif
+    if(stress_task_handler == NULL)
+    {
+      return CORE_LATENCY_INIT_STRESS_TASK_ERR;
+    }
+
+    return CORE_LATENCY_OK;
+  }
+#endif
+
+inline Latency_return core_latency_LOG(const Latency_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define LATENCY_RETURN(enumerate) \
+        case enumerate:                 \
+          if(ret > 0)                   \
+          {                             \
+            CORE_LOGE(TAG, #enumerate); \
+          }                             \
+          else                          \
+          {                             \
+            CORE_LOGI(TAG, #enumerate); \
+          }                             \
+          break;
+        LATENCY_RETURNS
+      #undef LATENCY_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+static uint32_t find_percentile(const latency_histogram *histogram,
+  const uint32_t count, const uint32_t perc)
+{
+
+  if(count == 0u)
+  {
+    return 0u;
+  }
+
+  /* Rank of the percentile, rounded up. */
+  const uint64_t rank = (((uint64_t)count*perc) + 99u)/100u;
+  uint64_t seen = 0u;
+
+  for(uint32_t bucket = 0u; bucket < NUM_OF_BUCKETS; bucket++)
+  {
+    seen += atomic_load_explicit(&histogram->buckets[bucket], memory_order_relaxed);
+    if(seen >= rank)
+    {
+      return (bucket == 0u) ? 0u : (uint32_t)((1ull << bucket) - 1u);
+    }
+  }
+
+  return UINT32_MAX;
+}
+
+#if LATENCY_REPORT_TASK == 1
+  static void latency_report_func(void *args)
+  {
+
+    while(true)
+    {
+      /* The requests that arrive while printing are served by one single report. */
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      print_latency_stats();
+    }
+
+    vTaskDelete(NULL);
+  }
+#endif
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  static void stress_traffic_func(void *args)
+  {
+
+    static uint8_t datagram[LATENCY_STRESS_DATAGRAM_SIZE];
+
+    while(true)
+    {
+      /* The client can be started after the stress task. */
+      if(wait_for_connection(portMAX_DELAY) != CORE_TCP_CLIENT_OK)
+      {
+        vTaskDelay(STRESS_RETRY_TICKS);
+        continue;
+      }
+
+      esp_netif_t *esp_netif = esp_netif_get_handle_from_ifkey(STA_NETIF_KEY);
+      esp_netif_ip_info_t ip_info;
+      if(esp_netif == NULL || esp_netif_get_ip_info(esp_netif, &ip_info) != ESP_OK)
+      {
+        vTaskDelay(STRESS_RETRY_TICKS);
+        continue;
+      }
+
+      const int sock_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+      if(sock_fd < 0)
+      {
+        vTaskDelay(STRESS_RETRY_TICKS);
+        continue;
+      }
+
+      const struct sockaddr_in dest_addr =
+      {
+        .sin_family = AF_INET,
+        .sin_port = htons(LATENCY_STRESS_PORT),
+        .sin_addr.s_addr = ip_info.gw.addr,
+      };
+
+      /* The timer only runs while the task sends, a stale wake up is cleared. */
+      ulTaskNotifyTake(pdTRUE, 0u);
+      if(esp_timer_start_periodic(stress_timer,
+           (uint64_t)LATENCY_STRESS_PERIOD_MS*1000u) != ESP_OK)
+      {
+        close(sock_fd);
+        vTaskDelay(STRESS_RETRY_TICKS);
+        continue;
+      }
+
+      /* A full WiFi TX queue is expected, it is the load that is measured. */
+      while(wait_for_connection(0u) == CORE_TCP_CLIENT_OK)
+      {
+        sendto(sock_fd, datagram, sizeof(datagram), 0,
+          (const struct sockaddr *)&dest_addr, sizeof(dest_addr));
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      }
+
+      esp_timer_stop(stress_timer);
+      close(sock_fd);
+    }
+
+    vTaskDelete(NULL);
+  }
+
+  static void stress_timer_CB(void *args)
+  {
+
+    xTaskNotifyGive(stress_task_handler);
+  }
+#endif
+
+#endif /* SYSTEM_LATENCY_TRACE == 1 */
@@ -0,0 +1,247 @@
+/**
+ * @file      Latency.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to measure the time that a press
+ *            takes through every stage of the system, from button_CB to the write to
+ *            the gateway. It is only compiled with SYSTEM_LATENCY_TRACE.
+ */
+
+#ifndef CORE_LATENCY_H_
+#define CORE_LATENCY_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_latency.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module latency can return. */
+#define LATENCY_RETURNS                                    \
+  /* Info codes */                                         \
+  LATENCY_RETURN(CORE_LATENCY_OK)                          \
+  /* Error codes */                                        \
+  LATENCY_RETURN(CORE_LATENCY_INVALID_STAGE_ERR)           \
+  LATENCY_RETURN(CORE_LATENCY_INIT_REPORT_TASK_ERR)        \
+  LATENCY_RETURN(CORE_LATENCY_INIT_STRESS_TASK_ERR)        \
+  LATENCY_RETURN(CORE_LATENCY_INIT_STRESS_TIMER_ERR)
+
+/* Macro that enlist the measured stages. It is mandatory to not set values to the
+ * enumerates.
+ *
+ *   - LATENCY_PRESS_TO_DISPATCH:
+ *       From button_CB until the dispatcher takes the press.
+ *
+ *   - LATENCY_HANDLER:
+ *       Action of the press, including the enqueue of its commands.
+ *
+ *   - LATENCY_QUEUE_WAIT:
+ *       From the enqueue of a command until the TX task takes it.
+ *
+ *   - LATENCY_CONNECT:
+ *       connect() of a new socket, until the connection completes.
+ *
+ *   - LATENCY_WRITE:
+ *       write() of a batch, until it returns.
+ *
+ *   - LATENCY_TAKE_TO_WRITE:
+ *       From the TX task taking a batch until it is delivered, retries included.
+ *
+ *   - LATENCY_PRESS_TO_WRITE:
+ *       From button_CB until the batch that carries the first command of the press
+ *       is delivered, the whole path of the press inside the switch.
+ */
+#define LATENCY_STAGES                     \
+  LATENCY_STAGE(LATENCY_PRESS_TO_DISPATCH) \
+  LATENCY_STAGE(LATENCY_HANDLER)           \
+  LATENCY_STAGE(LATENCY_QUEUE_WAIT)        \
+  LATENCY_STAGE(LATENCY_CONNECT)           \
+  LATENCY_STAGE(LATENCY_WRITE)             \
+  LATENCY_STAGE(LATENCY_TAKE_TO_WRITE)     \
+  LATENCY_STAGE(LATENCY_PRESS_TO_WRITE)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define LATENCY_RETURN(enumerate) enumerate,
+    LATENCY_RETURNS
+  #undef LATENCY_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_LATENCY_RETURNS,
+} Latency_return;
+
+/* Enumerate that enlist the measured stages. */
+typedef enum
+{
+  #define LATENCY_STAGE(enumerate) enumerate,
+    LATENCY_STAGES
+  #undef LATENCY_STAGE
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_LATENCY_STAGES,
+} Latency_stage;
+
+/* Structure that contains the percentiles of a stage. The percentiles are the upper
+ * bound of their power of two bucket of the histogram, so the real percentile is
+ * between half of it and it. The reports print them as "p50<=".
+ */
+typedef struct
+{
+  /* Number of measures of the stage. */
+  uint32_t count;
+  /* Upper bound of the median in microseconds. */
+  uint32_t p50_us;
+  /* Upper bound of the 99th percentile in microseconds. */
+  uint32_t p99_us;
+  /* Longest measure in microseconds. */
+  uint32_t max_us;
+} Latency_stats;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Takes the current time, to measure a stage from it.
+ *
+ * @param void
+ *
+ * @return Microseconds since boot, it wraps every 71 minutes.
+ */
+uint32_t latency_now(void);
+
+/**
+ * @brief Adds a measure to the histogram of a stage. It does not lock, so it can be
+ *        called from any task or ISR.
+ *
+ * @param stage Measured stage.
+ *
+ * @param start_us Time when the stage started, taken with latency_now.
+ *
+ * @return void
+ */
+void record_latency(const Latency_stage stage, const uint32_t start_us);
+
+/**
+ * @brief Sets the time of the press that is being handled, the commands enqueued
+ *        until it is cleared are measured from it in LATENCY_PRESS_TO_WRITE. It is
+ *        set by the dispatcher around the handler of every press.
+ *
+ * @param origin_us Time when the press was reported, taken with latency_now. 0 clears
+ *                  it.
+ *
+ * @return void
+ */
+void set_latency_origin(const uint32_t origin_us);
+
+/**
+ * @brief Gets the time from which a command that is being enqueued is measured.
+ *
+ * @param void
+ *
+ * @return The time of the press that is being handled, or the current time if there
+ *         is not one.
+ */
+uint32_t latency_origin(void);
+
+/**
+ * @brief Empties the histograms of every stage, for example between two benchmark
+ *        runs. The measures recorded while it runs can be lost.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void reset_latency_stats(void);
+
+/**
+ * @brief Gets the percentiles of a stage.
+ *
+ * @param stage Stage to read.
+ *
+ * @param stats Where the percentiles are copied.
+ *
+ * @return CORE_LATENCY_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_LATENCY_INVALID_STAGE_ERR:
+ *               The given stage does not exist.
+ */
+Latency_return get_latency_stats(const Latency_stage stage, Latency_stats *stats);
+
+/**
+ * @brief Prints the percentiles of every stage if the system was configured in debug
+ *        mode. It prints synchronously, so it must not be called from a task that
+ *        handles the presses, see request_latency_report.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void print_latency_stats(void);
+
+/**
+ * @brief Creates the low priority task that prints the percentiles when a report is
+ *        requested. It is only created in debug mode with LATENCY_REPORT_PRESSES.
+ *
+ * @param void
+ *
+ * @return CORE_LATENCY_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_LATENCY_INIT_REPORT_TASK_ERR:
+ *               Error trying to create the report task.
+ */
+Latency_return start_latency_report(void);
+
+/**
+ * @brief Asks the report task to print the percentiles of every stage. It does not
+ *        block, the report is printed once the higher priority tasks are idle. It
+ *        does nothing if the report task was not started.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void request_latency_report(void);
+
+#if LATENCY_STRESS_TRAFFIC == 1
+  /**
+   * @brief Creates the task that sends a datagram to the default gateway of the lease
+   *        every LATENCY_STRESS_PERIOD_MS while the link is up. The period is kept by
+   *        an esp_timer, so it can be shorter than a tick. The task waits for the
+   *        client, so it can be called before the client is started.
+   *
+   * @param void
+   *
+   * @return CORE_LATENCY_OK if the operation went well,
+   *         otherwise:
+   *
+   *           - CORE_LATENCY_INIT_STRESS_TASK_ERR:
+   *               Error trying to create the stress task.
+   *
+   *           - CORE_LATENCY_INIT_STRESS_TIMER_ERR:
+   *               Error trying to create the timer of the stress period.
+   */
+  Latency_return start_stress_traffic(void);
+#endif
+
+/**
+ * @brief Prints the return of a latency module function if the system was configured
+ *        in debug mode.
+ *
+ * @param ret Received return from a latency module function.
+ *
+ * @return The given return.
+ */
+Latency_return core_latency_LOG(const Latency_return ret);
+
+#endif /* CORE_LATENCY_H_ */
@@ -0,0 +1,257 @@
+/**
+ * @file      Power.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to put the system in light sleep
+ *            while it is idle and to wake it up with the buttons.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Power.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+
+#if SYSTEM_LOW_POWER == 1
+  #include <Button_physical_connection.h>
+  #include <System_debounce.h>
+  #include <sdkconfig.h>
+  #include <esp_pm.h>
+  #include <esp_sleep.h>
+  #include <driver/gpio.h>
+  #include <stddef.h>
+#endif
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#if SYSTEM_LOW_POWER == 1
+  #if !defined(CONFIG_PM_ENABLE) || !defined(CONFIG_FREERTOS_USE_TICKLESS_IDLE)
+    #error "Low power mode needs the power management and tickless idle:"
+    #error "refer to (CONFIG_PM_ENABLE) and (CONFIG_FREERTOS_USE_TICKLESS_IDLE)"
+  #endif
+
+  #if !defined(CONFIG_PM_LIGHT_SLEEP_CALLBACKS)
+    #error "Low power mode needs the light sleep callbacks:"
+    #error "refer to (CONFIG_PM_LIGHT_SLEEP_CALLBACKS)"
+  #endif
+#endif
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core power module. */
+  #define TAG "CORE_POWER"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+#if SYSTEM_LOW_POWER == 1
+  /* Structure that describes how a button wakes up the CPU. */
+  typedef struct
+  {
+    /* GPIO that reads the button state. */
+    gpio_num_t GPIO;
+    /* Level of the GPIO that wakes up the CPU, the one of the pressed button. */
+    gpio_int_type_t wakeup_level;
+    /* Interruption mode of the button while the CPU is awake, the debounce engine
+     * takes both edges.
+     */
+    gpio_int_type_t intr_type;
+  } button_wakeup;
+#endif
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+#if SYSTEM_LOW_POWER == 1
+  /* Wake up source of every button, a pulled down button reads a high level while
+   * pressed.
+   */
+  static const button_wakeup button_wakeups[NUM_OF_BUTTONS] =
+  {
+    #define BUTTON_CONFIG(button_ID, GPIO_num, pull_mode, intr, debounce)  \
+      [button_ID] =                                                        \
+      {                                                                    \
+        .GPIO = GPIO_num,                                                  \
+        .wakeup_level = (pull_mode == GPIO_PULLUP_ONLY) ?                  \
+          GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL,                      \
+        .intr_type = (SYSTEM_DEBOUNCE_ENGINE == 1) ?                       \
+          GPIO_INTR_ANYEDGE : intr,                                        \
+      },
+      BUTTONS_CONFIGURATIONS
+    #undef BUTTON_CONFIG
+  };
+
+  /* Lock that keeps the CPU awake and at its maximum frequency. */
+  static esp_pm_lock_handle_t awake_lock;
+#endif
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+#if SYSTEM_LOW_POWER == 1
+  /**
+   * @brief Arms the wake up level of the buttons before the CPU enters light sleep.
+   *        The GPIO wake up only works with levels, so it replaces the interruption
+   *        mode of the buttons while the CPU sleeps. A held button is armed with its
+   *        released level, so its release wakes up the CPU.
+   *
+   * @param sleep_time_us Expected time of the light sleep.
+   *
+   * @param arg Not used.
+   *
+   * @return ESP_OK always, the light sleep is never cancelled.
+   */
+  static esp_err_t enter_light_sleep_CB(int64_t sleep_time_us, void *arg);
+
+  /**
+   * @brief Restores the interruption mode of the buttons after a light sleep. The
+   *        interruption of the level that woke up the CPU is still pending, so the
+   *        press or the release reaches the button ISR.
+   *
+   * @param sleep_time_us Time that the CPU slept.
+   *
+   * @param arg Not used.
+   *
+   * @return ESP_OK always.
+   */
+  static esp_err_t exit_light_sleep_CB(int64_t sleep_time_us, void *arg);
+#endif
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Power_return init_power(void)
+{
+
+  #if SYSTEM_LOW_POWER == 1
+
+    /* The lock lives as long as the system, it is only created once. */
+    if(awake_lock != NULL)
+    {
+      return CORE_POWER_OK;
+    }
+
+    if(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "awake", &awake_lock) != ESP_OK)
+    {
+      awake_lock = NULL;
+      return CORE_POWER_INIT_LOCK_ERR;
+    }
+
+    esp_pm_sleep_cbs_register_config_t sleep_CBs =
+    {
+      .enter_cb = enter_light_sleep_CB,
+      .exit_cb = exit_light_sleep_CB,
+    };
+    if(esp_pm_light_sleep_register_cbs(&sleep_CBs) != ESP_OK ||
+       esp_sleep_enable_gpio_wakeup() != ESP_OK)
+    {
+      return CORE_POWER_INIT_WAKEUP_ERR;
+    }
+
+    /* From now on, the CPU sleeps whenever FreeRTOS has nothing to run. */
+    const esp_pm_config_t config =
+    {
+      .max_freq_mhz = POWER_MAX_CPU_FREQ_MHZ,
+      .min_freq_mhz = POWER_MIN_CPU_FREQ_MHZ,
+      .light_sleep_enable = true,
+    };
+    if(esp_pm_configure(&config) != ESP_OK)
+    {
+      return CORE_POWER_INIT_PM_ERR;
+    }
+
+  #endif
+
+  return CORE_POWER_OK;
+}
+
+void keep_CPU_awake(void)
+{
+
+  #if SYSTEM_LOW_POWER == 1
+    if(awake_lock != NULL)
+    {
+      esp_pm_lock_acquire(awake_lock);
+    }
+  #endif
+}
+
+void let_CPU_sleep(void)
+{
+
+  #if SYSTEM_LOW_POWER == 1
+    if(awake_lock != NULL)
+    {
+      esp_pm_lock_release(awake_lock);
+    }
+  #endif
+}
+
+inline Power_return core_power_LOG(const Power_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define POWER_RETURN(enumerate)   \
+        case enumerate:                 \
+          if(ret > 0)                   \
+          {                             \
+            CORE_LOGE(TAG, #enumerate); \
+          }                             \
+          else                          \
+          {                             \
+            CORE_LOGI(TAG, #enumerate); \
+          }                             \
+          break;
+        POWER_RETURNS
+      #undef POWER_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+#if SYSTEM_LOW_POWER == 1
+  static esp_err_t enter_light_sleep_CB(int64_t sleep_time_us, void *arg)
+  {
+
+    for(uint32_t button = 0u; button < NUM_OF_BUTTONS; button++)
+    {
+      /* A held button would wake up the CPU right away with its pressed level, so
+       * it is armed with the released one. Its release wakes up the CPU, and the
+       * next light sleep arms its press again.
+       */
+      const gpio_int_type_t pressed_level = button_wakeups[button].wakeup_level;
+      const gpio_int_type_t released_level = (pressed_level == GPIO_INTR_HIGH_LEVEL) ?
+        GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL;
+      const bool is_held = gpio_get_level(button_wakeups[button].GPIO) ==
+        ((pressed_level == GPIO_INTR_HIGH_LEVEL) ? 1 : 0);
+      gpio_wakeup_enable(button_wakeups[button].GPIO,
+        is_held ? released_level : pressed_level);
+    }
+
+    return ESP_OK;
+  }
+
+  static esp_err_t exit_light_sleep_CB(int64_t sleep_time_us, void *arg)
+  {
+
+    for(uint32_t button = 0u; button < NUM_OF_BUTTONS; button++)
+    {
+      gpio_wakeup_disable(button_wakeups[button].GPIO);
+      gpio_set_intr_type(button_wakeups[button].GPIO, button_wakeups[button].intr_type);
+    }
+
+    return ESP_OK;
+  }
+#endif
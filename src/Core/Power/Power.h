@@ -0,0 +1,99 @@
+/**
+ * @file      Power.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to put the system in light sleep
+ *            while it is idle and to wake it up with the buttons.
+ */
+
+#ifndef CORE_POWER_H_
+#define CORE_POWER_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_power.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module power can return. */
+#define POWER_RETURNS                                       \
+  /* Info codes */                                          \
+  POWER_RETURN(CORE_POWER_OK)                               \
+  /* Error codes */                                         \
+  POWER_RETURN(CORE_POWER_INIT_LOCK_ERR)                    \
+  POWER_RETURN(CORE_POWER_INIT_WAKEUP_ERR)                  \
+  POWER_RETURN(CORE_POWER_INIT_PM_ERR)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define POWER_RETURN(enumerate) enumerate,
+    POWER_RETURNS
+  #undef POWER_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_POWER_RETURNS,
+} Power_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Registers the buttons of BUTTONS_CONFIGURATIONS as wake up sources and lets
+ *        the CPU enter light sleep when FreeRTOS is idle. It does nothing if
+ *        SYSTEM_LOW_POWER is 0.
+ *
+ * @param void
+ *
+ * @return CORE_POWER_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_POWER_INIT_LOCK_ERR:
+ *               Error trying to create the lock that keeps the CPU awake.
+ *
+ *           - CORE_POWER_INIT_WAKEUP_ERR:
+ *               Error trying to register the buttons as wake up sources.
+ *
+ *           - CORE_POWER_INIT_PM_ERR:
+ *               Error trying to configure the power management.
+ */
+Power_return init_power(void);
+
+/**
+ * @brief Keeps the CPU awake and at POWER_MAX_CPU_FREQ_MHZ until let_CPU_sleep is
+ *        called the same number of times. It can not be called from ISR.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void keep_CPU_awake(void);
+
+/**
+ * @brief Releases a keep_CPU_awake call.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void let_CPU_sleep(void);
+
+/**
+ * @brief Prints the return of a power module function if the system was configured
+ *        in debug mode.
+ *
+ * @param ret Received return from a power module function.
+ *
+ * @return The given return.
+ */
+Power_return core_power_LOG(const Power_return ret);
+
+#endif /* CORE_POWER_H_ */
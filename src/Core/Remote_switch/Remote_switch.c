@@ -11,13 +11,48 @@
  ***************************************************************************************/
 #include <Remote_switch.h>
 #include <freertos/FreeRTOS.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
 #include <Debug.h>
+#include <Deferred_log.h>
 #include <TCP_client.h>
+#include <System_network.h>
+#include <System_lights.h>
+#include <System_scenes.h>
+#include <System_actions.h>
+#include <System_tasks.h>
+#include <Latency.h>
+#include <Telemetry.h>
+#include <System_bench.h>
+#include <Power.h>
+#include <Debounce.h>
 
 /***************************************************************************************
  * Defines
  ***************************************************************************************/
 
+/* Maximum time in ticks that a press waits for room in the TX queue. A stalled
+ * network must not freeze the remote switch tasks.
+ */
+#define MAX_TIME_TO_ENQUEUE pdMS_TO_TICKS(20u)
+
+/* Number of press events that can wait to be dispatched. */
+#define BUTTON_EVENTS_LEN 16u
+
+/* Stack size in bytes of the dispatcher task. Its high water mark is collected in
+ * TELEMETRY_DISPATCHER_STACK_LOW_WATER, check it after changing the handlers.
+ */
+#define DISPATCHER_STACK_SIZE 2048u
+
+/* Bit of the notification value of the dispatcher that asks for a state snapshot, the
+ * lower bits are the buttons.
+ */
+#define SNAPSHOT_NOTIFY_BIT ((uint32_t)1u << 31)
+
+/* Time in ticks between two duty cycle updates of a held HOLD_DIM_ACTION button. */
+#define HOLD_DIM_PERIOD_TICKS \
+  ((pdMS_TO_TICKS(1000u/HOLD_DIM_RATE_HZ) > 0u) ? pdMS_TO_TICKS(1000u/HOLD_DIM_RATE_HZ) : 1u)
+
 #if DEBUG_MODE_ENABLE == 1
 /* Tag to show traces in button BSP module. */
 #define TAG "CORE_REMOTE_SWITCH"
@@ -32,14 +67,71 @@ typedef struct
 {
   /* Identifier of button that belongs to the remote swtich. */
   Button_ID button;
-  /* Handler of the task that will perform an action when the button is pressed. */
-  TaskHandle_t task_handler;
-  /* Semaphore to coordinate the ISR interruption from the button with the remote 
-   * switch task. 
-   */
-  SemaphoreHandle_t semaphore;
+  /* Indicates if the remote switch was initialized. */
+  bool initialized;
+  /* Number of presses reported by the button since the system started. */
+  uint32_t num_of_presses;
 } remote_switch_info;
 
+/* Structure that describes a press or a release of a button. */
+typedef struct
+{
+  /* Identifier of the button. */
+  Button_ID button;
+  /* BUTTON_IS_PRESSED for a press, BUTTON_IS_NOT_PRESSED for a release. */
+  Button_state state;
+  /* Time in microseconds since boot when the edge was reported. */
+  int64_t timestamp;
+  /* Number of presses of the button, this one included. */
+  uint32_t press_count;
+} button_event;
+
+/* Structure that describes what a button does when it is pressed. */
+typedef struct
+{
+  /* Action of the button. */
+  Action_ID action;
+  /* LED or scene over which the action is done. */
+  uint32_t target;
+} button_action;
+
+/* Structure that describes how to read if a button is held. */
+typedef struct
+{
+  /* GPIO that reads the button state. */
+  gpio_num_t GPIO;
+  /* Level of the GPIO while the button is pressed. */
+  int pressed_level;
+} button_input;
+
+/* Function that does an action over its target. */
+typedef void (*action_handler)(const button_event *event, const uint32_t target);
+
+/* Structure that describes a command of a scene. */
+typedef struct
+{
+  /* Scene that sends the command. */
+  Scene_ID scene;
+  /* Command to send. */
+  TCP_COMMAND_TYPE cmd;
+} scene_target;
+
+/* Ring buffer where the button callbacks store the edges until the dispatcher handles
+ * them.
+ */
+typedef struct
+{
+  button_event events[BUTTON_EVENTS_LEN];
+  /* Index of the next event to dispatch. */
+  uint32_t head;
+  /* Number of events waiting to be dispatched. */
+  uint32_t count;
+  /* Number of presses lost because the ring buffer was full. */
+  uint32_t lost;
+  /* Spinlock to ensure atomicity between the ISR and the dispatcher. */
+  portMUX_TYPE lock;
+} button_events_ring;
+
 /***************************************************************************************
  * Global Variables
  ***************************************************************************************/
@@ -47,21 +139,310 @@ typedef struct
 /* Array that contains the configuration of the all the system lamps. */
 static remote_switch_info remote_switches_infos[NUM_OF_BUTTONS];
 
-/* Variable that stored which was the last pressed button. */
-static Button_ID pressed_button;
+/* Presses waiting to be dispatched, in the order they happened. */
+static button_events_ring button_events = 
+{
+  .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+/* Handler of the task that dispatches the presses of all the buttons. */
+static TaskHandle_t dispatcher_task_handler;
+
+/* Stack and control block of the dispatcher task, its RAM cost does not depend on the
+ * number of buttons.
+ */
+static StackType_t dispatcher_stack[DISPATCHER_STACK_SIZE];
+static StaticTask_t dispatcher_TCB;
+
+/* The dispatcher is notified with a bit per button in the notification value, the
+ * last bit is SNAPSHOT_NOTIFY_BIT.
+ */
+_Static_assert(NUM_OF_BUTTONS < 32, "The dispatcher can not notify more than 31 buttons");
+
+/* Number of remote switches that are initialized. */
+static uint32_t num_of_initialized_switches;
+
+/* Targets of all the scenes, in the order of SCENES_TARGETS. */
+static const scene_target scene_targets[] =
+{
+  #define SCENE_TARGET(scene_ID, LED, LED_action, duty_cycle) \
+    {                                                         \
+      .scene = scene_ID,                                      \
+      .cmd =                                                  \
+      {                                                       \
+        .ID = LED,                                            \
+        .action = LED_action,                                 \
+        .pwm = duty_cycle,                                    \
+      },                                                      \
+    },
+    SCENES_TARGETS
+  #undef SCENE_TARGET
+};
+
+/* Number of targets of all the scenes. */
+#define NUM_OF_SCENE_TARGETS (sizeof(scene_targets)/sizeof(scene_targets[0]))
+
+/* Action of every button, the buttons not listed in BUTTON_ACTIONS keep NO_ACTION. */
+static const button_action button_actions[NUM_OF_BUTTONS] =
+{
+  #define BUTTON_ACTION(button_ID, action_ID, target_ID) \
+    [button_ID] =                                        \
+    {                                                    \
+      .action = action_ID,                               \
+      .target = (uint32_t)target_ID,                     \
+    },
+    BUTTON_ACTIONS
+  #undef BUTTON_ACTION
+};
+
+/* Duty cycle of every PWM step and step that follows each one, so a press only looks
+ * them up. The steps beyond NUM_OF_PWM_STEPS are never reached.
+ */
+#define DUTY_CYCLE_OF_STEP(step) \
+  (((step) < NUM_OF_PWM_STEPS) ? MIN_DUTY_CYCLE_PERC + ((step)*PWM_STEP_PERC) : \
+    MIN_DUTY_CYCLE_PERC)
+#define NEXT_PWM_STEP(step) (((step) + 1u < NUM_OF_PWM_STEPS) ? (step) + 1u : 0u)
+#define PWM_STEPS                                                               \
+  PWM_STEP(0u) PWM_STEP(1u) PWM_STEP(2u) PWM_STEP(3u) PWM_STEP(4u) PWM_STEP(5u) \
+  PWM_STEP(6u) PWM_STEP(7u) PWM_STEP(8u) PWM_STEP(9u) PWM_STEP(10u)
+
+static const uint8_t duty_cycles_LUT[MAX_NUM_OF_PWM_STEPS] =
+{
+  #define PWM_STEP(step) DUTY_CYCLE_OF_STEP(step),
+    PWM_STEPS
+  #undef PWM_STEP
+};
+
+static const uint8_t next_PWM_steps_LUT[MAX_NUM_OF_PWM_STEPS] =
+{
+  #define PWM_STEP(step) NEXT_PWM_STEP(step),
+    PWM_STEPS
+  #undef PWM_STEP
+};
+
+/* Current PWM step of every button, only the dispatcher accesses it. */
+static uint8_t PWM_steps[NUM_OF_BUTTONS];
+
+/* Inputs of the buttons, a pulled down button reads a high level while pressed. */
+static const button_input button_inputs[NUM_OF_BUTTONS] =
+{
+  #define BUTTON_CONFIG(button_ID, GPIO_num, pull_mode, intr_type, debounce) \
+    [button_ID] =                                                            \
+    {                                                                        \
+      .GPIO = GPIO_num,                                                      \
+      .pressed_level = (pull_mode == GPIO_PULLUP_ONLY) ? 0 : 1,              \
+    },
+    BUTTONS_CONFIGURATIONS
+  #undef BUTTON_CONFIG
+};
+
+/* Number of buttons bound to HOLD_DIM_ACTION. */
+enum
+{
+  NUM_OF_HOLD_DIM_BUTTONS = 0
+  #define BUTTON_ACTION(button_ID, action_ID, target_ID) \
+    + ((action_ID) == HOLD_DIM_ACTION)
+    BUTTON_ACTIONS
+  #undef BUTTON_ACTION
+};
+
+/* A stream of duty cycles needs a connection that does not open a socket per frame
+ * and that only keeps the newest duty cycle of a LED.
+ */
+_Static_assert(NUM_OF_HOLD_DIM_BUTTONS == 0 || 
+  ((TCP_CLIENT_CONNECTION_MODE == TCP_CLIENT_PERSISTENT_CONNECTION || 
+    TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP) && TCP_CLIENT_COALESCE_PWM == 1),
+  "HOLD_DIM_ACTION needs the persistent connection or UDP, and TCP_CLIENT_COALESCE_PWM");
+
+/* Buttons bound to HOLD_DIM_ACTION that are held, a bit per button. Only the
+ * dispatcher accesses it.
+ */
+static uint32_t held_buttons;
+
+/* Direction of the ramp of every HOLD_DIM_ACTION button, true to increase the duty
+ * cycle. Only the dispatcher accesses it.
+ */
+static bool hold_dims_up[NUM_OF_BUTTONS];
+
+/* Tick of the last duty cycle update of the held buttons. */
+static TickType_t last_hold_dim_tick;
+
+/* Last state that the switch enqueued for every LED, only the dispatcher accesses it.
+ * It starts with every LED off, but that is only a guess, other switches can share the
+ * LEDs. The duty cycle starts at the maximum, so the first step of a STEP_PWM_ACTION
+ * button is a change.
+ */
+static Frame_state_record LED_shadows[NUM_OF_LEDS] =
+{
+  #define LED(LED_ID)                \
+    [LED_ID] =                       \
+    {                                \
+      .ID = LED_ID,                  \
+      .on = false,                   \
+      .pwm = MAX_DUTY_CYCLE_PERC,    \
+    },
+    LEDS
+  #undef LED
+};
+
+/* Indicates the LEDs whose state the switch enqueued since the boot. Only their state
+ * goes in the snapshots, so a snapshot never overrides the LEDs that the switch did
+ * not touch. Only the dispatcher accesses it.
+ */
+static bool LED_was_changed[NUM_OF_LEDS];
 
 /***************************************************************************************
  * Functions Prototypes
  ***************************************************************************************/
 
 /**
- * @brief Function that will handle the action when the button of the remote switch
+ * @brief Function that will dispatch the presses of the buttons, in the order they
+ *        happened, to the remote switch handler.
  *
  * @param args arguments to pass to the function.
  *
  * @return void
  */
-static void remote_switch_handler_func(void *args);
+static void remote_switch_dispatcher_func(void *args);
+
+/**
+ * @brief Function that will handle the action when the button of the remote switch
+ *        is pressed.
+ *
+ * @param event Press to handle.
+ *
+ * @return void
+ */
+static void remote_switch_handler_func(const button_event *event);
+
+/**
+ * @brief Actions that a button can do, see ACTIONS in System_actions.h
+ *
+ * @param event Press to handle.
+ *
+ * @param target LED or scene over which the action is done.
+ *
+ * @return void
+ */
+static void no_action(const button_event *event, const uint32_t target);
+static void toggle_LED_action(const button_event *event, const uint32_t target);
+static void step_PWM_action(const button_event *event, const uint32_t target);
+static void scene_action(const button_event *event, const uint32_t target);
+static void hold_dim_action(const button_event *event, const uint32_t target);
+
+/**
+ * @brief Sends the next duty cycle of every held HOLD_DIM_ACTION button, and stops
+ *        the buttons that were released.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void stream_hold_dims(void);
+
+/**
+ * @brief Moves the duty cycle of the target LED of a held button one step along its
+ *        ramp, and sends it if it changes.
+ *
+ * @param button Identifier of the held button.
+ *
+ * @return void
+ */
+static void step_hold_dim(const Button_ID button);
+
+/**
+ * @brief Ends the ramp of a released HOLD_DIM_ACTION button, its next hold goes the
+ *        other way. It does nothing if the ramp already ended.
+ *
+ * @param button Identifier of the released button.
+ *
+ * @return void
+ */
+static void end_hold_dim(const Button_ID button);
+
+/**
+ * @brief Sends all the targets of a scene in the same frame.
+ *
+ * @param scene Identifier of the scene to send.
+ *
+ * @return void
+ */
+static void send_scene(const Scene_ID scene);
+
+/**
+ * @brief Checks if a command changes the shadow state of its LED, without applying
+ *        it.
+ *
+ * @param cmd Command to check.
+ *
+ * @return True if the command changes the state of the LED and must be sent,
+ *         otherwise false.
+ */
+static bool changes_LED_shadow(const TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Applies a command that was enqueued to the shadow state of its LED.
+ *
+ * @param cmd Command to apply.
+ *
+ * @return void
+ */
+static void update_LED_shadow(const TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Sends a command if it changes the state of its LED, and applies it to the
+ *        shadow state once it is enqueued.
+ *
+ * @param cmd Command to send.
+ *
+ * @param time_to_wait Maximum time in ticks to wait for room in the TX queue.
+ *
+ * @return void
+ */
+static void send_LED_cmd(const TCP_COMMAND_TYPE *cmd, const TickType_t time_to_wait);
+
+/**
+ * @brief Checks if a return of the TCP client means that the commands were enqueued.
+ *
+ * @param ret Return of try_send_message or try_send_messages.
+ *
+ * @return True if the commands were enqueued, otherwise false.
+ */
+static bool was_enqueued(const TCP_client_return ret);
+
+/**
+ * @brief Sends the shadow state of the LEDs that the switch changed since the boot, so
+ *        the gateway recovers the commands that it missed while the link was down.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void send_LED_snapshot(void);
+
+/**
+ * @brief Stores an edge of a button at the end of the ring buffer and notifies the
+ *        dispatcher. It can be called from a task or from an ISR.
+ *
+ * @param ID Identifier of the button.
+ *
+ * @param state BUTTON_IS_PRESSED for a press, BUTTON_IS_NOT_PRESSED for a release.
+ *
+ * @param timestamp Time in microseconds since boot of the edge.
+ *
+ * @return void
+ */
+static void push_button_event(const Button_ID ID, const Button_state state,
+  const int64_t timestamp);
+
+/**
+ * @brief Takes the oldest edge from the ring buffer.
+ *
+ * @param event Where the edge is copied.
+ *
+ * @return True if there was an edge to take, otherwise false.
+ */
+static bool pop_button_event(button_event *event);
 
 /***************************************************************************************
  * Functions
@@ -70,33 +451,47 @@ static void remote_switch_handler_func(void *args);
 Remote_switch_return init_remote_switch(const Button_ID ID)
 {
 
-  /* Initialize button. */
-  if(init_button(ID) != BSP_BUTTON_OK)
+  if(ID >= NUM_OF_BUTTONS)
   {
     return CORE_REMOTE_SWITCH_INIT_ERR;
   }
 
-  /* Initialize Semaphore. Create first sempahore to void start task and try to
-   * acquire an initialized semaphore.
+  /* The dispatcher serves all the buttons, create it with the first remote switch. 
+   * It must exist before the button can report presses.
    */
-  remote_switches_infos[ID].semaphore = xSemaphoreCreateCounting(1, 0);
-  if(remote_switches_infos[ID].semaphore == NULL)
+  if(dispatcher_task_handler == NULL)
   {
-    vSemaphoreDelete(remote_switches_infos[ID].semaphore);
-    return CORE_REMOTE_SWITCH_INIT_ERR;
+    dispatcher_task_handler = xTaskCreateStaticPinnedToCore(
+      remote_switch_dispatcher_func, "remote_switch_dispatcher_func",
+      DISPATCHER_STACK_SIZE, (void *) 0, DISPATCHER_TASK_PRIORITY, dispatcher_stack,
+      &dispatcher_TCB, DISPATCHER_TASK_CORE);
+    if(dispatcher_task_handler == NULL)
+    {
+      return CORE_REMOTE_SWITCH_INIT_ERR;
+    }
   }
 
-  /* Initialize remote switch task. */
-  const BaseType_t task_create_ret = xTaskCreate(remote_switch_handler_func, 
-    "remote_switch_handler_func", 2048, (void *) 0, configMAX_PRIORITIES-1, 
-    &remote_switches_infos[ID].task_handler);
-  if(task_create_ret != pdPASS)
-  {
-    if(remote_switches_infos[ID].task_handler != NULL)
+  remote_switches_infos[ID].button = ID;
+  remote_switches_infos[ID].num_of_presses = 0u;
+  PWM_steps[ID] = 0u;
+
+  /* Initialize button. */
+  #if SYSTEM_DEBOUNCE_ENGINE == 1
+    if(core_debounce_LOG(init_debounce(ID)) != CORE_DEBOUNCE_OK)
     {
-      vTaskDelete(remote_switches_infos[ID].task_handler);
-    } 
-    return CORE_REMOTE_SWITCH_INIT_ERR;
+      return CORE_REMOTE_SWITCH_INIT_ERR;
+    }
+  #else
+    if(init_button(ID) != BSP_BUTTON_OK)
+    {
+      return CORE_REMOTE_SWITCH_INIT_ERR;
+    }
+  #endif
+
+  if(!remote_switches_infos[ID].initialized)
+  {
+    remote_switches_infos[ID].initialized = true;
+    num_of_initialized_switches++;
   }
 
   return CORE_REMOTE_SWITCH_OK;
@@ -105,19 +500,38 @@ Remote_switch_return init_remote_switch(const Button_ID ID)
 Remote_switch_return de_init_remote_switch(const Button_ID ID)
 {
 
-  /* De-initialize button. */
-  const Button_return but_ret = de_init_button(ID);
-  if(but_ret != BSP_BUTTON_OK)
+  if(ID >= NUM_OF_BUTTONS)
   {
-    BPS_button_LOG(but_ret);
     return CORE_REMOTE_SWITCH_DE_INIT_ERR;
   }
 
-  if(remote_switches_infos[ID].task_handler != NULL)
+  /* De-initialize button. */
+  #if SYSTEM_DEBOUNCE_ENGINE == 1
+    if(core_debounce_LOG(de_init_debounce(ID)) != CORE_DEBOUNCE_OK)
+    {
+      return CORE_REMOTE_SWITCH_DE_INIT_ERR;
+    }
+  #else
+    const Button_return but_ret = de_init_button(ID);
+    if(but_ret != BSP_BUTTON_OK)
+    {
+      BPS_button_LOG(but_ret);
+      return CORE_REMOTE_SWITCH_DE_INIT_ERR;
+    }
+  #endif
+
+  if(remote_switches_infos[ID].initialized)
+  {
+    remote_switches_infos[ID].initialized = false;
+    num_of_initialized_switches--;
+  }
+
+  /* The last remote switch also stops the dispatcher. */
+  if(num_of_initialized_switches == 0u && dispatcher_task_handler != NULL)
   {
-    vTaskDelete(remote_switches_infos[ID].task_handler);
+    vTaskDelete(dispatcher_task_handler);
+    dispatcher_task_handler = NULL;
   }
-  vSemaphoreDelete(remote_switches_infos[ID].semaphore);
 
   if(core_TCP_client_LOG(de_init_TCP_client()) != CORE_TCP_CLIENT_OK)
   {
@@ -160,17 +574,17 @@ inline Remote_switch_return core_remote_switch_LOG(const Remote_switch_return re
         case enumerate:                       \
           if(ret > 0)                         \
           {                                   \
-            ESP_LOGE(TAG, #enumerate);        \
+            CORE_LOGE(TAG, #enumerate);       \
           }                                   \
           else                                \
           {                                   \
-            ESP_LOGI(TAG, #enumerate);        \
+            CORE_LOGI(TAG, #enumerate);       \
           }                                   \
           break;       
         REMOTE_SWITCH_RETURNS
       #undef REMOTE_SWITCH_RETURN
       default:
-        ESP_LOGE(TAG, "Unkown return.");
+        CORE_LOGE(TAG, "Unkown return.");
         break;
     }
   #endif
@@ -180,58 +594,480 @@ inline Remote_switch_return core_remote_switch_LOG(const Remote_switch_return re
 /* Implemtation of the button callback. */
 void __attribute__((weak)) button_CB(const Button_ID ID)
 {
-  pressed_button = ID;
 
-  BaseType_t higher_priority_task_woken = pdFALSE;
-  xSemaphoreGiveFromISR(remote_switches_infos[BUTTON_0].semaphore, 
-    &higher_priority_task_woken);  
+  push_button_event(ID, BUTTON_IS_PRESSED, esp_timer_get_time());
 }
 
-static void remote_switch_handler_func(void *args)
+/* Implemtation of the debounce callback. */
+void __attribute__((weak)) debounce_CB(const Button_ID ID, const Button_state state,
+  const int64_t timestamp)
 {
 
-  TCP_COMMAND_TYPE cmd;
+  push_button_event(ID, state, timestamp);
+}
+
+/* Implemtation of the delivery callback. */
+void __attribute__((weak)) TCP_client_delivery_CB(const TCP_COMMAND_TYPE cmd, 
+  const TCP_client_return result)
+{
+
+  #if DEBUG_MODE_ENABLE == 1
+    if(result != CORE_TCP_CLIENT_OK)
+    {
+      CORE_LOGE_ARG(TAG, "Command for LED %d was not delivered.", cmd.ID);
+    }
+  #endif
+}
+
+/* Implemtation of the link up callback. */
+void __attribute__((weak)) TCP_client_link_up_CB(void)
+{
+
+  /* The dispatcher owns the shadow state, it sends the snapshot. */
+  if(dispatcher_task_handler != NULL)
+  {
+    xTaskNotify(dispatcher_task_handler, SNAPSHOT_NOTIFY_BIT, eSetBits);
+  }
+}
+
+static void remote_switch_dispatcher_func(void *args)
+{
+
+  button_event event;
+  uint32_t pending_buttons;
+
+  /* The benchmark mode prints its own reports, between the runs. */
+  #if SYSTEM_LATENCY_TRACE == 1 && LATENCY_REPORT_PRESSES > 0 && SYSTEM_BENCH_MODE == 0
+    uint32_t presses_since_report = 0u;
+  #endif
 
   while(true)
   {
-    if(xSemaphoreTake(remote_switches_infos[BUTTON_0].semaphore, 
-         portMAX_DELAY) == pdTRUE)
+    /* Wait for new presses. The notification value only tells which buttons were 
+     * pressed, the ring buffer keeps every press and their order, so it is drained
+     * completely on each wake up.
+     */
+    TickType_t time_to_wait = portMAX_DELAY;
+    if(held_buttons != 0u)
     {
-      switch(pressed_button)
-      {
-        case BUTTON_0:
-          cmd.ID = LED_0;
-          cmd.action = TOOGLE_LED;
-          break;
-        case BUTTON_1:
+      /* While a button is held, also wake up for the next update of its ramp. */
+      const TickType_t elapsed = xTaskGetTickCount() - last_hold_dim_tick;
+      time_to_wait = (elapsed < HOLD_DIM_PERIOD_TICKS) ? 
+        HOLD_DIM_PERIOD_TICKS - elapsed : 0u;
+    }
+    pending_buttons = 0u;
+    xTaskNotifyWait(0u, UINT32_MAX, &pending_buttons, time_to_wait);
+
+    /* The presses are handled at the maximum frequency of the CPU. */
+    keep_CPU_awake();
 
-          cmd.ID = LED_0;
-          cmd.action = SET_PWM;
+    /* The presses handled after the snapshot are sent on top of it. */
+    if((pending_buttons & SNAPSHOT_NOTIFY_BIT) != 0u)
+    {
+      send_LED_snapshot();
+    }
 
-          uint64_t num_of_presses = 0u;
-          get_num_of_presses(BUTTON_1, &num_of_presses);
+    while(pop_button_event(&event))
+    {
+      #if SYSTEM_TELEMETRY == 1
+        count_telemetry(TELEMETRY_BUTTON_EVENTS);
+      #endif
 
-          /* Per each press, increment in 10 points the duty cycle. */
-          cmd.pwm = ((num_of_presses%9)*10u) + MIN_DUTY_CYCLE_PERC;
+      #if SYSTEM_LATENCY_TRACE == 1
+        /* The press timestamp is taken in button_CB, with the same clock. */
+        record_latency(LATENCY_PRESS_TO_DISPATCH, (uint32_t)event.timestamp);
+        const uint32_t handler_start_us = latency_now();
+        /* The commands of the press are measured from button_CB until written. */
+        set_latency_origin((uint32_t)event.timestamp);
+      #endif
 
-          /* If the value is higher than 100%, return to 0%. */
-          if(cmd.pwm > MAX_DUTY_CYCLE_PERC)
+      remote_switch_handler_func(&event);
+
+      #if SYSTEM_LATENCY_TRACE == 1
+        set_latency_origin(0u);
+        record_latency(LATENCY_HANDLER, handler_start_us);
+        #if LATENCY_REPORT_PRESSES > 0 && SYSTEM_BENCH_MODE == 0
+          if(++presses_since_report >= LATENCY_REPORT_PRESSES)
           {
-            cmd.pwm = MIN_DUTY_CYCLE_PERC;
+            presses_since_report = 0u;
+            request_latency_report();
           }
-        default:
-          /* TODO: Handle this corner case. */
-          break;
-      }
+        #endif
+      #endif
+    }
 
-      core_TCP_client_LOG(send_message(cmd));
-      
+    if(held_buttons != 0u && 
+       xTaskGetTickCount() - last_hold_dim_tick >= HOLD_DIM_PERIOD_TICKS)
+    {
+      last_hold_dim_tick = xTaskGetTickCount();
+      stream_hold_dims();
     }
 
+    let_CPU_sleep();
+
+    #if SYSTEM_TELEMETRY == 1
+      sample_telemetry(TELEMETRY_DISPATCHER_STACK_LOW_WATER, 
+        (uint32_t)uxTaskGetStackHighWaterMark(NULL));
+    #endif
   }
 
   vTaskDelete(NULL);
 }
 
+static void push_button_event(const Button_ID ID, const Button_state state,
+  const int64_t timestamp)
+{
+
+  if(ID >= NUM_OF_BUTTONS)
+  {
+    return;
+  }
+
+  bool stored = false;
+
+  /* Store the edge at the end of the ring buffer, it is shared with the dispatcher
+   * and the ISRs of the other buttons.
+   */
+  portENTER_CRITICAL_SAFE(&button_events.lock);
+  if(state == BUTTON_IS_PRESSED)
+  {
+    remote_switches_infos[ID].num_of_presses++;
+  }
+  if(button_events.count < BUTTON_EVENTS_LEN)
+  {
+    button_event *event = &button_events.events[(button_events.head + 
+      button_events.count) % BUTTON_EVENTS_LEN];
+    event->button = ID;
+    event->state = state;
+    event->timestamp = timestamp;
+    event->press_count = remote_switches_infos[ID].num_of_presses;
+    button_events.count++;
+    stored = true;
+  }
+  else
+  {
+    button_events.lost++;
+  }
+  portEXIT_CRITICAL_SAFE(&button_events.lock);
+
+  #if SYSTEM_TELEMETRY == 1
+    if(!stored)
+    {
+      count_telemetry(TELEMETRY_BUTTON_EVENTS_LOST);
+    }
+  #endif
+
+  /* Mark the button as pending in the notification value of the dispatcher. */
+  if(stored && dispatcher_task_handler != NULL)
+  {
+    if(xPortInIsrContext())
+    {
+      BaseType_t higher_priority_task_woken = pdFALSE;
+      xTaskNotifyFromISR(dispatcher_task_handler, (uint32_t)1u << ID, eSetBits,
+        &higher_priority_task_woken);
+      portYIELD_FROM_ISR(higher_priority_task_woken);
+    }
+    else
+    {
+      xTaskNotify(dispatcher_task_handler, (uint32_t)1u << ID, eSetBits);
+    }
+  }
+}
+
+static bool pop_button_event(button_event *event)
+{
+
+  bool popped = false;
+
+  portENTER_CRITICAL(&button_events.lock);
+  if(button_events.count > 0u)
+  {
+    *event = button_events.events[button_events.head];
+    button_events.head = (button_events.head + 1u) % BUTTON_EVENTS_LEN;
+    button_events.count--;
+    popped = true;
+  }
+  portEXIT_CRITICAL(&button_events.lock);
+
+  return popped;
+}
+
+static void remote_switch_handler_func(const button_event *event)
+{
+
+  /* Handlers of the actions, indexed by ACTIONS. */
+  static const action_handler action_handlers[NUM_OF_ACTIONS] =
+  {
+    [NO_ACTION] = no_action,
+    [TOGGLE_LED_ACTION] = toggle_LED_action,
+    [STEP_PWM_ACTION] = step_PWM_action,
+    [SCENE_ACTION] = scene_action,
+    [HOLD_DIM_ACTION] = hold_dim_action,
+  };
+
+  /* Only the ramps care about the releases, the actions are done with the press. */
+  if(event->state == BUTTON_IS_NOT_PRESSED)
+  {
+    end_hold_dim(event->button);
+    return;
+  }
+
+  const button_action *action = &button_actions[event->button];
+  action_handlers[action->action](event, action->target);
+}
+
+static void no_action(const button_event *event, const uint32_t target)
+{
+}
+
+static void toggle_LED_action(const button_event *event, const uint32_t target)
+{
+
+  const TCP_COMMAND_TYPE cmd =
+  {
+    .ID = (LED_ID)target,
+    .action = TOOGLE_LED,
+  };
+
+  send_LED_cmd(&cmd, MAX_TIME_TO_ENQUEUE);
+}
+
+static void step_PWM_action(const button_event *event, const uint32_t target)
+{
+
+  /* Go to the next duty cycle, after the last one it returns to the first. */
+  uint8_t *step = &PWM_steps[event->button];
+  const TCP_COMMAND_TYPE cmd =
+  {
+    .ID = (LED_ID)target,
+    .action = SET_PWM,
+    .pwm = duty_cycles_LUT[*step],
+  };
+  *step = next_PWM_steps_LUT[*step];
+
+  /* Another button could have set the same duty cycle already. */
+  send_LED_cmd(&cmd, MAX_TIME_TO_ENQUEUE);
+}
+
+static void scene_action(const button_event *event, const uint32_t target)
+{
+
+  send_scene((Scene_ID)target);
+}
+
+static void hold_dim_action(const button_event *event, const uint32_t target)
+{
+
+  const uint32_t button_bit = (uint32_t)1u << event->button;
+  if(target >= NUM_OF_LEDS || (held_buttons & button_bit) != 0u)
+  {
+    return;
+  }
+
+  /* At the end of the range, the ramp can only go back. */
+  const uint8_t pwm = LED_shadows[target].pwm;
+  if(pwm >= MAX_DUTY_CYCLE_PERC)
+  {
+    hold_dims_up[event->button] = false;
+  }
+  else if(pwm <= MIN_DUTY_CYCLE_PERC)
+  {
+    hold_dims_up[event->button] = true;
+  }
+
+  /* The first update goes out with the press, the next ones with the period. */
+  if(held_buttons == 0u)
+  {
+    last_hold_dim_tick = xTaskGetTickCount();
+  }
+  held_buttons |= button_bit;
+  step_hold_dim(event->button);
+}
+
+static void stream_hold_dims(void)
+{
+
+  for(Button_ID button = 0u; button < NUM_OF_BUTTONS; button++)
+  {
+    const uint32_t button_bit = (uint32_t)1u << button;
+    if((held_buttons & button_bit) == 0u)
+    {
+      continue;
+    }
+
+    /* The release edge can come after the poll, the first one ends the ramp. */
+    if(gpio_get_level(button_inputs[button].GPIO) != button_inputs[button].pressed_level)
+    {
+      end_hold_dim(button);
+      continue;
+    }
+
+    step_hold_dim(button);
+  }
+}
+
+static void step_hold_dim(const Button_ID button)
+{
+
+  const LED_ID LED = (LED_ID)button_actions[button].target;
+  const uint8_t pwm = LED_shadows[LED].pwm;
+  uint8_t next_pwm;
+
+  if(hold_dims_up[button])
+  {
+    next_pwm = (pwm + HOLD_DIM_STEP_PERC < MAX_DUTY_CYCLE_PERC) ? 
+      pwm + HOLD_DIM_STEP_PERC : MAX_DUTY_CYCLE_PERC;
+  }
+  else
+  {
+    next_pwm = (pwm > MIN_DUTY_CYCLE_PERC + HOLD_DIM_STEP_PERC) ? 
+      pwm - HOLD_DIM_STEP_PERC : MIN_DUTY_CYCLE_PERC;
+  }
+
+  const TCP_COMMAND_TYPE cmd =
+  {
+    .ID = LED,
+    .action = SET_PWM,
+    .pwm = next_pwm,
+  };
+
+  /* At the end of the range the duty cycle does not change and nothing is sent. The
+   * update replaces the pending one of the LED, the stream never waits.
+   */
+  send_LED_cmd(&cmd, 0u);
+}
+
+static void end_hold_dim(const Button_ID button)
+{
+
+  const uint32_t button_bit = (uint32_t)1u << button;
+  if((held_buttons & button_bit) == 0u)
+  {
+    return;
+  }
+
+  held_buttons &= ~button_bit;
+  hold_dims_up[button] = !hold_dims_up[button];
+}
+
+static void send_scene(const Scene_ID scene)
+{
+
+  TCP_COMMAND_TYPE cmds[NUM_OF_SCENE_TARGETS];
+  size_t num_of_cmds = 0u;
+
+  for(size_t i = 0u; i < NUM_OF_SCENE_TARGETS; i++)
+  {
+    /* Only the targets that change their LED are sent. */
+    if(scene_targets[i].scene == scene && changes_LED_shadow(&scene_targets[i].cmd))
+    {
+      cmds[num_of_cmds] = scene_targets[i].cmd;
+      num_of_cmds++;
+    }
+  }
+
+  if(num_of_cmds == 0u)
+  {
+    return;
+  }
+
+  /* The group is enqueued whole or not at all. */
+  if(was_enqueued(core_TCP_client_LOG(try_send_messages(cmds, num_of_cmds, 
+       MAX_TIME_TO_ENQUEUE, TCP_CLIENT_DROP_OLDEST))))
+  {
+    for(size_t i = 0u; i < num_of_cmds; i++)
+    {
+      update_LED_shadow(&cmds[i]);
+    }
+  }
+}
+
+static bool changes_LED_shadow(const TCP_COMMAND_TYPE *cmd)
+{
+
+  /* A LED without shadow state can not be compared, it is always sent. */
+  if(cmd->ID >= NUM_OF_LEDS)
+  {
+    return true;
+  }
+
+  switch(cmd->action)
+  {
+    case SET_PWM:
+      return (LED_shadows[cmd->ID].pwm != cmd->pwm);
+    default:
+      return true;
+  }
+}
+
+static void update_LED_shadow(const TCP_COMMAND_TYPE *cmd)
+{
+
+  if(cmd->ID >= NUM_OF_LEDS)
+  {
+    return;
+  }
+
+  Frame_state_record *shadow = &LED_shadows[cmd->ID];
+  switch(cmd->action)
+  {
+    case TOOGLE_LED:
+      shadow->on = !shadow->on;
+      break;
+    case SET_PWM:
+      shadow->pwm = cmd->pwm;
+      break;
+    default:
+      break;
+  }
+  LED_was_changed[cmd->ID] = true;
+}
+
+static void send_LED_cmd(const TCP_COMMAND_TYPE *cmd, const TickType_t time_to_wait)
+{
+
+  if(!changes_LED_shadow(cmd))
+  {
+    return;
+  }
+
+  if(was_enqueued(core_TCP_client_LOG(try_send_message(*cmd, time_to_wait, 
+       TCP_CLIENT_DROP_OLDEST))))
+  {
+    update_LED_shadow(cmd);
+  }
+}
+
+static bool was_enqueued(const TCP_client_return ret)
+{
+
+  /* With DROPPED_OLDEST_WARN the given commands were enqueued, an older one was not. */
+  return (ret == CORE_TCP_CLIENT_OK || ret == CORE_TCP_CLIENT_DROPPED_OLDEST_WARN);
+}
 
+static void send_LED_snapshot(void)
+{
 
+  #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+    Frame_state_record states[NUM_OF_LEDS];
+    size_t num_of_states = 0u;
+
+    for(size_t LED = 0u; LED < NUM_OF_LEDS; LED++)
+    {
+      if(LED_was_changed[LED])
+      {
+        states[num_of_states] = LED_shadows[LED];
+        num_of_states++;
+      }
+    }
+
+    /* Before the first change there is nothing that the gateway could have missed. */
+    if(num_of_states == 0u)
+    {
+      return;
+    }
+
+    core_TCP_client_LOG(send_state_snapshot(states, num_of_states, 
+      MAX_TIME_TO_ENQUEUE, TCP_CLIENT_DROP_OLDEST));
+  #endif
+}
@@ -0,0 +1,97 @@
+/**
+ * @file      System_actions.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to define what every button does when it is
+ *            pressed.
+ */
+
+#ifndef SYSTEM_ACTIONS_H_
+#define SYSTEM_ACTIONS_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Macro that enlist the actions that a button can do. It is mandatory to not set
+ * values to the enumerates and to keep NO_ACTION the first one.
+ *
+ *   - NO_ACTION:
+ *       The press is ignored, it is the action of the buttons not listed in
+ *       BUTTON_ACTIONS.
+ *
+ *   - TOGGLE_LED_ACTION:
+ *       Toggles the target LED.
+ *
+ *   - STEP_PWM_ACTION:
+ *       Increases the duty cycle of the target LED in PWM_STEP_PERC points per press,
+ *       after MAX_DUTY_CYCLE_PERC it returns to MIN_DUTY_CYCLE_PERC -> System_lights.h
+ *
+ *   - SCENE_ACTION:
+ *       Sends the target scene -> System_scenes.h
+ *
+ *   - HOLD_DIM_ACTION:
+ *       While the button is held, the duty cycle of the target LED ramps between
+ *       MIN_DUTY_CYCLE_PERC and MAX_DUTY_CYCLE_PERC at HOLD_DIM_RATE_HZ updates per
+ *       second, every hold ramps the other way. A new hold is only seen after the
+ *       debounce time of the button -> Button_physical_connection.h. It needs the
+ *       persistent connection or the UDP transport and TCP_CLIENT_COALESCE_PWM, so
+ *       only the newest duty cycle is sent -> System_network.h
+ */
+#define ACTIONS                \
+  ACTION(NO_ACTION)            \
+  ACTION(TOGGLE_LED_ACTION)    \
+  ACTION(STEP_PWM_ACTION)      \
+  ACTION(SCENE_ACTION)         \
+  ACTION(HOLD_DIM_ACTION)
+
+/* Macro that binds the buttons to their actions.
+ *
+ * Parameters:
+ *
+ *   1) Identifier of the button, it is mandatory to put a value defined inside
+ *      BUTTONS -> Button_physical_connection.h
+ *   2) Action of the button, it is mandatory to put a value defined inside ACTIONS.
+ *   3) Target of the action, a value defined inside LEDS -> System_lights.h for the
+ *      LED actions or inside SCENES -> System_scenes.h for SCENE_ACTION.
+ */
+#define BUTTON_ACTIONS                                 \
+  BUTTON_ACTION(BUTTON_0, TOGGLE_LED_ACTION, LED_0)    \
+  BUTTON_ACTION(BUTTON_1, STEP_PWM_ACTION, LED_0)
+
+/* Number of duty cycle updates per second that a held HOLD_DIM_ACTION button sends. */
+#define HOLD_DIM_RATE_HZ 25u
+
+/* Points of duty cycle that every update of a held HOLD_DIM_ACTION button adds or
+ * removes.
+ */
+#define HOLD_DIM_STEP_PERC 2u
+
+/* Checks if the hold dim rate has a valid value. */
+#if HOLD_DIM_RATE_HZ == 0 || HOLD_DIM_RATE_HZ > 50
+  #error "Invalid hold dim rate: [1-50]:"
+  #error "refer to (HOLD_DIM_RATE_HZ)"
+#endif
+
+/* Checks if the hold dim step has a valid value. */
+#if HOLD_DIM_STEP_PERC == 0 || HOLD_DIM_STEP_PERC > 100
+  #error "Invalid hold dim step: [1-100]:"
+  #error "refer to (HOLD_DIM_STEP_PERC)"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that enlist the actions that a button can do. */
+typedef enum
+{
+  #define ACTION(enumerate) enumerate,
+    ACTIONS
+  #undef ACTION
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_ACTIONS,
+} Action_ID;
+
+#endif /* SYSTEM_ACTIONS_H_ */
@@ -0,0 +1,84 @@
+/**
+ * @file      System_bench.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure the benchmark mode, that injects
+ *            synthetic presses in button_CB and reports how the system carries them.
+ */
+
+#ifndef SYSTEM_BENCH_H_
+#define SYSTEM_BENCH_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_latency.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, a task runs every benchmark of BENCH_RUNS once the link is up and prints a
+ * report of each one. It needs SYSTEM_LATENCY_TRACE and the debug mode. The real
+ * buttons keep working, do not press them during the runs.
+ */
+#ifndef SYSTEM_BENCH_MODE
+  #define SYSTEM_BENCH_MODE 0
+#endif
+
+/* Macro that describes the benchmark runs, they are run in the listed order. Every
+ * press of a TOGGLE_LED_ACTION button sends exactly one command, so those buttons
+ * give the drop count at the gateway. The SET_PWM commands can be coalesced, and
+ * HOLD_DIM_ACTION buttons never get the release, do not use them in the runs.
+ *
+ * Parameters:
+ *
+ *   1) Presses per second of every button, [1-100].
+ *   2) Number of presses of every button that are injected back to back, then the
+ *      run waits the time of the whole burst.
+ *   3) Buttons pressed at the same time, a bit per Button_ID ->
+ *      Button_physical_connection.h
+ *   4) Number of presses of every button in the run.
+ */
+#define BENCH_RUNS                                  \
+  BENCH_RUN(1u,   1u,  (1u << BUTTON_0), 10u)       \
+  BENCH_RUN(10u,  1u,  (1u << BUTTON_0), 100u)      \
+  BENCH_RUN(100u, 1u,  (1u << BUTTON_0), 500u)      \
+  BENCH_RUN(10u,  10u, (1u << BUTTON_0), 100u)      \
+  BENCH_RUN(50u,  1u,  (1u << BUTTON_0) |           \
+    (1u << BUTTON_1), 250u)
+
+/* Time in milliseconds that the first run waits after the link is up, so the first
+ * snapshot and the connection are not measured.
+ */
+#define BENCH_START_DELAY_MS 3000u
+
+/* Time in milliseconds that every run waits after its last press, so the TX task
+ * delivers the queued commands before the report. The host gateway ends its own run
+ * after a shorter silence.
+ */
+#define BENCH_SETTLE_MS 2000u
+
+/* Stack size in bytes of the benchmark task, its core and priority are in
+ * System_tasks.h
+ */
+#define BENCH_STACK_SIZE 2048u
+
+/* Checks if the benchmark configuration has valid values. */
+#if SYSTEM_BENCH_MODE != 0 && SYSTEM_BENCH_MODE != 1
+  #error "Invalid benchmark mode option: [0-1]:"
+  #error "refer to (SYSTEM_BENCH_MODE)"
+#endif
+
+#if SYSTEM_BENCH_MODE == 1 && SYSTEM_LATENCY_TRACE == 0
+  #error "The benchmark mode reports the latency measures:"
+  #error "refer to (SYSTEM_BENCH_MODE) and (SYSTEM_LATENCY_TRACE)"
+#endif
+
+#if BENCH_SETTLE_MS == 0
+  #error "Invalid benchmark settle time: it must be at least 1 millisecond:"
+  #error "refer to (BENCH_SETTLE_MS)"
+#endif
+
+#endif /* SYSTEM_BENCH_H_ */
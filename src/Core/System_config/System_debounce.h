@@ -0,0 +1,41 @@
+/**
+ * @file      System_debounce.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure how the presses and releases of
+ *            the buttons are debounced.
+ */
+
+#ifndef SYSTEM_DEBOUNCE_H_
+#define SYSTEM_DEBOUNCE_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, the core debounce engine reads the buttons instead of the Button driver. The
+ * first edge of a press or of a release is reported right away, then the GPIO is
+ * sampled with an esp_timer and integrated for the debounce time of the button in
+ * BUTTONS_CONFIGURATIONS before it can report the next one. If 0, the Button driver
+ * reports the presses with its own debounce.
+ */
+#ifndef SYSTEM_DEBOUNCE_ENGINE
+  #define SYSTEM_DEBOUNCE_ENGINE 1
+#endif
+
+/* Time in microseconds between two samples of a button that is being debounced. */
+#define DEBOUNCE_SAMPLE_PERIOD_US 1000u
+
+/* Checks if the debounce configuration has valid values. */
+#if SYSTEM_DEBOUNCE_ENGINE != 0 && SYSTEM_DEBOUNCE_ENGINE != 1
+  #error "Invalid debounce engine option: [0-1]:"
+  #error "refer to (SYSTEM_DEBOUNCE_ENGINE)"
+#endif
+
+#if DEBOUNCE_SAMPLE_PERIOD_US < 100u || DEBOUNCE_SAMPLE_PERIOD_US > 10000u
+  #error "Invalid debounce sample period: [100-10000] microseconds:"
+  #error "refer to (DEBOUNCE_SAMPLE_PERIOD_US)"
+#endif
+
+#endif /* SYSTEM_DEBOUNCE_H_ */
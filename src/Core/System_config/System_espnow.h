@@ -0,0 +1,120 @@
+/**
+ * @file      System_espnow.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure the ESP-NOW peers that receive
+ *            the frames when the system was configured with the ESP-NOW transport,
+ *            see TCP_CLIENT_TRANSPORT -> System_network.h
+ */
+
+#ifndef SYSTEM_ESPNOW_H_
+#define SYSTEM_ESPNOW_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+/* The keys are defined there, out of version control as WIFI_PASS. */
+#include <Network_config.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Macro that describes the peers that receive every frame, for example the fixtures
+ * or the gateway. It is mandatory to not set values to the enumerates.
+ *
+ * Parameters:
+ *
+ *   1) Identifier of the peer.
+ *   2) MAC of the peer, in the "xx:xx:xx:xx:xx:xx" format.
+ *   3) Local master key of the peer, 16 characters, defined in Network_config.h. It
+ *      is only used with ESPNOW_ENCRYPT, an empty string leaves the peer unencrypted.
+ */
+#define ESPNOW_PEERS                                                  \
+  ESPNOW_PEER(ESPNOW_PEER_0, "24:0a:c4:00:00:01", ESPNOW_PEER_0_LMK)
+
+/* Local master key of ESPNOW_PEER_0, unencrypted unless Network_config.h defines it. */
+#ifndef ESPNOW_PEER_0_LMK
+  #define ESPNOW_PEER_0_LMK ""
+#endif
+
+/* If 1, the frames to the peers with a local master key are encrypted. */
+#ifndef ESPNOW_ENCRYPT
+  #define ESPNOW_ENCRYPT 0
+#endif
+
+/* Primary master key of the switch, 16 characters. It encrypts the local master
+ * keys of the peers. It has no default, with ESPNOW_ENCRYPT it must be defined in
+ * Network_config.h.
+ */
+
+/* If 1, the station also associates with the access point as usual, so the IP
+ * network keeps working alongside ESP-NOW. The frames are then sent in the channel of
+ * the access point, the peers must listen to it. If 0, the station never associates
+ * and the frames are sent in ESPNOW_CHANNEL.
+ */
+#ifndef ESPNOW_WITH_STATION
+  #define ESPNOW_WITH_STATION 0
+#endif
+
+/* WiFi channel of the peers when the station does not associate. */
+#ifndef ESPNOW_CHANNEL
+  #define ESPNOW_CHANNEL 1u
+#endif
+
+/* Maximum time in milliseconds to wait for the MAC acks of an attempt. The peers
+ * that miss it receive the frame again after a backoff, up to
+ * TCP_CLIENT_MAX_SEND_ATTEMPTS times -> System_network.h.
+ */
+#define ESPNOW_ACK_TIME_OUT_MS 20u
+
+/* Length of the keys, fixed by ESP-NOW. */
+#define ESPNOW_KEY_LEN 16u
+
+/* Maximum number of peers, fixed by ESP-NOW. The encrypted ones are limited by the
+ * menuconfig, see CONFIG_ESP_WIFI_ESPNOW_MAX_ENCRYPT_NUM.
+ */
+#define ESPNOW_MAX_PEERS 20u
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that enlist the ESP-NOW peers. */
+typedef enum
+{
+  #define ESPNOW_PEER(enumerate, MAC, LMK) enumerate,
+    ESPNOW_PEERS
+  #undef ESPNOW_PEER
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_ESPNOW_PEERS,
+} Espnow_peer_ID;
+
+/* Checks if the ESP-NOW configuration has valid values. */
+#if ESPNOW_ENCRYPT != 0 && ESPNOW_ENCRYPT != 1
+  #error "Invalid ESP-NOW encryption option: [0-1]:"
+  #error "refer to (ESPNOW_ENCRYPT)"
+#endif
+
+#if ESPNOW_ENCRYPT == 1 && !defined(ESPNOW_PMK)
+  #error "ESP-NOW encryption needs a primary master key in Network_config.h:"
+  #error "refer to (ESPNOW_PMK)"
+#endif
+
+#if ESPNOW_WITH_STATION != 0 && ESPNOW_WITH_STATION != 1
+  #error "Invalid ESP-NOW station option: [0-1]:"
+  #error "refer to (ESPNOW_WITH_STATION)"
+#endif
+
+#if ESPNOW_CHANNEL < 1 || ESPNOW_CHANNEL > 14
+  #error "Invalid ESP-NOW channel: [1-14]:"
+  #error "refer to (ESPNOW_CHANNEL)"
+#endif
+
+#if ESPNOW_ACK_TIME_OUT_MS == 0
+  #error "Invalid ESP-NOW ack time out: it must be at least 1 millisecond:"
+  #error "refer to (ESPNOW_ACK_TIME_OUT_MS)"
+#endif
+
+#endif /* SYSTEM_ESPNOW_H_ */
@@ -0,0 +1,72 @@
+/**
+ * @file      System_latency.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure the measure of the time that a
+ *            press takes through every stage of the system.
+ */
+
+#ifndef SYSTEM_LATENCY_H_
+#define SYSTEM_LATENCY_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, the time that every press takes in every stage, from button_CB to the write
+ * to the gateway, is kept in a histogram per stage. If 0, the measures are compiled
+ * out.
+ */
+#ifndef SYSTEM_LATENCY_TRACE
+  #define SYSTEM_LATENCY_TRACE 0
+#endif
+
+/* Number of presses between two reports of the latency percentiles. The dispatcher
+ * only wakes up a low priority task that prints them, so the report does not stall
+ * the presses. The reports are only printed in debug mode. 0 disables the reports.
+ */
+#define LATENCY_REPORT_PRESSES 32u
+
+/* Stack size in bytes of the task that prints the reports. */
+#define LATENCY_REPORT_STACK_SIZE 3072u
+
+/* If 1, a task of the latency module sends UDP datagrams to the default gateway of
+ * the lease while the link is up, to measure the latency of the presses under heavy
+ * WiFi traffic. The datagrams go to the discard port, the gateway drops them.
+ */
+#ifndef LATENCY_STRESS_TRAFFIC
+  #define LATENCY_STRESS_TRAFFIC 0
+#endif
+
+/* Size in bytes of every stress datagram, time in milliseconds between two of them,
+ * destination port and stack size in bytes of the stress task. The period is kept
+ * by an esp_timer, so it can be shorter than a tick.
+ */
+#define LATENCY_STRESS_DATAGRAM_SIZE 1024u
+#define LATENCY_STRESS_PERIOD_MS     2u
+#define LATENCY_STRESS_PORT          9u
+#define LATENCY_STRESS_STACK_SIZE    2048u
+
+/* Checks if the latency configuration has valid values. */
+#if SYSTEM_LATENCY_TRACE != 0 && SYSTEM_LATENCY_TRACE != 1
+  #error "Invalid latency trace option: [0-1]:"
+  #error "refer to (SYSTEM_LATENCY_TRACE)"
+#endif
+
+#if LATENCY_STRESS_TRAFFIC != 0 && LATENCY_STRESS_TRAFFIC != 1
+  #error "Invalid latency stress traffic option: [0-1]:"
+  #error "refer to (LATENCY_STRESS_TRAFFIC)"
+#endif
+
+#if LATENCY_STRESS_TRAFFIC == 1 && SYSTEM_LATENCY_TRACE == 0
+  #error "The stress traffic is only useful while the latency is measured:"
+  #error "refer to (LATENCY_STRESS_TRAFFIC) and (SYSTEM_LATENCY_TRACE)"
+#endif
+
+#if LATENCY_STRESS_PERIOD_MS == 0
+  #error "Invalid latency stress period: it must be at least 1 millisecond:"
+  #error "refer to (LATENCY_STRESS_PERIOD_MS)"
+#endif
+
+#endif /* SYSTEM_LATENCY_H_ */
@@ -25,6 +25,15 @@
 #define MAX_DUTY_CYCLE_PERC 100u
 #define MIN_DUTY_CYCLE_PERC 20u
 
+/* Points of duty cycle that every press of a STEP_PWM_ACTION button adds. */
+#define PWM_STEP_PERC 10u
+
+/* Number of duty cycles that a STEP_PWM_ACTION button goes through, and maximum
+ * number of them that the lookup tables can hold.
+ */
+#define NUM_OF_PWM_STEPS     (((MAX_DUTY_CYCLE_PERC - MIN_DUTY_CYCLE_PERC)/PWM_STEP_PERC) + 1u)
+#define MAX_NUM_OF_PWM_STEPS 11u
+
 /* Checks if the MIN_DUTY_CYCLE_PERCENTAGE and MIN_DUTY_CYCLE_PERCENTAGE have a 
  * valid value. 
  */
@@ -32,6 +41,12 @@
   #error "Invalid PWM duty cycle: [0-100]:"
   #error "refer to (MAX_DUTY_CYCLE_PERCENTAGE, MIN_DUTY_CYCLE_PERCENTAGE)"
 #endif
+
+/* Checks if the PWM step has a valid value. */
+#if PWM_STEP_PERC == 0 || NUM_OF_PWM_STEPS > MAX_NUM_OF_PWM_STEPS
+  #error "Invalid PWM step: (MAX - MIN)/STEP must not be higher than 10:"
+  #error "refer to (PWM_STEP_PERC)"
+#endif
  
 /***************************************************************************************
  * Data Type Definitions
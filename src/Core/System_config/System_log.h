@@ -0,0 +1,49 @@
+/**
+ * @file      System_log.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure how the core modules print their
+ *            traces in debug mode.
+ */
+
+#ifndef SYSTEM_LOG_H_
+#define SYSTEM_LOG_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, the traces of the core modules are stored as compact records in a lock-free
+ * ring buffer, and a low priority task formats and prints them. The hot path only
+ * pays the store of the record and the notification of the task. If 0, the traces
+ * are printed where they happen. The traces are only generated in debug mode, the
+ * ring buffer and the task are compiled out otherwise.
+ */
+#ifndef SYSTEM_DEFERRED_LOG
+  #define SYSTEM_DEFERRED_LOG 1
+#endif
+
+/* Number of records of the ring buffer, it must be a power of two. When the ring
+ * buffer is full, the oldest records are overwritten and reported as lost.
+ */
+#define DEFERRED_LOG_LEN 64u
+
+/* Priority of the task that prints the records, above the idle task only. */
+#define DEFERRED_LOG_TASK_PRIORITY 1u
+
+/* Stack size in bytes of the task that prints the records. */
+#define DEFERRED_LOG_STACK_SIZE 3072u
+
+/* Checks if the log configuration has valid values. */
+#if SYSTEM_DEFERRED_LOG != 0 && SYSTEM_DEFERRED_LOG != 1
+  #error "Invalid deferred log option: [0-1]:"
+  #error "refer to (SYSTEM_DEFERRED_LOG)"
+#endif
+
+#if DEFERRED_LOG_LEN == 0 || (DEFERRED_LOG_LEN & (DEFERRED_LOG_LEN - 1)) != 0
+  #error "Invalid deferred log length: it must be a power of two:"
+  #error "refer to (DEFERRED_LOG_LEN)"
+#endif
+
+#endif /* SYSTEM_LOG_H_ */
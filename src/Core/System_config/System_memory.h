@@ -0,0 +1,31 @@
+/**
+ * @file      System_memory.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure how the system allocates its
+ *            memory.
+ */
+
+#ifndef SYSTEM_MEMORY_H_
+#define SYSTEM_MEMORY_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, the queues, event groups and tasks of the core modules are placed in static
+ * storage sized at compile time. If 0, they are allocated from the heap when the 
+ * modules are initialized. In both cases they are created only once.
+ */
+#ifndef SYSTEM_STATIC_ALLOCATION
+  #define SYSTEM_STATIC_ALLOCATION 1
+#endif
+
+/* Checks if the memory configuration has valid values. */
+#if SYSTEM_STATIC_ALLOCATION != 0 && SYSTEM_STATIC_ALLOCATION != 1
+  #error "Invalid static allocation option: [0-1]:"
+  #error "refer to (SYSTEM_STATIC_ALLOCATION)"
+#endif
+
+#endif /* SYSTEM_MEMORY_H_ */
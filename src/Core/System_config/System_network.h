@@ -0,0 +1,432 @@
+/**
+ * @file      System_network.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure how the system talks with the
+ *            gateway.
+ */
+
+#ifndef SYSTEM_NETWORK_H_
+#define SYSTEM_NETWORK_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <sdkconfig.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Possible connection modes of the TCP client.
+ *
+ *   - TCP_CLIENT_CONNECT_PER_COMMAND:
+ *       A socket is created, connected and closed for every command.
+ *
+ *   - TCP_CLIENT_PERSISTENT_CONNECTION:
+ *       One socket is kept open per gateway session and reused for every command.
+ */
+#define TCP_CLIENT_CONNECT_PER_COMMAND   0u
+#define TCP_CLIENT_PERSISTENT_CONNECTION 1u
+
+/* Connection mode used by the TCP client. */
+#ifndef TCP_CLIENT_CONNECTION_MODE
+  #define TCP_CLIENT_CONNECTION_MODE TCP_CLIENT_PERSISTENT_CONNECTION
+#endif
+
+/* Possible transports of the commands.
+ *
+ *   - TCP_CLIENT_TRANSPORT_TCP:
+ *       The frames are written in a TCP connection with the gateway, see
+ *       TCP_CLIENT_CONNECTION_MODE.
+ *
+ *   - TCP_CLIENT_TRANSPORT_UDP:
+ *       Every frame is sent in one UDP datagram, to the gateway or to a multicast
+ *       group. There is no connection setup, so it is the fastest one in a LAN.
+ *
+ *   - TCP_CLIENT_TRANSPORT_ESPNOW:
+ *       Every frame is sent in one ESP-NOW action frame to every peer of
+ *       ESPNOW_PEERS -> System_espnow.h. It needs neither the association nor an IP,
+ *       so a press is sent as soon as the radio starts, also after a wake up.
+ */
+#define TCP_CLIENT_TRANSPORT_TCP    0u
+#define TCP_CLIENT_TRANSPORT_UDP    1u
+#define TCP_CLIENT_TRANSPORT_ESPNOW 2u
+
+/* Transport used by the TCP client. */
+#ifndef TCP_CLIENT_TRANSPORT
+  #define TCP_CLIENT_TRANSPORT TCP_CLIENT_TRANSPORT_TCP
+#endif
+
+/* If 1, the UDP datagrams are sent to TCP_CLIENT_UDP_MULTICAST_GROUP, so one press
+ * drives every gateway of the group. Otherwise they are sent to the gateway.
+ */
+#ifndef TCP_CLIENT_UDP_MULTICAST
+  #define TCP_CLIENT_UDP_MULTICAST 0
+#endif
+
+/* Multicast group, time to live of the multicast datagrams and destination port of
+ * the UDP datagrams.
+ */
+#ifndef TCP_CLIENT_UDP_MULTICAST_GROUP
+  #define TCP_CLIENT_UDP_MULTICAST_GROUP "239.255.10.1"
+#endif
+#define TCP_CLIENT_UDP_MULTICAST_TTL 1u
+#ifndef TCP_CLIENT_UDP_PORT
+  #define TCP_CLIENT_UDP_PORT TCP_IP_PORT
+#endif
+
+/* Number of times that every UDP datagram is sent and time in milliseconds between
+ * two sends. The copies keep the sequence number of the frame, so the gateway applies
+ * it only once. A gap shorter than the FreeRTOS tick waits one tick. The copies do
+ * not hold the TX task, a batch that arrives before them is sent right after the
+ * pending copies of the previous one.
+ */
+#define TCP_CLIENT_UDP_SENDS       2u
+#define TCP_CLIENT_UDP_SEND_GAP_MS  5u
+
+/* Keepalive configuration of the persistent connection. Seconds without traffic
+ * before the first probe, seconds between probes and number of unanswered probes
+ * before the connection is considered dead.
+ */
+#define TCP_CLIENT_KEEPALIVE_IDLE_S     5
+#define TCP_CLIENT_KEEPALIVE_INTERVAL_S 2
+#define TCP_CLIENT_KEEPALIVE_COUNT      3
+
+/* Minimum and maximum time in milliseconds to wait between two reconnection attempts
+ * of the persistent connection, and between two sends of an ESP-NOW frame to the
+ * peers that did not ack it. The time is doubled after each failed attempt.
+ */
+#define TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS 50u
+#define TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS 5000u
+
+/* Maximum time in milliseconds to wait for the gateway to accept a connection and to
+ * accept the written data.
+ */
+#define TCP_CLIENT_CONNECT_TIME_OUT_MS 3000u
+#define TCP_CLIENT_SEND_TIME_OUT_MS    2000u
+
+/* Number of times that the persistent connection or the ESP-NOW transport tries to
+ * deliver a command before dropping it.
+ */
+#define TCP_CLIENT_MAX_SEND_ATTEMPTS 3u
+
+/* Maximum number of commands that the TX task joins in one write. Connecting per
+ * command keeps the one command per connection behavior, so it does not batch.
+ */
+#if TCP_CLIENT_CONNECTION_MODE == TCP_CLIENT_PERSISTENT_CONNECTION || \
+    TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_TCP
+  #define TCP_CLIENT_TX_BATCH_LEN 8u
+#else
+  #define TCP_CLIENT_TX_BATCH_LEN 1u
+#endif
+
+/* Possible formats of the data written to the gateway.
+ *
+ *   - TCP_CLIENT_WIRE_RAW:
+ *       Every command is written as its in-memory TCP_COMMAND_TYPE structure. It is
+ *       what the gateways that do not understand frames parse.
+ *
+ *   - TCP_CLIENT_WIRE_FRAMED:
+ *       Every batch is written as one versioned frame with packed command records,
+ *       see Frame.h.
+ */
+#define TCP_CLIENT_WIRE_RAW    0u
+#define TCP_CLIENT_WIRE_FRAMED 1u
+
+/* Format of the data written to the gateway. Over TCP it stays raw unless the
+ * gateway was updated to parse the frames, the other transports are always framed.
+ */
+#ifndef TCP_CLIENT_WIRE_FORMAT
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+    #define TCP_CLIENT_WIRE_FORMAT TCP_CLIENT_WIRE_RAW
+  #else
+    #define TCP_CLIENT_WIRE_FORMAT TCP_CLIENT_WIRE_FRAMED
+  #endif
+#endif
+
+/* Possible lwIP APIs of the persistent TCP connection.
+ *
+ *   - TCP_CLIENT_LWIP_SOCKETS:
+ *       BSD sockets. The socket layer copies every batch into a pbuf and hands it to
+ *       the tcpip thread through its mailbox.
+ *
+ *   - TCP_CLIENT_LWIP_RAW:
+ *       Raw TCP API. The TX task builds every batch in a slot of a preallocated pool
+ *       and lwIP sends it from there without copying it. The calls are made with the
+ *       lwIP core lock, without the mailbox hop, so it needs
+ *       CONFIG_LWIP_TCPIP_CORE_LOCKING in the menuconfig. See Raw_TCP.h.
+ */
+#define TCP_CLIENT_LWIP_SOCKETS 0u
+#define TCP_CLIENT_LWIP_RAW     1u
+
+/* lwIP API of the persistent TCP connection. */
+#ifndef TCP_CLIENT_LWIP_API
+  #define TCP_CLIENT_LWIP_API TCP_CLIENT_LWIP_SOCKETS
+#endif
+
+/* Number of slots of the raw API pool and size in bytes of every slot. A slot is
+ * reused once the gateway acknowledges all its bytes at TCP level, while every slot
+ * waits for it the commands stay in the TX queue.
+ */
+#define TCP_CLIENT_RAW_POOL_LEN  8u
+#define TCP_CLIENT_RAW_SLOT_SIZE 32u
+
+/* If 1, the gateway acknowledges the frames. Up to TCP_CLIENT_ACK_WINDOW frames are
+ * written without waiting for their ack, the unacknowledged ones are written again
+ * after a reconnection. It needs the persistent connection over sockets and the
+ * framed format. Only enable it if the gateway sends the acks, otherwise every frame
+ * is written again until it is reported as not acknowledged.
+ */
+#ifndef TCP_CLIENT_GATEWAY_ACKS
+  #define TCP_CLIENT_GATEWAY_ACKS 0
+#endif
+
+/* Maximum number of frames written and not acknowledged yet. */
+#define TCP_CLIENT_ACK_WINDOW 8u
+
+/* Time in milliseconds that the oldest frame waits for its ack. When it expires, the
+ * session is reopened and the frames are written again. A frame that was written
+ * TCP_CLIENT_MAX_SEND_ATTEMPTS times without ack is dropped.
+ */
+#define TCP_CLIENT_ACK_TIME_OUT_MS 500u
+
+/* Time in milliseconds that the TX task waits for new commands before reading the
+ * acks that arrived, while there are frames waiting for them.
+ */
+#define TCP_CLIENT_ACK_POLL_PERIOD_MS 10u
+
+/* Time in milliseconds that the TX task waits for more commands after the first one
+ * of a batch. 0 only joins the commands that are already queued. Otherwise it must
+ * be at least one FreeRTOS tick, so the default tick of 10 milliseconds does not
+ * linger.
+ */
+#ifndef TCP_CLIENT_TX_LINGER_MS
+  #if CONFIG_FREERTOS_HZ >= 500
+    #define TCP_CLIENT_TX_LINGER_MS 2u
+  #else
+    #define TCP_CLIENT_TX_LINGER_MS 0u
+  #endif
+#endif
+
+/* If 1, a SET_PWM command replaces the SET_PWM of the same LED that is still waiting
+ * to be sent, so only the newest duty cycle reaches the gateway. TOOGLE_LED commands
+ * are always sent one by one.
+ */
+#define TCP_CLIENT_COALESCE_PWM 1
+
+/* Possible sources of the gateway address.
+ *
+ *   - TCP_CLIENT_GATEWAY_FROM_LEASE:
+ *       The gateway is the default gateway of the IP lease.
+ *
+ *   - TCP_CLIENT_GATEWAY_FIXED_IP:
+ *       The gateway is always TCP_CLIENT_GATEWAY_IP.
+ *
+ *   - TCP_CLIENT_GATEWAY_FROM_DNS:
+ *       The gateway is TCP_CLIENT_GATEWAY_HOSTNAME, resolved through the DNS server of
+ *       the lease. The address is kept for TCP_CLIENT_GATEWAY_DNS_TTL_S seconds.
+ */
+#define TCP_CLIENT_GATEWAY_FROM_LEASE 0u
+#define TCP_CLIENT_GATEWAY_FIXED_IP   1u
+#define TCP_CLIENT_GATEWAY_FROM_DNS   2u
+
+/* Source of the gateway address used by the TCP client. */
+#ifndef TCP_CLIENT_GATEWAY_SOURCE
+  #define TCP_CLIENT_GATEWAY_SOURCE TCP_CLIENT_GATEWAY_FROM_LEASE
+#endif
+
+/* IPv4 address of the gateway when it is fixed. */
+#ifndef TCP_CLIENT_GATEWAY_IP
+  #define TCP_CLIENT_GATEWAY_IP "192.168.4.1"
+#endif
+
+/* Host name of the gateway and time in seconds that its resolved address is kept. */
+#ifndef TCP_CLIENT_GATEWAY_HOSTNAME
+  #define TCP_CLIENT_GATEWAY_HOSTNAME "lights-gateway.lan"
+#endif
+#define TCP_CLIENT_GATEWAY_DNS_TTL_S 300u
+
+/* Possible storages of the last good association and IP lease.
+ *
+ *   - NETWORK_CACHE_IN_NVS:
+ *       The record is kept in the NVS flash partition, it survives power losses.
+ *
+ *   - NETWORK_CACHE_IN_RTC_MEMORY:
+ *       The record is kept in the RTC memory, it survives resets and deep sleep but
+ *       it does not wear the flash.
+ */
+#define NETWORK_CACHE_IN_NVS        0u
+#define NETWORK_CACHE_IN_RTC_MEMORY 1u
+
+/* If 1, the station reuses the BSSID, channel and IP lease of the last good
+ * association, so it skips the channel scan and the DHCP negotiation. If the cached
+ * association fails, the record is discarded and the station scans and asks for a
+ * DHCP lease as usual.
+ */
+#ifndef TCP_CLIENT_FAST_RECONNECT
+  #define TCP_CLIENT_FAST_RECONNECT 1
+#endif
+
+/* Storage of the fast reconnection record. */
+#ifndef TCP_CLIENT_FAST_RECONNECT_STORAGE
+  #define TCP_CLIENT_FAST_RECONNECT_STORAGE NETWORK_CACHE_IN_NVS
+#endif
+
+/* Possible storages of the offline journal.
+ *
+ *   - JOURNAL_IN_RAM:
+ *       The journal is lost with a reset.
+ *
+ *   - JOURNAL_IN_RTC_MEMORY:
+ *       The journal is kept in the RTC memory, it survives resets and deep sleep but
+ *       not a power loss.
+ */
+#define JOURNAL_IN_RAM        0u
+#define JOURNAL_IN_RTC_MEMORY 1u
+
+/* If 1, the commands sent while the link is down are kept in a journal instead of
+ * the TX queue. When the link is up again, the journal is compacted with the LED
+ * coalescing rules (a pair of toggles cancels, only the newest duty cycle of a LED is
+ * kept) and replayed in one frame after the commands that were already queued. It
+ * is replayed before a state snapshot too, so the snapshot, which reflects those
+ * commands, is applied after them.
+ */
+#ifndef TCP_CLIENT_OFFLINE_JOURNAL
+  #define TCP_CLIENT_OFFLINE_JOURNAL 1
+#endif
+
+/* Maximum number of commands of the journal. A full journal is compacted, and if it
+ * is still full the oldest command is discarded.
+ */
+#define TCP_CLIENT_JOURNAL_LEN 32u
+
+/* Storage of the offline journal. */
+#ifndef TCP_CLIENT_JOURNAL_STORAGE
+  #define TCP_CLIENT_JOURNAL_STORAGE JOURNAL_IN_RAM
+#endif
+
+/* Checks if the network configuration has valid values. */
+#if TCP_CLIENT_CONNECTION_MODE != TCP_CLIENT_CONNECT_PER_COMMAND && \
+    TCP_CLIENT_CONNECTION_MODE != TCP_CLIENT_PERSISTENT_CONNECTION
+  #error "Invalid TCP client connection mode:"
+  #error "refer to (TCP_CLIENT_CONNECTION_MODE)"
+#endif
+
+#if TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_TCP && \
+    TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_UDP && \
+    TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_ESPNOW
+  #error "Invalid transport:"
+  #error "refer to (TCP_CLIENT_TRANSPORT)"
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP && TCP_CLIENT_UDP_SENDS == 0
+  #error "Invalid number of UDP sends: it must be at least 1:"
+  #error "refer to (TCP_CLIENT_UDP_SENDS)"
+#endif
+
+#if TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS == 0 || \
+    TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS > TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS
+  #error "Invalid reconnection backoff: 0 < MIN <= MAX:"
+  #error "refer to (TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS, TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS)"
+#endif
+
+#if TCP_CLIENT_MAX_SEND_ATTEMPTS == 0
+  #error "Invalid number of send attempts: it must be at least 1:"
+  #error "refer to (TCP_CLIENT_MAX_SEND_ATTEMPTS)"
+#endif
+
+#if TCP_CLIENT_TX_BATCH_LEN == 0
+  #error "Invalid TX batch length: it must be at least 1:"
+  #error "refer to (TCP_CLIENT_TX_BATCH_LEN)"
+#endif
+
+#if TCP_CLIENT_TX_LINGER_MS > 0 && TCP_CLIENT_TX_LINGER_MS*CONFIG_FREERTOS_HZ < 1000
+  #error "Invalid TX linger: it must be 0 or at least one FreeRTOS tick:"
+  #error "refer to (TCP_CLIENT_TX_LINGER_MS, CONFIG_FREERTOS_HZ)"
+#endif
+
+#if TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_RAW && \
+    TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_FRAMED
+  #error "Invalid wire format:"
+  #error "refer to (TCP_CLIENT_WIRE_FORMAT)"
+#endif
+
+#if TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_TCP && \
+    TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_FRAMED
+  #error "The UDP and ESP-NOW transports need the framed wire format:"
+  #error "refer to (TCP_CLIENT_TRANSPORT, TCP_CLIENT_WIRE_FORMAT)"
+#endif
+
+#if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED && TCP_CLIENT_TX_BATCH_LEN > 255
+  #error "Invalid TX batch length: a frame carries up to 255 commands:"
+  #error "refer to (TCP_CLIENT_TX_BATCH_LEN)"
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1 && \
+    (TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_TCP || \
+     TCP_CLIENT_CONNECTION_MODE != TCP_CLIENT_PERSISTENT_CONNECTION || \
+     TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_FRAMED)
+  #error "Gateway acks need the persistent TCP connection and the framed wire format:"
+  #error "refer to (TCP_CLIENT_GATEWAY_ACKS)"
+#endif
+
+#if TCP_CLIENT_LWIP_API != TCP_CLIENT_LWIP_SOCKETS && \
+    TCP_CLIENT_LWIP_API != TCP_CLIENT_LWIP_RAW
+  #error "Invalid lwIP API:"
+  #error "refer to (TCP_CLIENT_LWIP_API)"
+#endif
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW && \
+    (TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_TCP || \
+     TCP_CLIENT_CONNECTION_MODE != TCP_CLIENT_PERSISTENT_CONNECTION)
+  #error "The raw lwIP API needs the persistent TCP connection:"
+  #error "refer to (TCP_CLIENT_LWIP_API)"
+#endif
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW && TCP_CLIENT_GATEWAY_ACKS == 1
+  #error "The gateway acks are read from the socket, they need the sockets API:"
+  #error "refer to (TCP_CLIENT_LWIP_API) and (TCP_CLIENT_GATEWAY_ACKS)"
+#endif
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW && TCP_CLIENT_RAW_POOL_LEN == 0
+  #error "Invalid raw API pool length: it must be at least 1:"
+  #error "refer to (TCP_CLIENT_RAW_POOL_LEN)"
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1 && TCP_CLIENT_ACK_WINDOW == 0
+  #error "Invalid ack window: it must be at least 1:"
+  #error "refer to (TCP_CLIENT_ACK_WINDOW)"
+#endif
+
+#if TCP_CLIENT_GATEWAY_SOURCE != TCP_CLIENT_GATEWAY_FROM_LEASE && \
+    TCP_CLIENT_GATEWAY_SOURCE != TCP_CLIENT_GATEWAY_FIXED_IP && \
+    TCP_CLIENT_GATEWAY_SOURCE != TCP_CLIENT_GATEWAY_FROM_DNS
+  #error "Invalid gateway address source:"
+  #error "refer to (TCP_CLIENT_GATEWAY_SOURCE)"
+#endif
+
+#if TCP_CLIENT_GATEWAY_DNS_TTL_S == 0
+  #error "Invalid gateway DNS TTL: it must be at least 1 second:"
+  #error "refer to (TCP_CLIENT_GATEWAY_DNS_TTL_S)"
+#endif
+
+#if TCP_CLIENT_FAST_RECONNECT_STORAGE != NETWORK_CACHE_IN_NVS && \
+    TCP_CLIENT_FAST_RECONNECT_STORAGE != NETWORK_CACHE_IN_RTC_MEMORY
+  #error "Invalid fast reconnection storage:"
+  #error "refer to (TCP_CLIENT_FAST_RECONNECT_STORAGE)"
+#endif
+
+#if TCP_CLIENT_OFFLINE_JOURNAL == 1 && TCP_CLIENT_JOURNAL_LEN == 0
+  #error "Invalid journal length: it must be at least 1:"
+  #error "refer to (TCP_CLIENT_JOURNAL_LEN)"
+#endif
+
+#if TCP_CLIENT_JOURNAL_STORAGE != JOURNAL_IN_RAM && \
+    TCP_CLIENT_JOURNAL_STORAGE != JOURNAL_IN_RTC_MEMORY
+  #error "Invalid journal storage:"
+  #error "refer to (TCP_CLIENT_JOURNAL_STORAGE)"
+#endif
+
+#endif /* SYSTEM_NETWORK_H_ */
@@ -0,0 +1,53 @@
+/**
+ * @file      System_power.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure how the system saves power while
+ *            it is idle.
+ */
+
+#ifndef SYSTEM_POWER_H_
+#define SYSTEM_POWER_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, the CPU enters light sleep whenever FreeRTOS is idle and the buttons wake it
+ * up, the WiFi keeps the association in modem sleep. It needs CONFIG_PM_ENABLE,
+ * CONFIG_FREERTOS_USE_TICKLESS_IDLE and CONFIG_PM_LIGHT_SLEEP_CALLBACKS in the
+ * sdkconfig. The traces of the debug mode keep the CPU awake, so the current is only
+ * representative with DEBUG_MODE_ENABLE at 0.
+ */
+#ifndef SYSTEM_LOW_POWER
+  #define SYSTEM_LOW_POWER 0
+#endif
+
+/* Frequencies in MHz of the CPU while it handles a press and while it is idle. */
+#define POWER_MAX_CPU_FREQ_MHZ 160
+#define POWER_MIN_CPU_FREQ_MHZ 40
+
+/* Number of beacons that the station sleeps in modem sleep. The commands are sent as
+ * soon as they are enqueued, it only delays the data that the gateway sends, such as
+ * the acks of the persistent connection.
+ */
+#define POWER_WIFI_LISTEN_INTERVAL 3u
+
+/* Checks if the power configuration has valid values. */
+#if SYSTEM_LOW_POWER != 0 && SYSTEM_LOW_POWER != 1
+  #error "Invalid low power option: [0-1]:"
+  #error "refer to (SYSTEM_LOW_POWER)"
+#endif
+
+#if POWER_MIN_CPU_FREQ_MHZ > POWER_MAX_CPU_FREQ_MHZ
+  #error "Invalid CPU frequencies: the minimum can not be above the maximum:"
+  #error "refer to (POWER_MIN_CPU_FREQ_MHZ) and (POWER_MAX_CPU_FREQ_MHZ)"
+#endif
+
+#if POWER_WIFI_LISTEN_INTERVAL == 0 || POWER_WIFI_LISTEN_INTERVAL > 10
+  #error "Invalid WiFi listen interval: [1-10] beacons:"
+  #error "refer to (POWER_WIFI_LISTEN_INTERVAL)"
+#endif
+
+#endif /* SYSTEM_POWER_H_ */
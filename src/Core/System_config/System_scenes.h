@@ -0,0 +1,52 @@
+/**
+ * @file      System_scenes.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to define the scenes of the system, groups of
+ *            commands that one button press sends together. The buttons are bound
+ *            to the scenes with SCENE_ACTION -> System_actions.h
+ */
+
+#ifndef SYSTEM_SCENES_H_
+#define SYSTEM_SCENES_H_
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Macro that enlist the system scenes. It is mandatory to not set values to the 
+ * enumerates.
+ */
+#define SCENES \
+  SCENE(SCENE_FULL_BRIGHTNESS)
+
+/* Macro that describes the targets of the scenes. All the targets of a scene are sent
+ * in the same frame, in the listed order.
+ *
+ * Parameters:
+ *
+ *   1) Identifier of the scene, it is mandatory to put a value defined inside SCENES.
+ *   2) Identifier of the LED, it is mandatory to put a value defined inside LEDS ->
+ *      System_lights.h
+ *   3) Action to do over the LED, TOOGLE_LED or SET_PWM -> Network_config.h
+ *   4) Duty cycle in terms of percentage, only used by SET_PWM.
+ */
+#define SCENES_TARGETS                                                     \
+  SCENE_TARGET(SCENE_FULL_BRIGHTNESS, LED_0, SET_PWM, MAX_DUTY_CYCLE_PERC)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that enlist the system scenes. */
+typedef enum
+{
+  #define SCENE(enumerate) enumerate,
+    SCENES
+  #undef SCENE
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_SCENES,
+} Scene_ID;
+
+#endif /* SYSTEM_SCENES_H_ */
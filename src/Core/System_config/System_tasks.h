@@ -0,0 +1,121 @@
+/**
+ * @file      System_tasks.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure in which core and with which
+ *            priority the tasks of the core modules run.
+ */
+
+#ifndef SYSTEM_TASKS_H_
+#define SYSTEM_TASKS_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <sdkconfig.h>
+#include <esp_task.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Possible plans of cores and priorities of the tasks.
+ *
+ *   - TASK_PLAN_FLOATING:
+ *       The tasks run in any core, above the WiFi and lwIP tasks. Kept to compare
+ *       with it, the TX task can preempt the lwIP task that it is waiting for.
+ *
+ *   - TASK_PLAN_NETWORK_AWARE:
+ *       The TX task runs in the core of the lwIP and WiFi tasks, below them, so they
+ *       serve its requests as soon as it blocks. The dispatcher runs in the other core,
+ *       so a burst of network work does not delay the presses.
+ */
+#define TASK_PLAN_FLOATING      0u
+#define TASK_PLAN_NETWORK_AWARE 1u
+
+/* Plan used by the system. */
+#ifndef SYSTEM_TASK_PLAN
+  #define SYSTEM_TASK_PLAN TASK_PLAN_NETWORK_AWARE
+#endif
+
+#if SYSTEM_TASK_PLAN == TASK_PLAN_NETWORK_AWARE
+
+  /* Core of the lwIP task, or of the WiFi task if the lwIP one is not pinned. */
+  #if defined(CONFIG_LWIP_TCPIP_TASK_AFFINITY_CPU1) ||                               \
+      (!defined(CONFIG_LWIP_TCPIP_TASK_AFFINITY_CPU0) &&                             \
+       defined(CONFIG_ESP_WIFI_TASK_PINNED_TO_CORE_1))
+    #define NETWORK_CORE 1
+  #else
+    #define NETWORK_CORE 0
+  #endif
+
+  /* Cores of the tasks, a single core system runs all of them in the same one. */
+  #if defined(CONFIG_FREERTOS_UNICORE)
+    #define TX_TASK_CORE         tskNO_AFFINITY
+    #define DISPATCHER_TASK_CORE tskNO_AFFINITY
+  #else
+    #define TX_TASK_CORE         NETWORK_CORE
+    #define DISPATCHER_TASK_CORE (1 - NETWORK_CORE)
+  #endif
+
+  /* Priorities of the tasks. The dispatcher is above the TX task, a press is taken
+   * even while the TX task is busy with the previous one.
+   */
+  #define DISPATCHER_TASK_PRIORITY (ESP_TASK_TCPIP_PRIO - 1)
+  #define TX_TASK_PRIORITY         (ESP_TASK_TCPIP_PRIO - 2)
+
+#else
+
+  #define TX_TASK_CORE             tskNO_AFFINITY
+  #define DISPATCHER_TASK_CORE     tskNO_AFFINITY
+  #define DISPATCHER_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+  #define TX_TASK_PRIORITY         (configMAX_PRIORITIES - 2)
+
+#endif
+
+/* Core and priority of the task that loads the network while the latency is
+ * measured, see LATENCY_STRESS_TRAFFIC. It is an application task, below the tasks of
+ * the system.
+ */
+#define STRESS_TASK_CORE     tskNO_AFFINITY
+#define STRESS_TASK_PRIORITY 5
+
+/* Core and priority of the task that prints the latency percentiles, see
+ * LATENCY_REPORT_PRESSES. It only prints, so it is below every task of the system and
+ * the reports never delay a press.
+ */
+#define LATENCY_REPORT_TASK_CORE     tskNO_AFFINITY
+#define LATENCY_REPORT_TASK_PRIORITY 1
+
+/* Core and priority of the task that injects the presses of the benchmark mode, see
+ * SYSTEM_BENCH_MODE. It stands for the GPIO ISR, so it is above every task and it
+ * only blocks between presses.
+ */
+#define BENCH_TASK_CORE     tskNO_AFFINITY
+#define BENCH_TASK_PRIORITY (configMAX_PRIORITIES - 1)
+
+/* Checks if the tasks configuration has valid values. */
+#if SYSTEM_TASK_PLAN != TASK_PLAN_FLOATING && \
+    SYSTEM_TASK_PLAN != TASK_PLAN_NETWORK_AWARE
+  #error "Invalid task plan: [TASK_PLAN_FLOATING, TASK_PLAN_NETWORK_AWARE]:"
+  #error "refer to (SYSTEM_TASK_PLAN)"
+#endif
+
+#if SYSTEM_TASK_PLAN == TASK_PLAN_NETWORK_AWARE && \
+    TX_TASK_PRIORITY >= ESP_TASK_TCPIP_PRIO
+  #error "Invalid TX task priority: it must be below the lwIP task:"
+  #error "refer to (TX_TASK_PRIORITY) and (ESP_TASK_TCPIP_PRIO)"
+#endif
+
+#if LATENCY_REPORT_TASK_PRIORITY >= STRESS_TASK_PRIORITY
+  #error "Invalid latency report task priority: it must be below the stress task:"
+  #error "refer to (LATENCY_REPORT_TASK_PRIORITY)"
+#endif
+
+#if STRESS_TASK_PRIORITY >= TX_TASK_PRIORITY
+  #error "Invalid stress task priority: it must be below the TX task:"
+  #error "refer to (STRESS_TASK_PRIORITY)"
+#endif
+
+#endif /* SYSTEM_TASKS_H_ */
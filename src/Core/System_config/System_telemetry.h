@@ -0,0 +1,54 @@
+/**
+ * @file      System_telemetry.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     File that declares macros to configure the telemetry counters of the
+ *            system, that can be read on demand and reported to the gateway.
+ */
+
+#ifndef SYSTEM_TELEMETRY_H_
+#define SYSTEM_TELEMETRY_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_network.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* If 1, the TX path, the network event handlers and the dispatcher keep counters of
+ * the queue depth, the drops, the connections, the heap and the stack watermarks. If
+ * 0, the counters are compiled out.
+ */
+#ifndef SYSTEM_TELEMETRY
+  #define SYSTEM_TELEMETRY 1
+#endif
+
+/* Time in milliseconds between two stats frames that the TX task sends to the
+ * gateway. 0 disables the reports, the counters can still be read on demand. Only
+ * enable it if the gateway skips the stats frames, see Frame.h.
+ */
+#ifndef TELEMETRY_REPORT_PERIOD_MS
+  #define TELEMETRY_REPORT_PERIOD_MS 0u
+#endif
+
+/* Checks if the telemetry configuration has valid values. */
+#if SYSTEM_TELEMETRY != 0 && SYSTEM_TELEMETRY != 1
+  #error "Invalid telemetry option: [0-1]:"
+  #error "refer to (SYSTEM_TELEMETRY)"
+#endif
+
+#if TELEMETRY_REPORT_PERIOD_MS != 0 && SYSTEM_TELEMETRY == 0
+  #error "The stats frames need the telemetry counters:"
+  #error "refer to (TELEMETRY_REPORT_PERIOD_MS) and (SYSTEM_TELEMETRY)"
+#endif
+
+#if TELEMETRY_REPORT_PERIOD_MS != 0 && TCP_CLIENT_WIRE_FORMAT != TCP_CLIENT_WIRE_FRAMED
+  #error "The stats frames need the framed wire format:"
+  #error "refer to (TELEMETRY_REPORT_PERIOD_MS) and (TCP_CLIENT_WIRE_FORMAT)"
+#endif
+
+#endif /* SYSTEM_TELEMETRY_H_ */
@@ -0,0 +1,395 @@
+/**
+ * @file      Espnow.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to send the frames to the
+ *            ESP-NOW peers, without association nor IP. It is only compiled with
+ *            TCP_CLIENT_TRANSPORT_ESPNOW.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Espnow.h>
+#include <System_network.h>
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+
+#include <System_memory.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Time in ticks to wait for the send callbacks of an attempt. */
+#define ACK_TIME_OUT_TICKS ((pdMS_TO_TICKS(ESPNOW_ACK_TIME_OUT_MS) > 0u) ? \
+  pdMS_TO_TICKS(ESPNOW_ACK_TIME_OUT_MS) : 1u)
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core ESP-NOW module. */
+  #define TAG "CORE_ESPNOW"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Structure that contains the configuration of a peer from ESPNOW_PEERS. */
+typedef struct
+{
+  /* MAC of the peer, in the "xx:xx:xx:xx:xx:xx" format. */
+  const char *MAC_text;
+  /* Local master key of the peer, empty if it is not encrypted. */
+  const char *LMK;
+} espnow_peer_config;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Configuration of every peer. */
+static const espnow_peer_config espnow_peer_configs[NUM_OF_ESPNOW_PEERS] =
+{
+  #define ESPNOW_PEER(peer_ID, peer_MAC, peer_LMK) \
+    [peer_ID] =                                    \
+    {                                              \
+      .MAC_text = peer_MAC,                        \
+      .LMK = peer_LMK,                             \
+    },
+    ESPNOW_PEERS
+  #undef ESPNOW_PEER
+};
+
+/* The keys of the peers must have the length that ESP-NOW expects, or be empty. */
+#define ESPNOW_PEER(peer_ID, peer_MAC, peer_LMK)                      \
+  _Static_assert(sizeof(peer_LMK) == 1u ||                            \
+    sizeof(peer_LMK) == ESPNOW_KEY_LEN + 1u,                          \
+    "Invalid local master key of " #peer_ID);
+  ESPNOW_PEERS
+#undef ESPNOW_PEER
+
+#if ESPNOW_ENCRYPT == 1
+  _Static_assert(sizeof(ESPNOW_PMK) == ESPNOW_KEY_LEN + 1u,
+    "Invalid primary master key: refer to (ESPNOW_PMK)");
+
+  /* Encryption without any local master key would send every frame in clear. */
+  #define ESPNOW_PEER(peer_ID, peer_MAC, peer_LMK) + (sizeof(peer_LMK) > 1u)
+    _Static_assert((0u ESPNOW_PEERS) > 0u,
+      "No peer has a local master key: refer to (ESPNOW_PEERS)");
+  #undef ESPNOW_PEER
+#endif
+
+_Static_assert(NUM_OF_ESPNOW_PEERS > 0 && NUM_OF_ESPNOW_PEERS <= ESPNOW_MAX_PEERS,
+  "Invalid number of ESP-NOW peers: [1-20]: refer to (ESPNOW_PEERS)");
+
+/* MAC of every peer, parsed from its configuration. */
+static uint8_t espnow_peer_MACs[NUM_OF_ESPNOW_PEERS][ESP_NOW_ETH_ALEN];
+
+/* Peers that acknowledged the frame of the current attempt, a bit per peer. The send
+ * callback sets them from the WiFi task.
+ */
+static _Atomic uint32_t acked_peers;
+
+/* Sequence of the frames sent to every peer and of the send callbacks that arrived
+ * from it. The callbacks of a peer arrive in the order of its frames, so only the one
+ * whose sequence matches the last frame belongs to the current attempt. The rest
+ * arrived after the time out of an older attempt.
+ */
+static _Atomic uint32_t peer_send_seqs[NUM_OF_ESPNOW_PEERS];
+static _Atomic uint32_t peer_CB_seqs[NUM_OF_ESPNOW_PEERS];
+
+/* Event group that lets the sender block until the send callbacks arrive. */
+static EventGroupHandle_t espnow_event_group;
+
+#if SYSTEM_STATIC_ALLOCATION == 1
+  /* Storage of the ESP-NOW event group. */
+  static StaticEventGroup_t espnow_event_group_buffer;
+#endif
+
+/* Flag that indicates if the module was previously initialized or not. */
+static bool module_was_initialized;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Callback that ESP-NOW calls from the WiFi task when a peer acknowledges a
+ *        frame or when it gives up.
+ *
+ * @param MAC MAC of the peer.
+ *
+ * @param status ESP_NOW_SEND_SUCCESS if the peer acknowledged the frame.
+ *
+ * @return void
+ */
+static void espnow_send_CB(const uint8_t *MAC, esp_now_send_status_t status);
+
+/**
+ * @brief Parses the MAC of a peer.
+ *
+ * @param text MAC in the "xx:xx:xx:xx:xx:xx" format.
+ *
+ * @param MAC Where the parsed MAC is stored.
+ *
+ * @return True if the text has the expected format.
+ */
+static bool parse_MAC(const char *text, uint8_t *MAC);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Espnow_return init_espnow(void)
+{
+
+  if(module_was_initialized)
+  {
+    return CORE_ESPNOW_OK;
+  }
+
+  /* The event group lives as long as the system, it is only created once. */
+  if(espnow_event_group == NULL)
+  {
+    #if SYSTEM_STATIC_ALLOCATION == 1
+      espnow_event_group = xEventGroupCreateStatic(&espnow_event_group_buffer);
+    #else
+      espnow_event_group = xEventGroupCreate();
+    #endif
+    if(espnow_event_group == NULL)
+    {
+      return CORE_ESPNOW_INIT_EVENT_GROUP_ERR;
+    }
+  }
+
+  #if ESPNOW_WITH_STATION == 0
+    /* Without association nothing moves the radio, it stays in the peers channel. */
+    if(esp_wifi_set_channel(ESPNOW_CHANNEL, WIFI_SECOND_CHAN_NONE) != ESP_OK)
+    {
+      return CORE_ESPNOW_INIT_ERR;
+    }
+  #endif
+
+  if(esp_now_init() != ESP_OK)
+  {
+    return CORE_ESPNOW_INIT_ERR;
+  }
+
+  if(esp_now_register_send_cb(espnow_send_CB) != ESP_OK)
+  {
+    esp_now_deinit();
+    return CORE_ESPNOW_INIT_ERR;
+  }
+
+  #if ESPNOW_ENCRYPT == 1
+    if(esp_now_set_pmk((const uint8_t *)ESPNOW_PMK) != ESP_OK)
+    {
+      esp_now_deinit();
+      return CORE_ESPNOW_INIT_ERR;
+    }
+  #endif
+
+  for(size_t peer = 0u; peer < NUM_OF_ESPNOW_PEERS; peer++)
+  {
+    /* The callbacks of the previous session never arrive after esp_now_deinit. */
+    atomic_store(&peer_send_seqs[peer], 0u);
+    atomic_store(&peer_CB_seqs[peer], 0u);
+
+    if(!parse_MAC(espnow_peer_configs[peer].MAC_text, espnow_peer_MACs[peer]))
+    {
+      esp_now_deinit();
+      return CORE_ESPNOW_INVALID_PEER_ERR;
+    }
+
+    /* Channel 0 is the current one, the one of the access point if there is one. */
+    esp_now_peer_info_t peer_info =
+    {
+      .channel = 0u,
+      .ifidx = WIFI_IF_STA,
+      .encrypt = false,
+    };
+    memcpy(peer_info.peer_addr, espnow_peer_MACs[peer], ESP_NOW_ETH_ALEN);
+    #if ESPNOW_ENCRYPT == 1
+      if(espnow_peer_configs[peer].LMK[0] != '\0')
+      {
+        peer_info.encrypt = true;
+        memcpy(peer_info.lmk, espnow_peer_configs[peer].LMK, ESP_NOW_KEY_LEN);
+      }
+    #endif
+
+    if(esp_now_add_peer(&peer_info) != ESP_OK)
+    {
+      esp_now_deinit();
+      return CORE_ESPNOW_ADD_PEER_ERR;
+    }
+  }
+
+  module_was_initialized = true;
+
+  return CORE_ESPNOW_OK;
+}
+
+Espnow_return de_init_espnow(void)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_ESPNOW_OK;
+  }
+
+  module_was_initialized = false;
+
+  /* The peers are removed with ESP-NOW. */
+  if(esp_now_deinit() != ESP_OK)
+  {
+    return CORE_ESPNOW_DE_INIT_ERR;
+  }
+
+  return CORE_ESPNOW_OK;
+}
+
+Espnow_return send_espnow_frame(const uint8_t *frame, const size_t len,
+  uint32_t *pending_peers)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_ESPNOW_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  *pending_peers &= ESPNOW_ALL_PEERS;
+  xEventGroupClearBits(espnow_event_group, (EventBits_t)ESPNOW_ALL_PEERS);
+  atomic_store(&acked_peers, 0u);
+
+  /* Every peer is sent in a row, their acks are waited together. */
+  EventBits_t sent_peers = 0u;
+  for(size_t peer = 0u; peer < NUM_OF_ESPNOW_PEERS; peer++)
+  {
+    const EventBits_t peer_bit = (EventBits_t)1u << peer;
+    if((*pending_peers & peer_bit) == 0u)
+    {
+      continue;
+    }
+
+    /* A frame that is not sent has no callback, so it takes no sequence. */
+    atomic_fetch_add(&peer_send_seqs[peer], 1u);
+    if(esp_now_send(espnow_peer_MACs[peer], frame, len) == ESP_OK)
+    {
+      sent_peers |= peer_bit;
+    }
+    else
+    {
+      atomic_fetch_sub(&peer_send_seqs[peer], 1u);
+    }
+  }
+
+  /* The callback always arrives once the MAC gives up, the time out only bounds a
+   * WiFi task that is too busy.
+   */
+  if(sent_peers != 0u)
+  {
+    xEventGroupWaitBits(espnow_event_group, sent_peers, pdTRUE, pdTRUE,
+      ACK_TIME_OUT_TICKS);
+  }
+
+  *pending_peers &= ~atomic_load(&acked_peers);
+
+  #if DEBUG_MODE_ENABLE == 1
+    if(*pending_peers != 0u)
+    {
+      CORE_LOGE_ARG(TAG, "Peers without ack: 0x%x", *pending_peers);
+    }
+  #endif
+
+  return (*pending_peers == 0u) ? CORE_ESPNOW_OK : CORE_ESPNOW_NOT_ACKED_WARN;
+}
+
+inline Espnow_return core_espnow_LOG(const Espnow_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define ESPNOW_RETURN(enumerate)  \
+        case enumerate:                 \
+          if(ret > 0)                   \
+          {                             \
+            CORE_LOGE(TAG, #enumerate); \
+          }                             \
+          else                          \
+          {                             \
+            CORE_LOGI(TAG, #enumerate); \
+          }                             \
+          break;
+        ESPNOW_RETURNS
+      #undef ESPNOW_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+static void espnow_send_CB(const uint8_t *MAC, esp_now_send_status_t status)
+{
+
+  if(MAC == NULL)
+  {
+    return;
+  }
+
+  for(size_t peer = 0u; peer < NUM_OF_ESPNOW_PEERS; peer++)
+  {
+    if(memcmp(MAC, espnow_peer_MACs[peer], ESP_NOW_ETH_ALEN) == 0)
+    {
+      /* A late callback of an older attempt says nothing about the current one. */
+      const uint32_t CB_seq = atomic_fetch_add(&peer_CB_seqs[peer], 1u) + 1u;
+      if(CB_seq != atomic_load(&peer_send_seqs[peer]))
+      {
+        break;
+      }
+
+      const EventBits_t peer_bit = (EventBits_t)1u << peer;
+      if(status == ESP_NOW_SEND_SUCCESS)
+      {
+        atomic_fetch_or(&acked_peers, (uint32_t)peer_bit);
+      }
+      xEventGroupSetBits(espnow_event_group, peer_bit);
+      break;
+    }
+  }
+}
+
+static bool parse_MAC(const char *text, uint8_t *MAC)
+{
+
+  unsigned int bytes[ESP_NOW_ETH_ALEN];
+  char end;
+
+  /* The extra conversion fails unless the text ends after the last byte. */
+  if(sscanf(text, "%2x:%2x:%2x:%2x:%2x:%2x%c", &bytes[0], &bytes[1], &bytes[2],
+       &bytes[3], &bytes[4], &bytes[5], &end) != ESP_NOW_ETH_ALEN)
+  {
+    return false;
+  }
+
+  for(size_t i = 0u; i < ESP_NOW_ETH_ALEN; i++)
+  {
+    MAC[i] = (uint8_t)bytes[i];
+  }
+
+  return true;
+}
+
+#endif /* TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW */
@@ -0,0 +1,131 @@
+/**
+ * @file      Espnow.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to send the frames to the
+ *            ESP-NOW peers, without association nor IP.
+ */
+
+#ifndef CORE_ESPNOW_H_
+#define CORE_ESPNOW_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_espnow.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module ESP-NOW can return. */
+#define ESPNOW_RETURNS                                  \
+  /* Info codes */                                      \
+  ESPNOW_RETURN(CORE_ESPNOW_OK)                         \
+  /* Error codes */                                     \
+  ESPNOW_RETURN(CORE_ESPNOW_INIT_ERR)                   \
+  ESPNOW_RETURN(CORE_ESPNOW_INIT_EVENT_GROUP_ERR)       \
+  ESPNOW_RETURN(CORE_ESPNOW_INVALID_PEER_ERR)           \
+  ESPNOW_RETURN(CORE_ESPNOW_ADD_PEER_ERR)               \
+  ESPNOW_RETURN(CORE_ESPNOW_DE_INIT_ERR)                \
+  ESPNOW_RETURN(CORE_ESPNOW_MODULE_WAS_NOT_INIT_ERR)    \
+  ESPNOW_RETURN(CORE_ESPNOW_NOT_ACKED_WARN)
+
+/* Mask of all the peers, a bit per peer of ESPNOW_PEERS. */
+#define ESPNOW_ALL_PEERS (((uint32_t)1u << NUM_OF_ESPNOW_PEERS) - 1u)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define ESPNOW_RETURN(enumerate) enumerate,
+    ESPNOW_RETURNS
+  #undef ESPNOW_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_ESPNOW_RETURNS,
+} Espnow_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Initializes ESP-NOW and adds the peers of ESPNOW_PEERS. The WiFi must be
+ *        started before. If the station does not associate, the radio is moved to
+ *        ESPNOW_CHANNEL. It can not be called from ISR.
+ *
+ * @param void
+ *
+ * @return CORE_ESPNOW_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_ESPNOW_INIT_ERR:
+ *               Error trying to start ESP-NOW or to set its channel or its key.
+ *
+ *           - CORE_ESPNOW_INIT_EVENT_GROUP_ERR:
+ *               Error trying to create the event group of the acks.
+ *
+ *           - CORE_ESPNOW_INVALID_PEER_ERR:
+ *               The MAC of a peer does not have the "xx:xx:xx:xx:xx:xx" format.
+ *
+ *           - CORE_ESPNOW_ADD_PEER_ERR:
+ *               Error trying to add a peer, for example because there are more
+ *               encrypted peers than the allowed by the menuconfig.
+ */
+Espnow_return init_espnow(void);
+
+/**
+ * @brief De-initializes ESP-NOW and removes its peers.
+ *
+ * @param void
+ *
+ * @return CORE_ESPNOW_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_ESPNOW_DE_INIT_ERR:
+ *               Error trying to stop ESP-NOW.
+ */
+Espnow_return de_init_espnow(void);
+
+/**
+ * @brief Sends a frame once to the given peers and waits for their MAC acks. The
+ *        caller decides when to try again the peers that did not ack it. Only one
+ *        task can send at the same time, and it can not be called from ISR.
+ *
+ * @param frame Frame to send, up to ESP_NOW_MAX_DATA_LEN bytes.
+ *
+ * @param len Number of bytes of the frame.
+ *
+ * @param pending_peers Peers to send the frame to, a bit per peer, ESPNOW_ALL_PEERS
+ *                      for all of them. The bits of the peers that acknowledged it
+ *                      are cleared.
+ *
+ * @return CORE_ESPNOW_OK if every given peer acknowledged the frame,
+ *         otherwise:
+ *
+ *           - CORE_ESPNOW_MODULE_WAS_NOT_INIT_ERR:
+ *               Module was not initialized before.
+ *
+ *           - CORE_ESPNOW_NOT_ACKED_WARN:
+ *               A peer did not acknowledge the frame, its bit is still set.
+ */
+Espnow_return send_espnow_frame(const uint8_t *frame, const size_t len,
+  uint32_t *pending_peers);
+
+/**
+ * @brief Prints the return of an ESP-NOW module function if the system was configured
+ *        in debug mode.
+ *
+ * @param ret Received return from an ESP-NOW module function.
+ *
+ * @return The given return.
+ */
+Espnow_return core_espnow_LOG(const Espnow_return ret);
+
+#endif /* CORE_ESPNOW_H_ */
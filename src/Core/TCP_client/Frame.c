@@ -0,0 +1,177 @@
+/**
+ * @file      Frame.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to encode and decode the frames
+ *            exchanged with the gateway.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Frame.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core frame module. */
+  #define TAG "CORE_FRAME"
+#endif
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+size_t encode_frame_header(uint8_t *buffer, const Frame_type type, const uint16_t seq,
+  const uint8_t count)
+{
+
+  buffer[0] = (uint8_t)FRAME_VERSION;
+  buffer[1] = (uint8_t)type;
+  buffer[2] = (uint8_t)(seq >> 8u);
+  buffer[3] = (uint8_t)(seq & 0xFFu);
+  buffer[4] = count;
+
+  return FRAME_HEADER_SIZE;
+}
+
+size_t encode_cmd_record(uint8_t *buffer, const TCP_COMMAND_TYPE *cmd)
+{
+
+  buffer[0] = (uint8_t)cmd->ID;
+  buffer[1] = (uint8_t)cmd->action;
+  buffer[2] = (uint8_t)cmd->pwm;
+
+  return FRAME_CMD_RECORD_SIZE;
+}
+
+size_t encode_state_record(uint8_t *buffer, const Frame_state_record *state)
+{
+
+  buffer[0] = state->ID;
+  buffer[1] = state->on ? 1u : 0u;
+  buffer[2] = state->pwm;
+
+  return FRAME_STATE_RECORD_SIZE;
+}
+
+size_t encode_stats_record(uint8_t *buffer, const Frame_stats_record *stats)
+{
+
+  buffer[0] = stats->ID;
+  buffer[1] = (uint8_t)(stats->value >> 24u);
+  buffer[2] = (uint8_t)((stats->value >> 16u) & 0xFFu);
+  buffer[3] = (uint8_t)((stats->value >> 8u) & 0xFFu);
+  buffer[4] = (uint8_t)(stats->value & 0xFFu);
+
+  return FRAME_STATS_RECORD_SIZE;
+}
+
+Frame_return decode_frame_header(const uint8_t *buffer, const size_t len,
+  Frame_header *header)
+{
+
+  if(len < FRAME_HEADER_SIZE)
+  {
+    return CORE_FRAME_TOO_SHORT_ERR;
+  }
+
+  header->version = buffer[0];
+  header->type = (Frame_type)buffer[1];
+  header->seq = (uint16_t)(((uint16_t)buffer[2] << 8u) | buffer[3]);
+  header->count = buffer[4];
+
+  if(header->version != FRAME_VERSION)
+  {
+    return CORE_FRAME_VERSION_ERR;
+  }
+
+  switch(header->type)
+  {
+    case FRAME_TYPE_COMMANDS:
+      if(len < FRAME_CMDS_SIZE(header->count))
+      {
+        return CORE_FRAME_LEN_ERR;
+      }
+      break;
+    case FRAME_TYPE_STATE:
+      if(len < FRAME_STATE_SIZE(header->count))
+      {
+        return CORE_FRAME_LEN_ERR;
+      }
+      break;
+    case FRAME_TYPE_STATS:
+      if(len < FRAME_STATS_SIZE(header->count))
+      {
+        return CORE_FRAME_LEN_ERR;
+      }
+      break;
+    case FRAME_TYPE_ACK:
+      break;
+    default:
+      return CORE_FRAME_TYPE_ERR;
+  }
+
+  return CORE_FRAME_OK;
+}
+
+size_t decode_cmd_record(const uint8_t *buffer, TCP_COMMAND_TYPE *cmd)
+{
+
+  cmd->ID = buffer[0];
+  cmd->action = buffer[1];
+  cmd->pwm = buffer[2];
+
+  return FRAME_CMD_RECORD_SIZE;
+}
+
+size_t decode_state_record(const uint8_t *buffer, Frame_state_record *state)
+{
+
+  state->ID = buffer[0];
+  state->on = (buffer[1] != 0u);
+  state->pwm = buffer[2];
+
+  return FRAME_STATE_RECORD_SIZE;
+}
+
+size_t decode_stats_record(const uint8_t *buffer, Frame_stats_record *stats)
+{
+
+  stats->ID = buffer[0];
+  stats->value = ((uint32_t)buffer[1] << 24u) | ((uint32_t)buffer[2] << 16u) |
+    ((uint32_t)buffer[3] << 8u) | (uint32_t)buffer[4];
+
+  return FRAME_STATS_RECORD_SIZE;
+}
+
+inline Frame_return core_frame_LOG(const Frame_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define FRAME_RETURN(enumerate)   \
+        case enumerate:                 \
+          if(ret > 0)                   \
+          {                             \
+            CORE_LOGE(TAG, #enumerate); \
+          }                             \
+          else                          \
+          {                             \
+            CORE_LOGI(TAG, #enumerate); \
+          }                             \
+          break;
+        FRAME_RETURNS
+      #undef FRAME_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
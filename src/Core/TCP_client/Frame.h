@@ -0,0 +1,276 @@
+/**
+ * @file      Frame.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to encode and decode the frames
+ *            exchanged with the gateway.
+ *
+ *            Every frame starts with a header, all its fields are unsigned and the
+ *            multi-byte ones are big endian:
+ *
+ *              | version (1) | type (1) | sequence (2) | count (1) |
+ *
+ *            A commands frame carries count records after the header:
+ *
+ *              | LED ID (1) | action (1) | PWM (1) |
+ *
+ *            A state frame carries count records after the header, with the whole
+ *            state of the LEDs that the switch owns:
+ *
+ *              | LED ID (1) | on (1) | PWM (1) |
+ *
+ *            A stats frame carries count telemetry counters after the header, its
+ *            sequence is the number of the report and it is not acknowledged:
+ *
+ *              | counter ID (1) | value (4) |
+ *
+ *            An ack frame is only a header, its sequence is the one of the newest
+ *            commands frame that the gateway applied, and it acknowledges all the
+ *            previous ones too. Retransmitted frames keep their sequence, so the
+ *            gateway must ignore the frames whose sequence it already applied.
+ */
+
+#ifndef CORE_FRAME_H_
+#define CORE_FRAME_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Network_config.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module frame can return. */
+#define FRAME_RETURNS                               \
+  /* Info codes */                                  \
+  FRAME_RETURN(CORE_FRAME_OK)                       \
+  /* Error codes */                                 \
+  FRAME_RETURN(CORE_FRAME_TOO_SHORT_ERR)            \
+  FRAME_RETURN(CORE_FRAME_VERSION_ERR)              \
+  FRAME_RETURN(CORE_FRAME_TYPE_ERR)                 \
+  FRAME_RETURN(CORE_FRAME_LEN_ERR)
+
+/* Version of the wire format, a frame with other version is rejected. */
+#define FRAME_VERSION 1u
+
+/* Size in bytes of the frame header and of one command record. */
+#define FRAME_HEADER_SIZE     5u
+#define FRAME_CMD_RECORD_SIZE 3u
+
+/* Size in bytes of one state record. */
+#define FRAME_STATE_RECORD_SIZE 3u
+
+/* Size in bytes of a state frame that carries the given number of LEDs. */
+#define FRAME_STATE_SIZE(num_of_LEDs) \
+  (FRAME_HEADER_SIZE + ((num_of_LEDs)*FRAME_STATE_RECORD_SIZE))
+
+/* Size in bytes of one stats record. */
+#define FRAME_STATS_RECORD_SIZE 5u
+
+/* Size in bytes of a stats frame that carries the given number of records. */
+#define FRAME_STATS_SIZE(num_of_records) \
+  (FRAME_HEADER_SIZE + ((num_of_records)*FRAME_STATS_RECORD_SIZE))
+
+/* Size in bytes of an ack frame. */
+#define FRAME_ACK_SIZE FRAME_HEADER_SIZE
+
+/* Maximum number of records that a frame can carry. */
+#define FRAME_MAX_RECORDS UINT8_MAX
+
+/* Size in bytes of a commands frame that carries the given number of commands. */
+#define FRAME_CMDS_SIZE(num_of_cmds) \
+  (FRAME_HEADER_SIZE + ((num_of_cmds)*FRAME_CMD_RECORD_SIZE))
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define FRAME_RETURN(enumerate) enumerate,
+    FRAME_RETURNS
+  #undef FRAME_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_FRAME_RETURNS,
+} Frame_return;
+
+/* Enumerate that lists the types of frame. Their values are sent in the header, so
+ * they must not change.
+ */
+typedef enum
+{
+  /* The frame carries command records for the gateway. */
+  FRAME_TYPE_COMMANDS = 1u,
+  /* The gateway acknowledges the commands frames up to the sequence of the header. */
+  FRAME_TYPE_ACK = 2u,
+  /* The frame carries the state that the LEDs must have. */
+  FRAME_TYPE_STATE = 3u,
+  /* The frame carries the telemetry counters of the switch. */
+  FRAME_TYPE_STATS = 4u,
+} Frame_type;
+
+/* Structure that contains the decoded header of a frame. */
+typedef struct
+{
+  /* Version of the wire format. */
+  uint8_t version;
+  /* Type of the frame. */
+  Frame_type type;
+  /* Sequence number of the frame. */
+  uint16_t seq;
+  /* Number of records after the header. */
+  uint8_t count;
+} Frame_header;
+
+/* Structure that contains the state of a LED. */
+typedef struct
+{
+  /* Identifier of the LED. */
+  uint8_t ID;
+  /* Indicates if the LED is on. */
+  bool on;
+  /* Duty cycle of the LED in terms of percentage. */
+  uint8_t pwm;
+} Frame_state_record;
+
+/* Structure that contains a telemetry counter. */
+typedef struct
+{
+  /* Identifier of the counter. */
+  uint8_t ID;
+  /* Value of the counter. */
+  uint32_t value;
+} Frame_stats_record;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Encodes a frame header.
+ *
+ * @param buffer Where the header is written, at least FRAME_HEADER_SIZE bytes.
+ *
+ * @param type Type of the frame.
+ *
+ * @param seq Sequence number of the frame.
+ *
+ * @param count Number of records that follow the header.
+ *
+ * @return Number of bytes written.
+ */
+size_t encode_frame_header(uint8_t *buffer, const Frame_type type, const uint16_t seq,
+  const uint8_t count);
+
+/**
+ * @brief Encodes a command record.
+ *
+ * @param buffer Where the record is written, at least FRAME_CMD_RECORD_SIZE bytes.
+ *
+ * @param cmd Command to encode.
+ *
+ * @return Number of bytes written.
+ */
+size_t encode_cmd_record(uint8_t *buffer, const TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Encodes a state record.
+ *
+ * @param buffer Where the record is written, at least FRAME_STATE_RECORD_SIZE bytes.
+ *
+ * @param state State to encode.
+ *
+ * @return Number of bytes written.
+ */
+size_t encode_state_record(uint8_t *buffer, const Frame_state_record *state);
+
+/**
+ * @brief Encodes a stats record.
+ *
+ * @param buffer Where the record is written, at least FRAME_STATS_RECORD_SIZE bytes.
+ *
+ * @param stats Counter to encode.
+ *
+ * @return Number of bytes written.
+ */
+size_t encode_stats_record(uint8_t *buffer, const Frame_stats_record *stats);
+
+/**
+ * @brief Decodes and validates a frame header. The frame must contain all the records
+ *        that the header announces.
+ *
+ * @param buffer Received frame.
+ *
+ * @param len Number of received bytes.
+ *
+ * @param header Where the decoded header is stored.
+ *
+ * @return CORE_FRAME_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_FRAME_TOO_SHORT_ERR:
+ *               The buffer is shorter than a header.
+ *
+ *           - CORE_FRAME_VERSION_ERR:
+ *               The frame has other version of the wire format.
+ *
+ *           - CORE_FRAME_TYPE_ERR:
+ *               The frame has an unknown type.
+ *
+ *           - CORE_FRAME_LEN_ERR:
+ *               The buffer is shorter than the announced records.
+ */
+Frame_return decode_frame_header(const uint8_t *buffer, const size_t len,
+  Frame_header *header);
+
+/**
+ * @brief Decodes a command record.
+ *
+ * @param buffer Encoded record, FRAME_CMD_RECORD_SIZE bytes.
+ *
+ * @param cmd Where the decoded command is stored.
+ *
+ * @return Number of bytes read.
+ */
+size_t decode_cmd_record(const uint8_t *buffer, TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Decodes a state record.
+ *
+ * @param buffer Encoded record, FRAME_STATE_RECORD_SIZE bytes.
+ *
+ * @param state Where the decoded state is stored.
+ *
+ * @return Number of bytes read.
+ */
+size_t decode_state_record(const uint8_t *buffer, Frame_state_record *state);
+
+/**
+ * @brief Decodes a stats record.
+ *
+ * @param buffer Encoded record, FRAME_STATS_RECORD_SIZE bytes.
+ *
+ * @param stats Where the decoded counter is stored.
+ *
+ * @return Number of bytes read.
+ */
+size_t decode_stats_record(const uint8_t *buffer, Frame_stats_record *stats);
+
+/**
+ * @brief Prints the return of a frame module function if the system was configured in
+ *        debug mode.
+ *
+ * @param ret Received return from a frame module function.
+ *
+ * @return The given return.
+ */
+Frame_return core_frame_LOG(const Frame_return ret);
+
+#endif /* CORE_FRAME_H_ */
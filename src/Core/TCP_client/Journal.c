@@ -0,0 +1,366 @@
+/**
+ * @file      Journal.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions of the journal that keeps the
+ *            commands sent while the link is down, so they are replayed when it is
+ *            up again.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Journal.h>
+#include <System_network.h>
+#include <System_lights.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <freertos/FreeRTOS.h>
+#include <stdatomic.h>
+
+#if TCP_CLIENT_JOURNAL_STORAGE == JOURNAL_IN_RTC_MEMORY
+  #include <esp_attr.h>
+  #include <esp_rom_crc.h>
+#endif
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#if TCP_CLIENT_JOURNAL_STORAGE == JOURNAL_IN_RTC_MEMORY
+  /* Value that marks a valid journal in the RTC memory. */
+  #define RTC_JOURNAL_MAGIC 0x4A52u
+#endif
+
+/* Command of a journal ring at the given distance from its oldest one. */
+#define RING_SLOT(ring, offset) \
+  (ring)->cmds[((ring)->head + (offset)) % TCP_CLIENT_JOURNAL_LEN]
+
+/* Number of times that a task tries to tidy the journal while the ISRs change it. */
+#define TIDY_ATTEMPTS 3u
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core journal module. */
+  #define TAG "CORE_JOURNAL"
+#endif
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Ring buffer that keeps the commands in the order they were sent. */
+typedef struct
+{
+  TCP_COMMAND_TYPE cmds[TCP_CLIENT_JOURNAL_LEN];
+  /* Index of the oldest command. */
+  uint32_t head;
+  /* Number of commands in the journal. */
+  uint32_t count;
+} journal_ring;
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+#if TCP_CLIENT_JOURNAL_STORAGE == JOURNAL_IN_RTC_MEMORY
+  /* Journal kept in the RTC memory, it survives resets and deep sleep but not a power
+   * loss. Its content is not initialized on boot, so it is validated with a CRC.
+   */
+  static RTC_NOINIT_ATTR journal_ring journal;
+  static RTC_NOINIT_ATTR uint32_t journal_magic;
+  static RTC_NOINIT_ATTR uint32_t journal_CRC;
+#else
+  static journal_ring journal;
+#endif
+
+/* Spinlock to ensure atomicity between the tasks and the ISRs that use the journal.
+ * It is only held to copy the commands, never to compact them nor to get the CRC.
+ */
+static portMUX_TYPE journal_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Number of changes of the journal, so a task that tidies a copy of the journal can
+ * tell if it changed meanwhile. It is only accessed with the journal lock taken.
+ */
+static uint32_t journal_generation;
+
+/* Copy of the journal where it is tidied, out of the journal lock. */
+static journal_ring journal_scratch;
+
+/* Flag that indicates if a task is tidying the journal, it owns journal_scratch. */
+static _Atomic bool journal_is_tidying;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Applies the LED coalescing rules to a journal ring: the commands of every LED
+ *        are replaced by, at most, one toggle and its newest duty cycle. The commands
+ *        that the rules do not cover keep their order.
+ *
+ * @param ring Ring to compact.
+ *
+ * @return void
+ */
+static void compact_ring(journal_ring *ring);
+
+/**
+ * @brief Compacts the journal if it is asked and marks its content as valid after a
+ *        change. The work is done in a copy, out of the journal lock, and the copy
+ *        only replaces the journal if no ISR changed it meanwhile. If another task is
+ *        tidying the journal, it does nothing, that task takes the change. It can not
+ *        be called from ISR.
+ *
+ * @param compact True to compact the journal.
+ *
+ * @return void
+ */
+static void tidy_journal(const bool compact);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Journal_return init_journal(void)
+{
+
+  portENTER_CRITICAL(&journal_lock);
+
+  #if TCP_CLIENT_JOURNAL_STORAGE == JOURNAL_IN_RTC_MEMORY
+    /* Keep the journal of the previous boot if it is intact. */
+    if(journal_magic != RTC_JOURNAL_MAGIC ||
+       journal_CRC != esp_rom_crc32_le(0u, (const uint8_t *)&journal, 
+                                       sizeof(journal)) ||
+       journal.head >= TCP_CLIENT_JOURNAL_LEN || journal.count > TCP_CLIENT_JOURNAL_LEN)
+    {
+      journal.head = 0u;
+      journal.count = 0u;
+      journal_CRC = esp_rom_crc32_le(0u, (const uint8_t *)&journal, sizeof(journal));
+      journal_magic = RTC_JOURNAL_MAGIC;
+    }
+  #else
+    journal.head = 0u;
+    journal.count = 0u;
+  #endif
+
+  portEXIT_CRITICAL(&journal_lock);
+
+  return CORE_JOURNAL_OK;
+}
+
+Journal_return append_to_journal(const TCP_COMMAND_TYPE *cmd)
+{
+
+  Journal_return ret = CORE_JOURNAL_OK;
+  const bool from_ISR = xPortInIsrContext();
+
+  /* From a task, a full journal is compacted first. An ISR only appends. */
+  if(!from_ISR)
+  {
+    portENTER_CRITICAL(&journal_lock);
+    const bool is_full = (journal.count == TCP_CLIENT_JOURNAL_LEN);
+    portEXIT_CRITICAL(&journal_lock);
+    if(is_full)
+    {
+      tidy_journal(true);
+    }
+  }
+
+  portENTER_CRITICAL_SAFE(&journal_lock);
+
+  /* Still full, the oldest command makes room for the given one. */
+  if(journal.count == TCP_CLIENT_JOURNAL_LEN)
+  {
+    journal.head = (journal.head + 1u) % TCP_CLIENT_JOURNAL_LEN;
+    journal.count--;
+    ret = CORE_JOURNAL_DROPPED_OLDEST_WARN;
+  }
+
+  RING_SLOT(&journal, journal.count) = *cmd;
+  journal.count++;
+  journal_generation++;
+
+  portEXIT_CRITICAL_SAFE(&journal_lock);
+
+  /* The appends of an ISR are sealed by the next task that changes the journal. */
+  if(!from_ISR)
+  {
+    tidy_journal(false);
+  }
+
+  return ret;
+}
+
+size_t take_from_journal(TCP_COMMAND_TYPE *cmds, const size_t max_cmds)
+{
+
+  size_t num_of_cmds = 0u;
+
+  if(journal_is_empty())
+  {
+    return 0u;
+  }
+
+  tidy_journal(true);
+
+  portENTER_CRITICAL(&journal_lock);
+  while(num_of_cmds < max_cmds && journal.count > 0u)
+  {
+    cmds[num_of_cmds] = journal.cmds[journal.head];
+    journal.head = (journal.head + 1u) % TCP_CLIENT_JOURNAL_LEN;
+    journal.count--;
+    num_of_cmds++;
+  }
+  journal_generation++;
+  portEXIT_CRITICAL(&journal_lock);
+
+  tidy_journal(false);
+
+  return num_of_cmds;
+}
+
+bool journal_is_empty(void)
+{
+
+  portENTER_CRITICAL_SAFE(&journal_lock);
+  const bool is_empty = (journal.count == 0u);
+  portEXIT_CRITICAL_SAFE(&journal_lock);
+
+  return is_empty;
+}
+
+inline Journal_return core_journal_LOG(const Journal_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define JOURNAL_RETURN(enumerate) \
+        case enumerate:                 \
+          if(ret > 0)                   \
+          {                             \
+            CORE_LOGE(TAG, #enumerate); \
+          }                             \
+          else                          \
+          {                             \
+            CORE_LOGI(TAG, #enumerate); \
+          }                             \
+          break;
+        JOURNAL_RETURNS
+      #undef JOURNAL_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+static void compact_ring(journal_ring *ring)
+{
+
+  bool toggled[NUM_OF_LEDS] = {false};
+  bool has_PWM[NUM_OF_LEDS] = {false};
+  TCP_COMMAND_TYPE newest_PWM[NUM_OF_LEDS];
+  uint32_t num_of_cmds = 0u;
+
+  /* The kept commands are written behind the read position, so it is done in place. */
+  for(uint32_t i = 0u; i < ring->count; i++)
+  {
+    const TCP_COMMAND_TYPE cmd = RING_SLOT(ring, i);
+    if(cmd.ID < NUM_OF_LEDS && cmd.action == TOOGLE_LED)
+    {
+      toggled[cmd.ID] = !toggled[cmd.ID];
+    }
+    else if(cmd.ID < NUM_OF_LEDS && cmd.action == SET_PWM)
+    {
+      newest_PWM[cmd.ID] = cmd;
+      has_PWM[cmd.ID] = true;
+    }
+    else
+    {
+      RING_SLOT(ring, num_of_cmds) = cmd;
+      num_of_cmds++;
+    }
+  }
+
+  /* A LED only takes the room of the commands that it replaces. */
+  for(uint32_t LED = 0u; LED < NUM_OF_LEDS; LED++)
+  {
+    if(toggled[LED])
+    {
+      const TCP_COMMAND_TYPE toggle_cmd =
+      {
+        .ID = (LED_ID)LED,
+        .action = TOOGLE_LED,
+      };
+      RING_SLOT(ring, num_of_cmds) = toggle_cmd;
+      num_of_cmds++;
+    }
+    if(has_PWM[LED])
+    {
+      RING_SLOT(ring, num_of_cmds) = newest_PWM[LED];
+      num_of_cmds++;
+    }
+  }
+
+  ring->count = num_of_cmds;
+}
+
+static void tidy_journal(const bool compact)
+{
+
+  /* In RAM there is nothing to seal. */
+  #if TCP_CLIENT_JOURNAL_STORAGE != JOURNAL_IN_RTC_MEMORY
+    if(!compact)
+    {
+      return;
+    }
+  #endif
+
+  if(atomic_exchange_explicit(&journal_is_tidying, true, memory_order_acquire))
+  {
+    return;
+  }
+
+  for(uint32_t attempt = 0u; attempt < TIDY_ATTEMPTS; attempt++)
+  {
+    portENTER_CRITICAL(&journal_lock);
+    journal_scratch = journal;
+    const uint32_t generation = journal_generation;
+    portEXIT_CRITICAL(&journal_lock);
+
+    if(compact)
+    {
+      compact_ring(&journal_scratch);
+    }
+
+    #if TCP_CLIENT_JOURNAL_STORAGE == JOURNAL_IN_RTC_MEMORY
+      const uint32_t CRC = esp_rom_crc32_le(0u, (const uint8_t *)&journal_scratch,
+        sizeof(journal_scratch));
+    #endif
+
+    /* Only a copy of the current journal can replace it. */
+    portENTER_CRITICAL(&journal_lock);
+    const bool is_current = (generation == journal_generation);
+    if(is_current)
+    {
+      if(compact)
+      {
+        journal = journal_scratch;
+      }
+      #if TCP_CLIENT_JOURNAL_STORAGE == JOURNAL_IN_RTC_MEMORY
+        journal_CRC = CRC;
+        journal_magic = RTC_JOURNAL_MAGIC;
+      #endif
+    }
+    portEXIT_CRITICAL(&journal_lock);
+
+    if(is_current)
+    {
+      break;
+    }
+  }
+
+  atomic_store_explicit(&journal_is_tidying, false, memory_order_release);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file      Journal.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions of the journal that keeps the
+ *            commands sent while the link is down, so they are replayed when it is
+ *            up again.
+ */
+
+#ifndef CORE_JOURNAL_H_
+#define CORE_JOURNAL_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Network_config.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module journal can return. */
+#define JOURNAL_RETURNS                                   \
+  /* Info codes */                                        \
+  JOURNAL_RETURN(CORE_JOURNAL_OK)                         \
+  /* Error codes */                                       \
+  JOURNAL_RETURN(CORE_JOURNAL_DROPPED_OLDEST_WARN)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define JOURNAL_RETURN(enumerate) enumerate,
+    JOURNAL_RETURNS
+  #undef JOURNAL_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_JOURNAL_RETURNS,
+} Journal_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Initializes the journal. With the RTC memory storage, a valid journal of the
+ *        previous boot is kept, otherwise the journal starts empty.
+ *
+ * @param void
+ *
+ * @return CORE_JOURNAL_OK always.
+ */
+Journal_return init_journal(void);
+
+/**
+ * @brief Appends a command at the end of the journal. From a task, a full journal is
+ *        compacted first and the journal is sealed after the append. From an ISR, the
+ *        command is only appended, the next task that changes the journal seals it.
+ *        It can be called from ISR.
+ *
+ * @param cmd Command to append.
+ *
+ * @return CORE_JOURNAL_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_JOURNAL_DROPPED_OLDEST_WARN:
+ *               The journal was full after compacting it, the oldest command was
+ *               discarded to append the given one.
+ */
+Journal_return append_to_journal(const TCP_COMMAND_TYPE *cmd);
+
+/**
+ * @brief Compacts the journal and takes its oldest commands. A pair of toggles of a
+ *        LED cancels and only the newest duty cycle of a LED is kept.
+ *
+ * @param cmds Where the commands are copied.
+ *
+ * @param max_cmds Maximum number of commands to take.
+ *
+ * @return Number of commands taken, 0 if the journal is empty.
+ */
+size_t take_from_journal(TCP_COMMAND_TYPE *cmds, const size_t max_cmds);
+
+/**
+ * @brief Indicates if there are commands in the journal. It can be called from ISR.
+ *
+ * @param void
+ *
+ * @return True if the journal is empty, otherwise false.
+ */
+bool journal_is_empty(void);
+
+/**
+ * @brief Prints the return of a journal module function if the system was configured
+ *        in debug mode.
+ *
+ * @param ret Received return from a journal module function.
+ *
+ * @return The given return.
+ */
+Journal_return core_journal_LOG(const Journal_return ret);
+
+#endif /* CORE_JOURNAL_H_ */
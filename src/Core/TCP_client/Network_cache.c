@@ -0,0 +1,220 @@
+/**
+ * @file      Network_cache.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to store the last good
+ *            association and IP lease of the station, so it can reconnect without
+ *            scanning the channels nor asking for a DHCP lease.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Network_cache.h>
+#include <System_network.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if TCP_CLIENT_FAST_RECONNECT_STORAGE == NETWORK_CACHE_IN_NVS
+  #include <nvs_flash.h>
+  #include <nvs.h>
+#else
+  #include <esp_attr.h>
+  #include <esp_rom_crc.h>
+#endif
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#if TCP_CLIENT_FAST_RECONNECT_STORAGE == NETWORK_CACHE_IN_NVS
+  /* Namespace and key of the record in the NVS. */
+  #define NVS_NAMESPACE "net_cache"
+  #define NVS_KEY       "record"
+#else
+  /* Value that marks a valid record in the RTC memory. */
+  #define RTC_RECORD_MAGIC 0x4E43u
+#endif
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core network cache module. */
+  #define TAG "CORE_NETWORK_CACHE"
+#endif
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+#if TCP_CLIENT_FAST_RECONNECT_STORAGE == NETWORK_CACHE_IN_RTC_MEMORY
+  /* Record kept in the RTC memory, it survives resets and deep sleep but not a power
+   * loss. Its content is not initialized on boot, so it is validated with a CRC.
+   */
+  static RTC_NOINIT_ATTR Network_cache_record RTC_record;
+  static RTC_NOINIT_ATTR uint32_t RTC_record_magic;
+  static RTC_NOINIT_ATTR uint32_t RTC_record_CRC;
+#endif
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Network_cache_return load_network_cache(Network_cache_record *record)
+{
+
+  #if TCP_CLIENT_FAST_RECONNECT_STORAGE == NETWORK_CACHE_IN_NVS
+
+    /* The NVS could not be initialized yet, it does nothing if it already is. */
+    if(nvs_flash_init() != ESP_OK)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+    nvs_handle_t handle;
+    const esp_err_t open_ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    if(open_ret == ESP_ERR_NVS_NOT_FOUND)
+    {
+      return CORE_NETWORK_CACHE_EMPTY_WARN;
+    }
+    else if(open_ret != ESP_OK)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+    size_t len = sizeof(*record);
+    const esp_err_t get_ret = nvs_get_blob(handle, NVS_KEY, record, &len);
+    nvs_close(handle);
+
+    if(get_ret == ESP_ERR_NVS_NOT_FOUND || (get_ret == ESP_OK && len != sizeof(*record)))
+    {
+      return CORE_NETWORK_CACHE_EMPTY_WARN;
+    }
+    else if(get_ret != ESP_OK)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+  #else
+
+    if(RTC_record_magic != RTC_RECORD_MAGIC ||
+       RTC_record_CRC != esp_rom_crc32_le(0u, (const uint8_t *)&RTC_record,
+                                         sizeof(RTC_record)))
+    {
+      return CORE_NETWORK_CACHE_EMPTY_WARN;
+    }
+
+    *record = RTC_record;
+
+  #endif
+
+  /* A record without address can not be used. */
+  if(record->ip_info.ip.addr == 0u || record->ip_info.gw.addr == 0u)
+  {
+    return CORE_NETWORK_CACHE_EMPTY_WARN;
+  }
+
+  return CORE_NETWORK_CACHE_OK;
+}
+
+Network_cache_return store_network_cache(const Network_cache_record *record)
+{
+
+  /* Avoid rewriting the same record, the NVS lives in flash. */
+  Network_cache_record stored_record;
+  if(load_network_cache(&stored_record) == CORE_NETWORK_CACHE_OK &&
+     memcmp(&stored_record, record, sizeof(*record)) == 0)
+  {
+    return CORE_NETWORK_CACHE_OK;
+  }
+
+  #if TCP_CLIENT_FAST_RECONNECT_STORAGE == NETWORK_CACHE_IN_NVS
+
+    nvs_handle_t handle;
+    if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+    const bool stored = (nvs_set_blob(handle, NVS_KEY, record, sizeof(*record)) == ESP_OK)
+                        && (nvs_commit(handle) == ESP_OK);
+    nvs_close(handle);
+
+    if(!stored)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+  #else
+
+    RTC_record = *record;
+    RTC_record_CRC = esp_rom_crc32_le(0u, (const uint8_t *)&RTC_record,
+                                      sizeof(RTC_record));
+    RTC_record_magic = RTC_RECORD_MAGIC;
+
+  #endif
+
+  return CORE_NETWORK_CACHE_OK;
+}
+
+Network_cache_return invalidate_network_cache(void)
+{
+
+  #if TCP_CLIENT_FAST_RECONNECT_STORAGE == NETWORK_CACHE_IN_NVS
+
+    nvs_handle_t handle;
+    const esp_err_t open_ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if(open_ret == ESP_ERR_NVS_NOT_FOUND)
+    {
+      return CORE_NETWORK_CACHE_OK;
+    }
+    else if(open_ret != ESP_OK)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+    const esp_err_t erase_ret = nvs_erase_key(handle, NVS_KEY);
+    const bool erased = (erase_ret == ESP_OK || erase_ret == ESP_ERR_NVS_NOT_FOUND) &&
+                        (nvs_commit(handle) == ESP_OK);
+    nvs_close(handle);
+
+    if(!erased)
+    {
+      return CORE_NETWORK_CACHE_STORAGE_ERR;
+    }
+
+  #else
+
+    RTC_record_magic = 0u;
+
+  #endif
+
+  return CORE_NETWORK_CACHE_OK;
+}
+
+inline Network_cache_return core_network_cache_LOG(const Network_cache_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define NETWORK_CACHE_RETURN(enumerate) \
+        case enumerate:                       \
+          if(ret > 0)                         \
+          {                                   \
+            CORE_LOGE(TAG, #enumerate);       \
+          }                                   \
+          else                                \
+          {                                   \
+            CORE_LOGI(TAG, #enumerate);       \
+          }                                   \
+          break;
+        NETWORK_CACHE_RETURNS
+      #undef NETWORK_CACHE_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file      Network_cache.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to store the last good
+ *            association and IP lease of the station, so it can reconnect without
+ *            scanning the channels nor asking for a DHCP lease.
+ */
+
+#ifndef CORE_NETWORK_CACHE_H_
+#define CORE_NETWORK_CACHE_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <esp_netif.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module network cache can return. */
+#define NETWORK_CACHE_RETURNS                               \
+  /* Info codes */                                          \
+  NETWORK_CACHE_RETURN(CORE_NETWORK_CACHE_OK)               \
+  /* Error codes */                                         \
+  NETWORK_CACHE_RETURN(CORE_NETWORK_CACHE_EMPTY_WARN)       \
+  NETWORK_CACHE_RETURN(CORE_NETWORK_CACHE_STORAGE_ERR)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define NETWORK_CACHE_RETURN(enumerate) enumerate,
+    NETWORK_CACHE_RETURNS
+  #undef NETWORK_CACHE_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_NETWORK_CACHE_RETURNS,
+} Network_cache_return;
+
+/* Structure that contains the last good association and IP lease of the station. */
+typedef struct
+{
+  /* MAC of the access point. */
+  uint8_t bssid[6];
+  /* WiFi channel of the access point. */
+  uint8_t channel;
+  /* IP, netmask and gateway of the lease. */
+  esp_netif_ip_info_t ip_info;
+  /* Main DNS server of the lease. */
+  esp_ip4_addr_t dns;
+} Network_cache_record;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Loads the last good association and IP lease.
+ *
+ * @param record Where the stored record is copied.
+ *
+ * @return CORE_NETWORK_CACHE_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_NETWORK_CACHE_EMPTY_WARN:
+ *               There is not a valid record stored.
+ *
+ *           - CORE_NETWORK_CACHE_STORAGE_ERR:
+ *               The storage could not be read.
+ */
+Network_cache_return load_network_cache(Network_cache_record *record);
+
+/**
+ * @brief Stores a good association and IP lease. Nothing is written if the stored
+ *        record is the same.
+ *
+ * @param record Record to store.
+ *
+ * @return CORE_NETWORK_CACHE_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_NETWORK_CACHE_STORAGE_ERR:
+ *               The storage could not be written.
+ */
+Network_cache_return store_network_cache(const Network_cache_record *record);
+
+/**
+ * @brief Invalidates the stored record, so the next association scans and asks for a
+ *        DHCP lease.
+ *
+ * @param void
+ *
+ * @return CORE_NETWORK_CACHE_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_NETWORK_CACHE_STORAGE_ERR:
+ *               The storage could not be written.
+ */
+Network_cache_return invalidate_network_cache(void);
+
+/**
+ * @brief Prints the return of a network cache module function if the system was
+ *        configured in debug mode.
+ *
+ * @param ret Received return from a network cache module function.
+ *
+ * @return The given return.
+ */
+Network_cache_return core_network_cache_LOG(const Network_cache_return ret);
+
+#endif /* CORE_NETWORK_CACHE_H_ */
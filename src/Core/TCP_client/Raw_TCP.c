@@ -0,0 +1,513 @@
+/**
+ * @file      Raw_TCP.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to keep the session with the
+ *            gateway over the raw TCP API of lwIP. It is only compiled with
+ *            TCP_CLIENT_LWIP_RAW.
+ *
+ *            The callbacks of lwIP run in the tcpip thread with the core lock, and
+ *            the functions of the module take the same lock, so the session and the
+ *            pool are only touched with it.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Raw_TCP.h>
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+
+#include <System_memory.h>
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <freertos/event_groups.h>
+#include <lwip/tcp.h>
+#include <lwip/tcpip.h>
+#include <stdbool.h>
+
+#if LWIP_TCPIP_CORE_LOCKING == 0
+  #error "The raw lwIP API is called from the TX task with the core lock:"
+  #error "refer to (CONFIG_LWIP_TCPIP_CORE_LOCKING) and (TCP_CLIENT_LWIP_API)"
+#endif
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* Bits of the session event group. The first one is set once the session connects,
+ * the second one once it is closed or fails, and the last one every time the gateway
+ * acknowledges bytes, so a slot or room in the send buffer could be free.
+ */
+#define CONNECTED_BIT BIT0
+#define CLOSED_BIT    BIT1
+#define SENT_BIT      BIT2
+
+/* Time in ticks that a write waits for room in the TCP send buffer. */
+#define SEND_TIME_OUT_TICKS pdMS_TO_TICKS(TCP_CLIENT_SEND_TIME_OUT_MS)
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core raw TCP module. */
+  #define TAG "CORE_RAW_TCP"
+#endif
+
+_Static_assert(TCP_CLIENT_RAW_SLOT_SIZE <= UINT16_MAX,
+  "A slot must fit in one tcp_write: refer to (TCP_CLIENT_RAW_SLOT_SIZE)");
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Pool of slots where the batches are built. The slots that lwIP holds are a ring that
+ * starts at pool_head, the next free one goes after them.
+ */
+static uint8_t pool[TCP_CLIENT_RAW_POOL_LEN][TCP_CLIENT_RAW_SLOT_SIZE];
+static uint32_t pool_head;
+static uint32_t pool_count;
+
+/* Bytes of the session sent until the end of every held slot, bytes sent in total
+ * and bytes acknowledged by the gateway. They wrap, only their differences are used.
+ */
+static uint32_t pool_slot_ends[TCP_CLIENT_RAW_POOL_LEN];
+static uint32_t sent_bytes;
+static uint32_t acked_bytes;
+
+/* Control block of the session, NULL if there is not one. */
+static struct tcp_pcb *session_pcb;
+
+/* Event group that lets the task of the session wait for the callbacks. */
+static EventGroupHandle_t raw_TCP_event_group;
+
+#if SYSTEM_STATIC_ALLOCATION == 1
+  /* Storage of the raw TCP event group. */
+  static StaticEventGroup_t raw_TCP_event_group_buffer;
+#endif
+
+/* Flag that indicates if the module was previously initialized or not. */
+static bool module_was_initialized;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Callback that lwIP calls when the session connects.
+ *
+ * @param arg Argument of the session, not used.
+ *
+ * @param pcb Control block of the session.
+ *
+ * @param err Always ERR_OK.
+ *
+ * @return ERR_OK.
+ */
+static err_t raw_TCP_connected_CB(void *arg, struct tcp_pcb *pcb, err_t err);
+
+/**
+ * @brief Callback that lwIP calls when the gateway acknowledges bytes. It releases the
+ *        slots whose bytes are all acknowledged.
+ *
+ * @param arg Argument of the session, not used.
+ *
+ * @param pcb Control block of the session.
+ *
+ * @param len Number of bytes acknowledged.
+ *
+ * @return ERR_OK.
+ */
+static err_t raw_TCP_sent_CB(void *arg, struct tcp_pcb *pcb, u16_t len);
+
+/**
+ * @brief Callback that lwIP calls when data arrives. The gateway does not send data,
+ *        it is discarded. If the gateway closed the session, it is aborted.
+ *
+ * @param arg Argument of the session, not used.
+ *
+ * @param pcb Control block of the session.
+ *
+ * @param p Received data, NULL if the gateway closed the session.
+ *
+ * @param err Always ERR_OK.
+ *
+ * @return ERR_OK, or ERR_ABRT if the session was aborted.
+ */
+static err_t raw_TCP_recv_CB(void *arg, struct tcp_pcb *pcb, struct pbuf *p,
+  err_t err);
+
+/**
+ * @brief Callback that lwIP calls when the session fails, its control block is already
+ *        freed.
+ *
+ * @param arg Argument of the session, not used.
+ *
+ * @param err Reason of the failure.
+ *
+ * @return void
+ */
+static void raw_TCP_err_CB(void *arg, err_t err);
+
+/**
+ * @brief Forgets the session and releases every slot of the pool. The next free slot
+ *        does not move. It must be called with the core lock.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void reset_session(void);
+
+/**
+ * @brief Writes data in the session and pushes it to the gateway, waiting for room in
+ *        the TCP send buffer if it is full.
+ *
+ * @param buffer Data to write.
+ *
+ * @param len Number of bytes to write.
+ *
+ * @param flags TCP_WRITE_FLAG_COPY if lwIP must copy the data, 0 if it is a slot.
+ *
+ * @return The same codes than send_raw_TCP_slot.
+ */
+static Raw_TCP_return write_session(const uint8_t *buffer, const size_t len,
+  const u8_t flags);
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+Raw_TCP_return init_raw_TCP(void)
+{
+
+  if(module_was_initialized)
+  {
+    return CORE_RAW_TCP_OK;
+  }
+
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    raw_TCP_event_group = xEventGroupCreateStatic(&raw_TCP_event_group_buffer);
+  #else
+    raw_TCP_event_group = xEventGroupCreate();
+  #endif
+  if(raw_TCP_event_group == NULL)
+  {
+    return CORE_RAW_TCP_INIT_EVENT_GROUP_ERR;
+  }
+
+  module_was_initialized = true;
+
+  return CORE_RAW_TCP_OK;
+}
+
+Raw_TCP_return open_raw_TCP(const uint32_t IP, const uint16_t port)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_RAW_TCP_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  close_raw_TCP();
+  xEventGroupClearBits(raw_TCP_event_group, CONNECTED_BIT | CLOSED_BIT);
+
+  err_t err = ERR_MEM;
+
+  LOCK_TCPIP_CORE();
+  struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_V4);
+  if(pcb != NULL)
+  {
+    tcp_arg(pcb, NULL);
+    tcp_err(pcb, raw_TCP_err_CB);
+    tcp_recv(pcb, raw_TCP_recv_CB);
+    tcp_sent(pcb, raw_TCP_sent_CB);
+
+    /* Send each batch as soon as it is written instead of waiting to merge it. */
+    tcp_nagle_disable(pcb);
+
+    /* Detect dead sessions while the switch is idle. */
+    #if LWIP_TCP_KEEPALIVE
+      ip_set_option(pcb, SOF_KEEPALIVE);
+      pcb->keep_idle = TCP_CLIENT_KEEPALIVE_IDLE_S*1000u;
+      pcb->keep_intvl = TCP_CLIENT_KEEPALIVE_INTERVAL_S*1000u;
+      pcb->keep_cnt = TCP_CLIENT_KEEPALIVE_COUNT;
+    #endif
+
+    const ip_addr_t gateway_IP = IPADDR4_INIT(IP);
+    err = tcp_connect(pcb, &gateway_IP, port, raw_TCP_connected_CB);
+    if(err == ERR_OK)
+    {
+      session_pcb = pcb;
+    }
+    else
+    {
+      /* The control block never left the closed state, it is only freed. */
+      tcp_close(pcb);
+    }
+  }
+  UNLOCK_TCPIP_CORE();
+
+  return (err == ERR_OK) ? CORE_RAW_TCP_OK : CORE_RAW_TCP_CONNECT_ERR;
+}
+
+Raw_TCP_return wait_for_raw_TCP(const TickType_t time_to_wait)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_RAW_TCP_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  const EventBits_t bits = xEventGroupWaitBits(raw_TCP_event_group,
+    CONNECTED_BIT | CLOSED_BIT, pdFALSE, pdFALSE, time_to_wait);
+
+  if((bits & CLOSED_BIT) != 0u)
+  {
+    return CORE_RAW_TCP_CLOSED_ERR;
+  }
+
+  return ((bits & CONNECTED_BIT) != 0u) ? CORE_RAW_TCP_OK :
+    CORE_RAW_TCP_CONNECTING_WARN;
+}
+
+Raw_TCP_return close_raw_TCP(void)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_RAW_TCP_OK;
+  }
+
+  LOCK_TCPIP_CORE();
+  if(session_pcb != NULL)
+  {
+    /* A graceful close would keep sending from the slots after they are released. */
+    tcp_err(session_pcb, NULL);
+    tcp_abort(session_pcb);
+  }
+  reset_session();
+  UNLOCK_TCPIP_CORE();
+
+  xEventGroupSetBits(raw_TCP_event_group, CLOSED_BIT);
+
+  return CORE_RAW_TCP_OK;
+}
+
+uint8_t *next_raw_TCP_slot(const TickType_t time_to_wait)
+{
+
+  if(!module_was_initialized)
+  {
+    return NULL;
+  }
+
+  /* Cleared before looking at the pool, so a release in between is not missed. */
+  xEventGroupClearBits(raw_TCP_event_group, SENT_BIT);
+
+  LOCK_TCPIP_CORE();
+  bool is_full = (pool_count == TCP_CLIENT_RAW_POOL_LEN);
+  UNLOCK_TCPIP_CORE();
+
+  if(is_full)
+  {
+    xEventGroupWaitBits(raw_TCP_event_group, SENT_BIT | CLOSED_BIT, pdFALSE, pdFALSE,
+      time_to_wait);
+
+    LOCK_TCPIP_CORE();
+    is_full = (pool_count == TCP_CLIENT_RAW_POOL_LEN);
+    UNLOCK_TCPIP_CORE();
+  }
+
+  /* Only this task moves the next slot, the callbacks only release held ones. */
+  return is_full ? NULL : pool[(pool_head + pool_count) % TCP_CLIENT_RAW_POOL_LEN];
+}
+
+Raw_TCP_return send_raw_TCP_slot(const size_t len)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_RAW_TCP_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  if(len > TCP_CLIENT_RAW_SLOT_SIZE)
+  {
+    return CORE_RAW_TCP_WRITE_ERR;
+  }
+
+  LOCK_TCPIP_CORE();
+  const bool is_full = (pool_count == TCP_CLIENT_RAW_POOL_LEN);
+  const uint8_t *slot = pool[(pool_head + pool_count) % TCP_CLIENT_RAW_POOL_LEN];
+  UNLOCK_TCPIP_CORE();
+
+  if(is_full)
+  {
+    return CORE_RAW_TCP_WRITE_ERR;
+  }
+
+  return write_session(slot, len, 0u);
+}
+
+Raw_TCP_return send_raw_TCP_copy(const uint8_t *buffer, const size_t len)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_RAW_TCP_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  if(len > UINT16_MAX)
+  {
+    return CORE_RAW_TCP_WRITE_ERR;
+  }
+
+  return write_session(buffer, len, TCP_WRITE_FLAG_COPY);
+}
+
+inline Raw_TCP_return core_raw_TCP_LOG(const Raw_TCP_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define RAW_TCP_RETURN(enumerate) \
+        case enumerate:                 \
+          if(ret > 0)                   \
+          {                             \
+            CORE_LOGE(TAG, #enumerate); \
+          }                             \
+          else                          \
+          {                             \
+            CORE_LOGI(TAG, #enumerate); \
+          }                             \
+          break;
+        RAW_TCP_RETURNS
+      #undef RAW_TCP_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+static err_t raw_TCP_connected_CB(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+
+  xEventGroupSetBits(raw_TCP_event_group, CONNECTED_BIT);
+
+  return ERR_OK;
+}
+
+static err_t raw_TCP_sent_CB(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+
+  acked_bytes += len;
+
+  /* The gateway acknowledges the bytes in order, so the slots are released in
+   * order too.
+   */
+  while(pool_count > 0u && (int32_t)(acked_bytes - pool_slot_ends[pool_head]) >= 0)
+  {
+    pool_head = (pool_head + 1u) % TCP_CLIENT_RAW_POOL_LEN;
+    pool_count--;
+  }
+
+  xEventGroupSetBits(raw_TCP_event_group, SENT_BIT);
+
+  return ERR_OK;
+}
+
+static err_t raw_TCP_recv_CB(void *arg, struct tcp_pcb *pcb, struct pbuf *p,
+  err_t err)
+{
+
+  if(p == NULL)
+  {
+    /* The gateway closed the session, the bytes it did not acknowledge are lost. */
+    tcp_err(pcb, NULL);
+    tcp_abort(pcb);
+    reset_session();
+    xEventGroupSetBits(raw_TCP_event_group, CLOSED_BIT);
+    return ERR_ABRT;
+  }
+
+  tcp_recved(pcb, p->tot_len);
+  pbuf_free(p);
+
+  return ERR_OK;
+}
+
+static void raw_TCP_err_CB(void *arg, err_t err)
+{
+
+  reset_session();
+  xEventGroupSetBits(raw_TCP_event_group, CLOSED_BIT);
+
+  #if DEBUG_MODE_ENABLE == 1
+    CORE_LOGE_ARG(TAG, "Session failed: err %d", (int)err);
+  #endif
+}
+
+static void reset_session(void)
+{
+
+  session_pcb = NULL;
+
+  /* The slot that is being built stays the next one. */
+  pool_head = (pool_head + pool_count) % TCP_CLIENT_RAW_POOL_LEN;
+  pool_count = 0u;
+  sent_bytes = 0u;
+  acked_bytes = 0u;
+}
+
+static Raw_TCP_return write_session(const uint8_t *buffer, const size_t len,
+  const u8_t flags)
+{
+
+  TimeOut_t send_time_out;
+  TickType_t ticks_to_wait = SEND_TIME_OUT_TICKS;
+  vTaskSetTimeOutState(&send_time_out);
+
+  while(true)
+  {
+    /* Cleared before writing, so an acknowledge in between is not missed. */
+    xEventGroupClearBits(raw_TCP_event_group, SENT_BIT);
+
+    LOCK_TCPIP_CORE();
+    err_t err = ERR_CONN;
+    if(session_pcb != NULL)
+    {
+      err = tcp_write(session_pcb, buffer, (u16_t)len, flags);
+      if(err == ERR_OK)
+      {
+        sent_bytes += (uint32_t)len;
+        if(flags == 0u)
+        {
+          pool_slot_ends[(pool_head + pool_count) % TCP_CLIENT_RAW_POOL_LEN] =
+            sent_bytes;
+          pool_count++;
+        }
+        tcp_output(session_pcb);
+      }
+    }
+    UNLOCK_TCPIP_CORE();
+
+    if(err == ERR_OK)
+    {
+      return CORE_RAW_TCP_OK;
+    }
+    if(err != ERR_MEM)
+    {
+      return (err == ERR_CONN) ? CORE_RAW_TCP_CLOSED_ERR : CORE_RAW_TCP_WRITE_ERR;
+    }
+
+    /* The send buffer is full, wait until the gateway acknowledges some bytes. */
+    if(xTaskCheckForTimeOut(&send_time_out, &ticks_to_wait) != pdFALSE ||
+       (xEventGroupWaitBits(raw_TCP_event_group, SENT_BIT | CLOSED_BIT, pdFALSE,
+          pdFALSE, ticks_to_wait) & SENT_BIT) == 0u)
+    {
+      return CORE_RAW_TCP_WRITE_ERR;
+    }
+  }
+}
+
+#endif /* TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW */
@@ -0,0 +1,169 @@
+/**
+ * @file      Raw_TCP.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to keep the session with the
+ *            gateway over the raw TCP API of lwIP. The batches are built in a pool
+ *            of preallocated slots and lwIP sends them from there without copying
+ *            them, a slot is reused once the gateway acknowledges all its bytes at
+ *            TCP level. Only one task can use the session.
+ */
+
+#ifndef CORE_RAW_TCP_H_
+#define CORE_RAW_TCP_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_network.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module raw TCP can return. */
+#define RAW_TCP_RETURNS                                   \
+  /* Info codes */                                        \
+  RAW_TCP_RETURN(CORE_RAW_TCP_OK)                         \
+  /* Error codes */                                       \
+  RAW_TCP_RETURN(CORE_RAW_TCP_INIT_EVENT_GROUP_ERR)       \
+  RAW_TCP_RETURN(CORE_RAW_TCP_CONNECT_ERR)                \
+  RAW_TCP_RETURN(CORE_RAW_TCP_CLOSED_ERR)                 \
+  RAW_TCP_RETURN(CORE_RAW_TCP_WRITE_ERR)                  \
+  RAW_TCP_RETURN(CORE_RAW_TCP_MODULE_WAS_NOT_INIT_ERR)    \
+  RAW_TCP_RETURN(CORE_RAW_TCP_CONNECTING_WARN)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define RAW_TCP_RETURN(enumerate) enumerate,
+    RAW_TCP_RETURNS
+  #undef RAW_TCP_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_RAW_TCP_RETURNS,
+} Raw_TCP_return;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Initializes the raw TCP module. It can not be called from ISR.
+ *
+ * @param void
+ *
+ * @return CORE_RAW_TCP_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_RAW_TCP_INIT_EVENT_GROUP_ERR:
+ *               Error trying to create the event group of the session.
+ */
+Raw_TCP_return init_raw_TCP(void);
+
+/**
+ * @brief Starts the connection of a new session with TCP_NODELAY and keepalive. The
+ *        previous session is closed. It does not wait for the connection, see
+ *        wait_for_raw_TCP.
+ *
+ * @param IP IPv4 address of the gateway, in network byte order.
+ *
+ * @param port Port of the gateway, in host byte order.
+ *
+ * @return CORE_RAW_TCP_OK if the connection started,
+ *         otherwise:
+ *
+ *           - CORE_RAW_TCP_MODULE_WAS_NOT_INIT_ERR:
+ *               Module was not initialized before.
+ *
+ *           - CORE_RAW_TCP_CONNECT_ERR:
+ *               lwIP could not create the session or send its SYN.
+ */
+Raw_TCP_return open_raw_TCP(const uint32_t IP, const uint16_t port);
+
+/**
+ * @brief Waits until the session that open_raw_TCP started is connected.
+ *
+ * @param time_to_wait Maximum time in ticks to wait.
+ *
+ * @return CORE_RAW_TCP_OK if the session is connected,
+ *         otherwise:
+ *
+ *           - CORE_RAW_TCP_CLOSED_ERR:
+ *               The connection failed or the session was closed.
+ *
+ *           - CORE_RAW_TCP_CONNECTING_WARN:
+ *               The session is still connecting.
+ */
+Raw_TCP_return wait_for_raw_TCP(const TickType_t time_to_wait);
+
+/**
+ * @brief Aborts the session, the bytes that the gateway did not acknowledge yet are
+ *        lost and every slot of the pool is released. The slot returned by
+ *        next_raw_TCP_slot stays the next one.
+ *
+ * @param void
+ *
+ * @return CORE_RAW_TCP_OK.
+ */
+Raw_TCP_return close_raw_TCP(void);
+
+/**
+ * @brief Gets the slot where the next batch must be built. It is the same slot until
+ *        it is sent with send_raw_TCP_slot.
+ *
+ * @param time_to_wait Maximum time in ticks to wait for a slot while lwIP holds every
+ *                     one.
+ *
+ * @return The slot, of TCP_CLIENT_RAW_SLOT_SIZE bytes, or NULL if every slot is still
+ *         held.
+ */
+uint8_t *next_raw_TCP_slot(const TickType_t time_to_wait);
+
+/**
+ * @brief Sends the slot returned by next_raw_TCP_slot without copying it. The slot
+ *        must not be written until it is released. While the TCP send buffer is full
+ *        it waits up to TCP_CLIENT_SEND_TIME_OUT_MS.
+ *
+ * @param len Number of bytes of the slot to send.
+ *
+ * @return CORE_RAW_TCP_OK if lwIP took the slot,
+ *         otherwise:
+ *
+ *           - CORE_RAW_TCP_CLOSED_ERR:
+ *               The session is not connected.
+ *
+ *           - CORE_RAW_TCP_WRITE_ERR:
+ *               The TCP send buffer stayed full or lwIP refused the data.
+ */
+Raw_TCP_return send_raw_TCP_slot(const size_t len);
+
+/**
+ * @brief Sends a buffer that is not a slot of the pool, lwIP copies it.
+ *
+ * @param buffer Data to send.
+ *
+ * @param len Number of bytes to send.
+ *
+ * @return The same codes than send_raw_TCP_slot.
+ */
+Raw_TCP_return send_raw_TCP_copy(const uint8_t *buffer, const size_t len);
+
+/**
+ * @brief Prints the return of a raw TCP module function if the system was configured
+ *        in debug mode.
+ *
+ * @param ret Received return from a raw TCP module function.
+ *
+ * @return The given return.
+ */
+Raw_TCP_return core_raw_TCP_LOG(const Raw_TCP_return ret);
+
+#endif /* CORE_RAW_TCP_H_ */
@@ -11,9 +11,22 @@
  * Includes
  ***************************************************************************************/
 #include <TCP_client.h>
+#include <Network_cache.h>
+#include <Frame.h>
+#include <Journal.h>
+#include <Espnow.h>
+#include <Latency.h>
+#include <Telemetry.h>
+#include <Power.h>
+#include <System_network.h>
+#include <System_lights.h>
+#include <System_memory.h>
+#include <System_tasks.h>
 #include <WiFi.h>
 #include <Debug.h>
+#include <Deferred_log.h>
 #include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
 #include <esp_netif.h>
 #include <esp_wifi.h>
 #include <lwip/err.h>
@@ -21,6 +34,22 @@
 #include <lwip/sys.h>
 #include <lwip/netdb.h>
 #include <lwip/dns.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+  #include <esp_now.h>
+#endif
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+  #include <Raw_TCP.h>
+#endif
+
+#if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+  #include <esp_random.h>
+#endif
 
 /***************************************************************************************
  * Defines
@@ -29,14 +58,196 @@
 /* Lenght of the commands TX queue. */
 #define RX_QUEUE_LEN 10u
 
-/* Maximum time in milliseconds to wait to perform a send operation. */
-#define MAX_TIME_TO_WAIT_TO_SEND 1000u/portTICK_PERIOD_MS
+/* A group is enqueued whole, so the biggest one must fit in the queue. */
+_Static_assert(TCP_CLIENT_TX_BATCH_LEN <= RX_QUEUE_LEN,
+  "A group must fit in the TX queue: refer to (TCP_CLIENT_TX_BATCH_LEN)");
+
+/* Size in bytes of the data that opens a batch and of every command of the batch. */
+#if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+  #define TX_HEADER_SIZE FRAME_HEADER_SIZE
+  #define TX_CMD_SIZE    FRAME_CMD_RECORD_SIZE
+  /* A state frame is placed in the same slots than a command frame. */
+  _Static_assert(FRAME_STATE_RECORD_SIZE == FRAME_CMD_RECORD_SIZE,
+    "A state record must have the size of a command record");
+#else
+  #define TX_HEADER_SIZE 0u
+  #define TX_CMD_SIZE    TCP_COMMAND_SIZE
+#endif
+
+/* Size in bytes of the biggest batch. */
+#define TX_BUFFER_SIZE (TX_HEADER_SIZE + (TCP_CLIENT_TX_BATCH_LEN*TX_CMD_SIZE))
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+  /* A batch travels in one ESP-NOW frame, it can not be split. */
+  _Static_assert(TX_BUFFER_SIZE <= ESP_NOW_MAX_DATA_LEN,
+    "A batch must fit in an ESP-NOW frame: refer to (TCP_CLIENT_TX_BATCH_LEN)");
+#endif
+
+/* Indicates if the station associates with the access point. Without it, only the
+ * ESP-NOW transport can reach the peers.
+ */
+#define STATION_ASSOCIATES (TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_ESPNOW || \
+  ESPNOW_WITH_STATION == 1)
+
+/* Time in ticks that the oldest frame waits for its ack and that the TX task waits for
+ * new commands while there are frames waiting for their ack.
+ */
+#define ACK_TIME_OUT_TICKS pdMS_TO_TICKS(TCP_CLIENT_ACK_TIME_OUT_MS)
+#define ACK_POLL_TICKS     pdMS_TO_TICKS(TCP_CLIENT_ACK_POLL_PERIOD_MS)
+
+/* Time in ticks that the TX task waits for more commands to join a batch. */
+#define TX_LINGER_TICKS pdMS_TO_TICKS(TCP_CLIENT_TX_LINGER_MS)
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+  /* Time in ticks between two copies of a datagram. A gap shorter than a tick would
+   * be 0 ticks and the copy would leave right after the datagram, so it is one tick
+   * at least. The TX task sends new batches while it waits.
+   */
+  #define UDP_SEND_GAP_TICKS                                                \
+    ((TCP_CLIENT_UDP_SEND_GAP_MS > 0u &&                                    \
+      pdMS_TO_TICKS(TCP_CLIENT_UDP_SEND_GAP_MS) == 0u) ?                    \
+      1u : pdMS_TO_TICKS(TCP_CLIENT_UDP_SEND_GAP_MS))
+#endif
+
+/* Time in ticks that the TX task waits for the next command of a group. The producer
+ * enqueues the group in a row, so it is only waited to let it finish.
+ */
+#define TX_GROUP_WAIT_TICKS ((TX_LINGER_TICKS > 0u) ? TX_LINGER_TICKS : 1u)
+
+/* Bits of the connection event group, one is set while the link is up and the other
+ * while it is down, so the tasks can wait for both transitions.
+ */
+#define LINK_UP_BIT   BIT0
+#define LINK_DOWN_BIT BIT1
+
+/* Bits of the TX task notification value. */
+#define TX_NEW_CMD_BIT   BIT0
+#define TX_LINK_DOWN_BIT BIT1
+
+/* Port of the gateway that receives the commands. */
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+  #define GATEWAY_PORT TCP_CLIENT_UDP_PORT
+#else
+  #define GATEWAY_PORT TCP_IP_PORT
+#endif
+
+/* Key of the default station network interface. */
+#define STA_NETIF_KEY "WIFI_STA_DEF"
+
+/* Period in milliseconds at which a connection in progress checks the link. */
+#define CONNECT_POLL_PERIOD_MS 100u
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+  /* Descriptor of the raw session, it only tells that the session is open. */
+  #define RAW_SESSION_FD 0
+
+  _Static_assert(TX_BUFFER_SIZE <= TCP_CLIENT_RAW_SLOT_SIZE,
+    "A batch must fit in a slot: refer to (TCP_CLIENT_RAW_SLOT_SIZE)");
+#endif
+
+/* Stack size in bytes of the TX task, its core and priority are in System_tasks.h. */
+#define TX_TASK_STACK_SIZE 2048u
+
+#if TELEMETRY_REPORT_PERIOD_MS > 0
+  /* Time in ticks between two stats frames, the TX task must block between them. */
+  #define TELEMETRY_REPORT_TICKS ((pdMS_TO_TICKS(TELEMETRY_REPORT_PERIOD_MS) > 0u) ? \
+    pdMS_TO_TICKS(TELEMETRY_REPORT_PERIOD_MS) : 1u)
+
+  /* Size in bytes of a stats frame with every telemetry value. */
+  #define STATS_BUFFER_SIZE FRAME_STATS_SIZE(NUM_OF_TELEMETRY_VALUES)
+
+  _Static_assert(NUM_OF_TELEMETRY_VALUES <= UINT8_MAX,
+    "The telemetry values must fit in the count of a frame header");
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+    _Static_assert(STATS_BUFFER_SIZE <= ESP_NOW_MAX_DATA_LEN,
+      "A stats frame must fit in an ESP-NOW frame: refer to (TELEMETRY_VALUES)");
+  #endif
+#endif
 
 #if DEBUG_MODE_ENABLE == 1
   /* Tag to show traces in core TCP module. */
   #define TAG "CORE_TCP_CLIENT"
 #endif
 
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the states of the connection with the gateway. */
+typedef enum
+{
+  /* The station is not associated to the access point. */
+  CONNECTION_DISCONNECTED,
+  /* The station is associated to the access point but it has no IP yet. */
+  CONNECTION_ASSOCIATED,
+  /* The station has an IP, the commands can be sent. */
+  CONNECTION_GOT_IP,
+  /* The TX task has a socket connected to the gateway. */
+  CONNECTION_SOCKET_READY,
+  /* The link was lost and the TX task is releasing its resources. */
+  CONNECTION_DRAINING,
+} connection_state_type;
+
+/* Enumerate that lists what an item of the TX queue carries. */
+typedef enum
+{
+  /* A command for a LED. */
+  TX_ITEM_CMD,
+  /* The state of a LED, part of a state snapshot. */
+  TX_ITEM_STATE,
+} TX_item_type;
+
+/* Structure that contains a command or a state waiting in the TX queue. */
+typedef struct
+{
+  /* What the item carries. A batch only joins items of the same type. */
+  TX_item_type type;
+  union
+  {
+    /* Command to send, if the type is TX_ITEM_CMD. */
+    TCP_COMMAND_TYPE cmd;
+    /* State to send, if the type is TX_ITEM_STATE. */
+    Frame_state_record state;
+  };
+  /* Number of items of the same group that follow this one in the queue. The TX
+   * task keeps a group in the same batch.
+   */
+  uint8_t group_left;
+  /* Identifier of the group, never 0. A lone item has 0. */
+  uint8_t group_ID;
+  #if SYSTEM_LATENCY_TRACE == 1
+    /* Time when the item was enqueued, taken with latency_now. */
+    uint32_t enqueue_us;
+    /* Time of the press that enqueued the item, taken with latency_origin. */
+    uint32_t press_us;
+  #endif
+} TX_item;
+
+/* Indicates if an item is a SET_PWM command, the only ones that are coalesced. */
+#define IS_PWM_ITEM(item) ((item).type == TX_ITEM_CMD && (item).cmd.action == SET_PWM)
+
+/* Indicates if an item is the next one of the group of the previous item. */
+#define CONTINUES_TX_GROUP(previous, item) ((previous).group_left > 0u &&   \
+  (item).group_ID == (previous).group_ID &&                                  \
+  (item).group_left == (previous).group_left - 1u)
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1
+  /* Structure that contains a frame written to the gateway and not acknowledged. */
+  typedef struct
+  {
+    /* Encoded frame. */
+    uint8_t frame[TX_BUFFER_SIZE];
+    /* Number of bytes of the frame. */
+    size_t len;
+    /* Sequence number of the frame. */
+    uint16_t seq;
+    /* Number of times that the ack of the frame timed out. */
+    uint8_t time_outs;
+    /* Tick at which the frame was written for the last time. */
+    TickType_t written_tick;
+  } in_flight_frame;
+#endif
+
 /***************************************************************************************
  * Global Variables
  ***************************************************************************************/
@@ -47,15 +258,164 @@ static TaskHandle_t send_cmd_task_handler;
 /* Handler of the queue where the commands will be allocated. .... */
 static QueueHandle_t cmd_TX_queue;
 
-/* Indicates if the client is connected to the server or not. */
-static bool connection_state;
+/* Counter that gives the identifier of every group enqueued. */
+static _Atomic uint32_t TX_group_seq;
 
-/* Semaphore to ensure atomizity in acces to connection_state variable. */
-static SemaphoreHandle_t connection_state_sempahore;
+/* State of the connection with the gateway. It is read without locking. */
+static _Atomic connection_state_type connection_state;
 
-/* Flag that indicates if the module was previously initialized or not. */
+/* Event group that lets the tasks block until the link is up (LINK_UP_BIT). */
+static EventGroupHandle_t connection_event_group;
+
+/* Flag that indicates if the RTOS objects of the module were created. They live as
+ * long as the system, so it is never cleared.
+ */
 static bool module_was_initialized;
 
+/* Flag that indicates if the WiFi was started, de_init_TCP_client clears it. */
+static bool WiFi_was_started;
+
+#if SYSTEM_STATIC_ALLOCATION == 1
+  /* Storage of the commands TX queue. */
+  static uint8_t cmd_TX_queue_storage[RX_QUEUE_LEN*sizeof(TX_item)];
+  static StaticQueue_t cmd_TX_queue_buffer;
+
+  /* Storage of the connection event group. */
+  static StaticEventGroup_t connection_event_group_buffer;
+
+  /* Stack and control block of the TX task. */
+  static StackType_t cmd_TX_task_stack[TX_TASK_STACK_SIZE];
+  static StaticTask_t cmd_TX_task_TCB;
+#endif
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+  /* Slot of the raw pool where the TX task places the batch of commands to write in
+   * one go, lwIP sends it from there.
+   */
+  static uint8_t *TX_buffer;
+#else
+  /* Buffer where the TX task places the batch of commands to write in one go. */
+  static uint8_t TX_buffer[TX_BUFFER_SIZE];
+#endif
+
+#if SYSTEM_LATENCY_TRACE == 1
+  /* Time when the TX task took the batch of the TX buffer, and time of the press of
+   * its oldest item.
+   */
+  static uint32_t TX_batch_take_us;
+  static uint32_t TX_batch_press_us;
+#endif
+
+#if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+  /* Sequence number of the next frame. A batch that is retried keeps its number. It
+   * starts at a random number, so the gateway does not take the frames after a reboot
+   * for copies of the ones it already applied.
+   */
+  static uint16_t TX_frame_seq;
+#endif
+
+#if TELEMETRY_REPORT_PERIOD_MS > 0
+  /* Buffer of the stats frames, a batch can be waiting in the TX buffer meanwhile. */
+  static uint8_t stats_buffer[STATS_BUFFER_SIZE];
+
+  /* Number of the next stats frame, and tick when the last one was sent. Only the TX
+   * task uses them.
+   */
+  static uint16_t stats_frame_seq;
+  static TickType_t last_report_tick;
+#endif
+
+#if TCP_CLIENT_OFFLINE_JOURNAL == 1
+  /* Indicates that a snapshot is queued behind the commands of the journal. The TX
+   * task replays the journal before the snapshot, so the commands sent meanwhile go to
+   * the TX queue, behind the snapshot, instead of the journal. It is cleared when the
+   * TX task takes the snapshot.
+   */
+  static _Atomic bool snapshot_closes_journal;
+#endif
+
+/* Address of the gateway, only the TX task uses it. */
+static struct sockaddr_in gateway_addr;
+
+#if TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_LEASE
+  /* Default gateway of the current IP lease, taken from IP_EVENT_STA_GOT_IP. It is
+   * in network byte order, 0 while there is no lease.
+   */
+  static _Atomic uint32_t lease_gateway_IP;
+#elif TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_DNS
+  /* Indicates if the gateway host name must be resolved again before using it. */
+  static _Atomic bool gateway_addr_is_stale = true;
+
+  /* Tick at which the gateway host name was resolved for the last time. */
+  static TickType_t gateway_addr_resolution_tick;
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP && TCP_CLIENT_UDP_MULTICAST == 1
+  /* Address of the multicast group of the gateways. */
+  static struct sockaddr_in UDP_group_addr;
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+  /* Last datagram, kept to send its copies while the TX task has nothing newer, the
+   * number of copies that are left and the tick of its last send. Only the TX task
+   * accesses them.
+   */
+  static uint8_t UDP_copy_buffer[TX_BUFFER_SIZE];
+  static size_t UDP_copy_len;
+  static uint8_t UDP_copies_left;
+  static TickType_t UDP_copy_tick;
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1
+  /* Ring of the frames waiting for their ack, ordered from the oldest. Only the TX
+   * task accesses it.
+   */
+  static in_flight_frame in_flight_frames[TCP_CLIENT_ACK_WINDOW];
+  static uint8_t in_flight_head;
+  static uint8_t in_flight_count;
+
+  /* Bytes of the ack frame that is being received. */
+  static uint8_t ack_buffer[FRAME_ACK_SIZE];
+  static size_t ack_len;
+#endif
+
+#if TCP_CLIENT_FAST_RECONNECT == 1
+  /* Association and IP lease of the current session, it is stored when it is
+   * complete. Only the WiFi and IP event handlers access it.
+   */
+  static Network_cache_record network_cache;
+
+  /* Indicates if the current association attempt uses the cached record. The TX task
+   * reads it to validate the cached lease.
+   */
+  static _Atomic bool network_cache_in_use;
+
+  /* Set by the TX task when the gateway can not be reached with the cached lease, the
+   * WiFi event handler then drops the record and asks for a DHCP lease.
+   */
+  static _Atomic bool network_cache_failed;
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+  /* Indicates if the station has an IP, with ESPNOW_WITH_STATION. The link of the
+   * commands does not follow it. Only the WiFi and IP event handlers access it.
+   */
+  static bool station_has_IP;
+#endif
+
+#if TCP_CLIENT_COALESCE_PWM == 1
+  /* Newest SET_PWM command of each LED that is waiting to be sent. The queue only
+   * holds one entry per pending LED, the TX task replaces it by this value.
+   */
+  static TCP_COMMAND_TYPE pending_PWM_cmds[NUM_OF_LEDS];
+
+  /* Indicates which LEDs have a SET_PWM command waiting in the queue. */
+  static bool pending_PWM_flags[NUM_OF_LEDS];
+
+  /* Spinlock to ensure atomicity in access to the pending SET_PWM commands. */
+  static portMUX_TYPE pending_PWM_lock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
 /***************************************************************************************
  * Functions Prototypes
  ***************************************************************************************/
@@ -103,25 +463,466 @@ static void IP_event_handler(void *event_handler_arg, esp_event_base_t event_bas
 static void cmd_TX_func(void *args);
 
 /**
- * @brief Gets the state of the connection ensuring atomicity.
+ * @brief Takes a new batch of commands from the TX queue without waiting for the first
+ *        one.
  *
- * @param time_to_wait Time to wait to access connection_state variable
+ * @param void
  *
- * @return True if the connection was stablished, false if the time to wait
- *         expired or the connection was not stablished.
+ * @return Number of bytes placed in the TX buffer, 0 if the queue was empty.
  */
-static bool get_connection_state(const TickType_t time_to_wait);
+static size_t take_TX_batch(void);
 
 /**
- * @brief Sets the state of the connection ensuring atomicity.
+ * @brief Delivers the batch of the TX buffer to the gateway.
+ *
+ * @param sock_fd Descriptor of the session socket. In persistent connection mode it is
+ *                opened if needed and kept open after the delivery. When a session is
+ *                opened, the frames that wait for their ack are written again first.
+ *
+ * @param len Number of bytes of the batch. It can be 0 to only reopen the session.
+ *
+ * @return True if the batch was delivered or discarded after all the attempts, false
+ *         if the link was lost, so the batch must be kept for the next session. With
+ *         ESP-NOW, false if a peer did not acknowledge it, so it is written again.
+ */
+static bool deliver_TX_batch(int *sock_fd, const size_t len);
+
+/**
+ * @brief Updates the gateway address with the configured source. The lease gateway
+ *        is copied from the cached value. The resolved host name is only resolved
+ *        again when its TTL expired or when it was marked as stale.
+ *
+ * @param void
+ *
+ * @return True if there is a gateway address to connect to, otherwise false.
+ */
+static bool refresh_gateway_addr(void);
+
+/**
+ * @brief Wakes up the TX task because there are new commands in the queue.
+ *
+ * @param void
+ *
+ * @return void
+ */
+static void notify_TX_task(void);
+
+/**
+ * @brief Moves the commands waiting in the TX queue to the TX buffer, after the given
+ *        first command. It waits up to TCP_CLIENT_TX_LINGER_MS for late commands and
+ *        never takes more than TCP_CLIENT_TX_BATCH_LEN commands. A group that does not
+ *        fit in the rest of the batch is left for the next one, and so is an item of
+ *        other type than the first one.
+ *
+ * @param first_item Command that opens the batch, already taken from the queue.
+ *
+ * @return Number of bytes placed in the TX buffer.
+ */
+static size_t drain_cmd_TX_queue(const TX_item *first_item);
+
+/**
+ * @brief Enqueues a command without notifying the TX task. If the command does not
+ *        fit, it is handled with the given policy. It can not be called from ISR.
+ *
+ * @param item Command to enqueue.
+ *
+ * @param time_to_wait Maximum time in ticks to wait for room in the queue.
+ *
+ * @param policy What to do with the command if the queue is still full.
+ *
+ * @return The same codes than try_send_message.
+ */
+static TCP_client_return enqueue_TX_item(const TX_item *item, 
+  const TickType_t time_to_wait, const TCP_client_overflow_policy policy);
+
+/**
+ * @brief Enqueues a group of items without notifying the TX task, so the TX task
+ *        keeps them in the same batch. The whole group is enqueued or discarded, the
+ *        queue never holds a part of it.
+ *
+ * @param items Items of the group, their group fields are filled here.
+ *
+ * @param num_of_items Number of items of the group, up to TCP_CLIENT_TX_BATCH_LEN.
+ *
+ * @param time_to_wait Maximum time in ticks to wait for room for the whole group.
+ *
+ * @param policy What to do with the group if the queue is still full. With
+ *               TCP_CLIENT_DROP_OLDEST, whole groups are discarded from the head
+ *               until the group fits.
+ *
+ * @return The same codes than try_send_message.
+ */
+static TCP_client_return enqueue_TX_group(TX_item *items, const uint8_t num_of_items,
+  const TickType_t time_to_wait, const TCP_client_overflow_policy policy);
+
+/**
+ * @brief Waits until the TX queue has room for the given number of items. It can not
+ *        be called from ISR.
+ *
+ * @param num_of_items Number of items that must fit.
+ *
+ * @param time_to_wait Maximum time in ticks to wait for the room.
+ *
+ * @return True if there is room, false if the time ran out.
+ */
+static bool wait_for_TX_room(const UBaseType_t num_of_items, TickType_t time_to_wait);
+
+/**
+ * @brief Discards the oldest group of the TX queue, a lone item is a group of one. It
+ *        can not be called from ISR.
+ *
+ * @param void
+ *
+ * @return True if a group was discarded, false if the queue was empty.
+ */
+static bool drop_oldest_TX_group(void);
+
+/**
+ * @brief Releases an item that leaves the TX queue without being sent and counts it
+ *        as dropped by the given policy. It can be called from ISR.
+ *
+ * @param item Item discarded.
+ *
+ * @param ret CORE_TCP_CLIENT_DROPPED_OLDEST_WARN or
+ *            CORE_TCP_CLIENT_DROPPED_NEWEST_WARN.
+ *
+ * @return void
+ */
+static void discard_TX_item(const TX_item *item, const TCP_client_return ret);
+
+#if SYSTEM_TELEMETRY == 1
+  /**
+   * @brief Counts the result of an enqueue in the telemetry. The items discarded by
+   *        the policy are counted by discard_TX_item. It can be called from ISR.
+   *
+   * @param ret CORE_TCP_CLIENT_OK, CORE_TCP_CLIENT_DROPPED_OLDEST_WARN or
+   *            CORE_TCP_CLIENT_DROPPED_NEWEST_WARN.
+   *
+   * @return void
+   */
+  static void count_TX_enqueue(const TCP_client_return ret);
+#endif
+
+/**
+ * @brief Places a command or a state in the TX buffer with the configured wire format.
+ *
+ * @param index Position of the item in the batch.
+ *
+ * @param item Item to place.
+ *
+ * @return void
+ */
+static void place_TX_item(const size_t index, const TX_item *item);
+
+#if TCP_CLIENT_OFFLINE_JOURNAL == 1
+  /**
+   * @brief Keeps a command in the journal if the link is down, or if the journal
+   *        still has commands, so the command is replayed behind them. Behind a
+   *        snapshot queued after the journal, the command goes to the TX queue.
+   *
+   * @param cmd Command to keep.
+   *
+   * @param ret Where the result is written if the command is kept: 
+   *            CORE_TCP_CLIENT_OK or CORE_TCP_CLIENT_DROPPED_OLDEST_WARN.
+   *
+   * @return True if the command was kept in the journal, otherwise false.
+   */
+  static bool journal_offline_cmd(const TCP_COMMAND_TYPE *cmd, TCP_client_return *ret);
+
+  /**
+   * @brief Moves the compacted commands of the journal to the TX buffer, in one batch
+   *        of up to TCP_CLIENT_TX_BATCH_LEN commands.
+   *
+   * @param void
+   *
+   * @return Number of bytes placed in the TX buffer, 0 if the journal is empty.
+   */
+  static size_t take_journal_batch(void);
+#endif
+
+#if TCP_CLIENT_COALESCE_PWM == 1
+  /**
+   * @brief Stores a SET_PWM command as the newest one of its LED.
+   *
+   * @param cmd SET_PWM command to store.
+   *
+   * @return True if the LED already had a command waiting in the queue, so the new
+   *         value replaced it and nothing has to be enqueued. False if the command
+   *         has to be enqueued.
+   */
+  static bool coalesce_PWM_cmd(const TCP_COMMAND_TYPE *cmd);
+
+  /**
+   * @brief Replaces the content of the given SET_PWM command by the newest one of its
+   *        LED and releases the LED, so the next SET_PWM is enqueued again.
+   *
+   * @param cmd SET_PWM command taken from the queue.
+   *
+   * @return void
+   */
+  static void take_newest_PWM_cmd(TCP_COMMAND_TYPE *cmd);
+
+  /**
+   * @brief Releases the LED of a SET_PWM command that could not be enqueued or that
+   *        was discarded from the queue.
+   *
+   * @param cmd SET_PWM command that was not enqueued.
+   *
+   * @return void
+   */
+  static void release_PWM_cmd(const TCP_COMMAND_TYPE *cmd);
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1
+  /**
+   * @brief Reads the acks sent by the gateway and releases the acknowledged frames. If
+   *        the oldest frame waited too long for its ack, or the session is broken, the
+   *        session is closed so the frames are written again in a new one.
+   *
+   * @param sock_fd Descriptor of the session socket. It is set to -1 if it is closed.
+   *
+   * @param time_to_wait Maximum time in ticks to wait for an ack.
+   *
+   * @return void
+   */
+  static void receive_gateway_acks(int *sock_fd, const TickType_t time_to_wait);
+
+  /**
+   * @brief Gets the time in ticks until the ack of the oldest frame times out.
+   *
+   * @param void
+   *
+   * @return Ticks left, 0 if it already timed out.
+   */
+  static TickType_t ack_time_left(void);
+
+  /**
+   * @brief Writes again all the frames that wait for their ack, from the oldest.
+   *
+   * @param sock_fd Descriptor of the new session socket.
+   *
+   * @return True if all the frames were written, otherwise false.
+   */
+  static bool rewrite_in_flight_frames(const int sock_fd);
+
+  /**
+   * @brief Keeps the frame of the TX buffer until the gateway acknowledges it.
+   *
+   * @param len Number of bytes of the frame.
+   *
+   * @return void
+   */
+  static void push_in_flight_frame(const size_t len);
+
+  /**
+   * @brief Releases the oldest frame waiting for its ack and reports its commands.
+   *
+   * @param result Result to report for every command of the frame.
+   *
+   * @return void
+   */
+  static void pop_in_flight_frame(const TCP_client_return result);
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1 || TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+  /**
+   * @brief Calls TCP_client_delivery_CB for every command of a frame. State frames are
+   *        not reported.
+   *
+   * @param frame Encoded frame.
+   *
+   * @param len Number of bytes of the frame.
+   *
+   * @param result Result to report for every command.
+   *
+   * @return void
+   */
+  static void report_frame(const uint8_t *frame, const size_t len, 
+    const TCP_client_return result);
+#endif
+
+#if TCP_CLIENT_FAST_RECONNECT == 1
+  /**
+   * @brief Makes the next association use the cached BSSID, channel and IP lease, so
+   *        it skips the channel scan and the DHCP negotiation.
+   *
+   * @param record Cached association and IP lease.
+   *
+   * @return True if the cached record is applied, otherwise false.
+   */
+  static bool use_network_cache(const Network_cache_record *record);
+
+  /**
+   * @brief Discards the cached record, so the next association scans the channels and
+   *        asks for a DHCP lease.
+   *
+   * @param void
+   *
+   * @return void
+   */
+  static void drop_network_cache(void);
+
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+    /**
+     * @brief Called by the TX task when the gateway can not be reached. If the
+     *        session uses the cached lease, that could be stale after the boots it
+     *        survived, the station disconnects so the WiFi event handler drops the
+     *        record and asks for a DHCP lease. It only acts once per cached session.
+     *
+     * @param void
+     *
+     * @return void
+     */
+    static void reject_network_cache(void);
+  #endif
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+  /**
+   * @brief Creates a socket and connects it to the gateway. In persistent connection
+   *        mode the socket is also configured with TCP_NODELAY and keepalive. The
+   *        connection gives up after TCP_CLIENT_CONNECT_TIME_OUT_MS or as soon as the
+   *        link is lost.
+   *
+   * @param serv_addr Address of the gateway.
+   *
+   * @return The descriptor of the connected socket, or -1 if the operation failed.
+   */
+  static int open_gateway_socket(const struct sockaddr_in *serv_addr);
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+  /**
+   * @brief Creates the UDP socket of a session. In multicast mode it is configured to
+   *        send the datagrams to TCP_CLIENT_UDP_MULTICAST_GROUP.
+   *
+   * @param void
+   *
+   * @return The descriptor of the socket, or -1 if the operation failed.
+   */
+  static int open_UDP_socket(void);
+
+  /**
+   * @brief Sends a datagram to the gateway, or to the multicast group.
+   *
+   * @param sock_fd Descriptor of the session socket.
+   *
+   * @param datagram Data to send.
+   *
+   * @param len Number of bytes to send.
+   *
+   * @return True if the whole datagram was sent, otherwise false.
+   */
+  static bool send_UDP_datagram(const int sock_fd, const uint8_t *datagram,
+    const size_t len);
+
+  /**
+   * @brief Sends the next copy of the last datagram. The copies of a datagram that
+   *        can not be sent are discarded.
+   *
+   * @param sock_fd Descriptor of the session socket, -1 if there is not one.
+   *
+   * @return void
+   */
+  static void send_UDP_copy(const int sock_fd);
+
+  /**
+   * @brief Gets the time in ticks until the next copy of the last datagram is due.
+   *        It must only be called while there are copies left.
+   *
+   * @param void
+   *
+   * @return Ticks left, 0 if it is already due.
+   */
+  static TickType_t UDP_copy_time_left(void);
+#endif
+
+/**
+ * @brief Closes a gateway socket and invalidates its descriptor.
+ *
+ * @param sock_fd Descriptor of the socket to close. It is set to -1.
+ *
+ * @return void
+ */
+static void close_gateway_socket(int *sock_fd);
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+  /**
+   * @brief Writes a whole buffer in a gateway socket.
+   *
+   * @param sock_fd Descriptor of the connected socket.
+   *
+   * @param buffer Data to write.
+   *
+   * @param len Number of bytes to write.
+   *
+   * @return True if all the bytes were written, otherwise false.
+   */
+  static bool write_to_gateway(const int sock_fd, const void *buffer, const size_t len);
+#endif
+
+#if TELEMETRY_REPORT_PERIOD_MS > 0
+  /**
+   * @brief Sends a stats frame with every telemetry value if TELEMETRY_REPORT_PERIOD_MS
+   *        elapsed since the last one. The persistent connection only sends it while
+   *        its session is open, and a broken session is closed.
+   *
+   * @param sock_fd Descriptor of the session socket. It is set to -1 if it is closed.
+   *
+   * @return void
+   */
+  static void report_telemetry(int *sock_fd);
+
+  /**
+   * @brief Gets the time in ticks until the next stats frame.
+   *
+   * @param void
+   *
+   * @return Ticks left, 0 if it is already due.
+   */
+  static TickType_t report_time_left(void);
+#endif
+
+/**
+ * @brief Indicates if the link is up, so the commands can be sent. It does not lock.
+ *
+ * @param void
+ *
+ * @return True if the station has an IP, otherwise false.
+ */
+static bool link_is_up(void);
+
+/**
+ * @brief Sets the state of the connection and updates LINK_UP_BIT accordingly.
+ *
+ * @param state State to set to the connection_state variable.
+ *
+ * @return void
+ */
+static void set_connection_state(const connection_state_type state);
+
+/**
+ * @brief Sets the state of the connection only if it still has the expected value,
+ *        so the TX task can not override a transition made by the event handlers.
+ *
+ * @param expected State that the connection must have.
  *
- * @param time_to_wait Time to wait to access connection_state variable.
- * 
  * @param state State to set to the connection_state variable.
  *
- * @return True if the operation went well, otherwise false.
+ * @return True if the state was set, otherwise false.
+ */
+static bool swap_connection_state(connection_state_type expected, 
+  const connection_state_type state);
+
+/**
+ * @brief Creates the journal, the TX queue, the connection event group and the tasks
+ *        of the module. If one of them fails, the ones already created are deleted.
+ *
+ * @param void
+ *
+ * @return The same error codes than init_TCP_client, or CORE_TCP_CLIENT_OK.
  */
-static bool set_connection_state(const TickType_t time_to_wait, const bool state);
+static TCP_client_return create_client_objects(void);
 
 /***************************************************************************************
  * Functions
@@ -130,21 +931,23 @@ static bool set_connection_state(const TickType_t time_to_wait, const bool state
 TCP_client_return init_TCP_client(void)
 {
 
-  send_cmd_task_handler = NULL;
-
-  /* Create the sempahore than controls the cmd TX task. */
-  cmd_TX_queue = xQueueCreate(RX_QUEUE_LEN, sizeof(TCP_COMMAND_TYPE));
-  if(cmd_TX_queue == NULL)
+  /* The RTOS objects live as long as the system, they are only created once. */
+  if(!module_was_initialized)
   {
-    return CORE_TCP_CLIENT_INIT_QUEUE_ERR; 
+    const TCP_client_return ret = create_client_objects();
+    if(ret != CORE_TCP_CLIENT_OK)
+    {
+      return ret;
+    }
+
+    /* The commands can be buffered since now, before the WiFi starts. */
+    module_was_initialized = true;
   }
 
-  /* Create the semaphore that will alert of the connection state. */
-  connection_state_sempahore = xSemaphoreCreateCounting(1, 1);
-  if(connection_state_sempahore == NULL)
+  /* After a de-init only the WiFi is started again. */
+  if(WiFi_was_started)
   {
-    vSemaphoreDelete(connection_state_sempahore);
-    return CORE_TCP_CLIENT_INIT_SEMAPHORE_ERR;
+    return CORE_TCP_CLIENT_OK;
   }
 
   /* Confiuration of the station. */
@@ -155,6 +958,10 @@ TCP_client_return init_TCP_client(void)
       .ssid = WIFI_SSID,
       .password = WIFI_PASS,
       .threshold.authmode = WIFI_AUTH_MODE,
+      #if SYSTEM_LOW_POWER == 1
+        /* Beacons that the station sleeps in modem sleep. */
+        .listen_interval = POWER_WIFI_LISTEN_INTERVAL,
+      #endif
     }
   };
 
@@ -171,18 +978,27 @@ TCP_client_return init_TCP_client(void)
   /* Start WiFi in station mode. */
   if(core_WiFi_LOG(WiFi_init(WIFI_MODE_STA, config, handlers) != CORE_WIFI_OK))
   {
+    /* The RTOS objects stay, a retry only starts the WiFi. */
     return CORE_TCP_CLIENT_INIT_ERR;
   }
 
-  while(get_connection_state(MAX_TIME_TO_WAIT_TO_SEND) != true)
-  {
-    #if DEBUG_MODE_ENABLE == 1
-      ESP_LOGI(TAG, "Waiting for connection.");
-    #endif
-    vTaskDelay(MAX_TIME_TO_WAIT_TO_SEND);
-  }
+  #if SYSTEM_LOW_POWER == 1
+    /* The radio sleeps between beacons and keeps the association, so the session of
+     * the persistent connection survives the light sleeps of the CPU.
+     */
+    if(esp_wifi_set_ps(WIFI_PS_MAX_MODEM) != ESP_OK)
+    {
+      /* Do not leave the radio awake, a retry starts the WiFi again. */
+      core_WiFi_LOG(de_init_WiFi());
+      return CORE_TCP_CLIENT_INIT_ERR;
+    }
+  #endif
 
-  module_was_initialized = true;
+  WiFi_was_started = true;
+
+  /* Do not wait for the connection, the commands sent meanwhile wait in the queue
+   * and the TX task sends them when IP_EVENT_STA_GOT_IP sets LINK_UP_BIT.
+   */
 
   return CORE_TCP_CLIENT_OK;
 }
@@ -190,12 +1006,20 @@ TCP_client_return init_TCP_client(void)
 TCP_client_return de_init_TCP_client(void)
 {
 
-  connection_state = false;
+  set_connection_state(CONNECTION_DISCONNECTED);
+
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+    if(core_espnow_LOG(de_init_espnow()) != CORE_ESPNOW_OK)
+    {
+      return CORE_TCP_CLIENT_DE_INIT_ERR;
+    }
+  #endif
 
   if(core_WiFi_LOG(de_init_WiFi()) != CORE_WIFI_OK)
   {
     return CORE_TCP_CLIENT_DE_INIT_ERR;
   }
+  WiFi_was_started = false;
 
   return CORE_TCP_CLIENT_OK;
 }
@@ -208,113 +1032,1818 @@ TCP_client_return send_message(const TCP_COMMAND_TYPE cmd)
     return CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR;
   }
 
-  if(get_connection_state(MAX_TIME_TO_WAIT_TO_SEND))
-  {
-    if(xQueueSend(cmd_TX_queue, (void *)&cmd, (TickType_t)portMAX_DELAY-1) != pdPASS)
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    /* Without link, the command waits in the journal. */
+    TCP_client_return journal_ret;
+    if(journal_offline_cmd(&cmd, &journal_ret))
     {
-      return CORE_TCP_CLIENT_CANT_INSERT_IN_QUEUE_ERR;
+      notify_TX_task();
+      return journal_ret;
     }
-  }
-  else
+  #endif
+
+  #if TCP_CLIENT_COALESCE_PWM == 1
+    /* Only the newest duty cycle of a LED matters, replace the pending one. */
+    if(cmd.action == SET_PWM && coalesce_PWM_cmd(&cmd))
+    {
+      return CORE_TCP_CLIENT_OK;
+    }
+  #endif
+
+  /* While the link is down the queue does not drain, so only wait for room while it
+   * is up. Without link, the command is buffered if there is room.
+   */
+  const TX_item item = 
   {
-    return CORE_TCP_CLIENT_SEND_TIME_OUT_WARN;
+    .type = TX_ITEM_CMD,
+    .cmd = cmd,
+    #if SYSTEM_LATENCY_TRACE == 1
+      .enqueue_us = latency_now(),
+      .press_us = latency_origin(),
+    #endif
+  };
+  const bool link_up = link_is_up();
+  if(xQueueSend(cmd_TX_queue, (void *)&item, 
+       link_up ? (TickType_t)portMAX_DELAY-1 : 0u) != pdPASS)
+  {
+    #if TCP_CLIENT_COALESCE_PWM == 1
+      if(cmd.action == SET_PWM)
+      {
+        release_PWM_cmd(&cmd);
+      }
+    #endif
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(link_up ? TELEMETRY_QUEUE_INSERT_ERRS : TELEMETRY_SEND_TIME_OUTS);
+    #endif
+    return link_up ? CORE_TCP_CLIENT_CANT_INSERT_IN_QUEUE_ERR : 
+      CORE_TCP_CLIENT_SEND_TIME_OUT_WARN;
   }
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry(TELEMETRY_CMDS_ENQUEUED);
+  #endif
+  notify_TX_task();
 
   return CORE_TCP_CLIENT_OK;
 }
 
-inline TCP_client_return core_TCP_client_LOG(const TCP_client_return ret)
+TCP_client_return try_send_message(const TCP_COMMAND_TYPE cmd, 
+  const TickType_t time_to_wait, const TCP_client_overflow_policy policy)
 {
-  #if DEBUG_MODE_ENABLE == 1
-    switch(ret)
+
+  if(!module_was_initialized)
+  {
+    return CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    /* Without link, the command waits in the journal. */
+    TCP_client_return journal_ret;
+    if(journal_offline_cmd(&cmd, &journal_ret))
     {
-      #define TCP_CLIENT_RETURN(enumerate) \
-        case enumerate:                    \
-          if(ret > 0)                      \
-          {                                \
-            ESP_LOGE(TAG, #enumerate);     \
-          }                                \
-          else                             \
-          {                                \
-            ESP_LOGI(TAG, #enumerate);     \
-          }                                \
-          break;       
-        TCP_CLIENT_RETURNS
-      #undef TCP_CLIENT_RETURN
-      default:
-        ESP_LOGE(TAG, "Undefined return.");
-        break;
+      notify_TX_task();
+      return journal_ret;
     }
   #endif
-  return ret;
-}
-
-static void cmd_TX_func(void *args)
-{
 
-  int sock_fd;
-  struct sockaddr_in serv_addr;
-  TCP_COMMAND_TYPE cmd;
-
-  /** Assign IP, port and the IP protocol. **/
+  #if TCP_CLIENT_COALESCE_PWM == 1
+    if(cmd.action == SET_PWM && coalesce_PWM_cmd(&cmd))
+    {
+      return CORE_TCP_CLIENT_OK;
+    }
+  #endif
 
-  /* Set IPV4. */
-  serv_addr.sin_family = AF_INET;
+  const TX_item item = 
+  {
+    .type = TX_ITEM_CMD,
+    .cmd = cmd,
+    #if SYSTEM_LATENCY_TRACE == 1
+      .enqueue_us = latency_now(),
+      .press_us = latency_origin(),
+    #endif
+  };
+  const TCP_client_return ret = enqueue_TX_item(&item, time_to_wait, policy);
+  #if SYSTEM_TELEMETRY == 1
+    count_TX_enqueue(ret);
+  #endif
+  if(ret != CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)
+  {
+    notify_TX_task();
+  }
+
+  return ret;
+}
+
+TCP_client_return send_state_snapshot(const Frame_state_record *states,
+  const size_t num_of_LEDs, const TickType_t time_to_wait, 
+  const TCP_client_overflow_policy policy)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+
+    TCP_client_return ret = CORE_TCP_CLIENT_OK;
+    TX_item items[TCP_CLIENT_TX_BATCH_LEN];
+
+    #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+      /* The journal is replayed before the snapshot, not replaced by it. */
+      if(!journal_is_empty())
+      {
+        atomic_store_explicit(&snapshot_closes_journal, true, memory_order_release);
+      }
+    #endif
+
+    /* A snapshot longer than a batch is sent in several state frames. */
+    for(size_t first = 0u; first < num_of_LEDs; first += TCP_CLIENT_TX_BATCH_LEN)
+    {
+      const uint8_t num_of_items = (num_of_LEDs - first > TCP_CLIENT_TX_BATCH_LEN) ?
+        TCP_CLIENT_TX_BATCH_LEN : (uint8_t)(num_of_LEDs - first);
+      for(uint8_t i = 0u; i < num_of_items; i++)
+      {
+        items[i].type = TX_ITEM_STATE;
+        items[i].state = states[first + i];
+      }
+
+      const TCP_client_return group_ret = enqueue_TX_group(items, num_of_items, 
+        time_to_wait, policy);
+      if(group_ret != CORE_TCP_CLIENT_OK)
+      {
+        ret = group_ret;
+      }
+      if(group_ret == CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)
+      {
+        #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+          /* Without any state queued, nothing replays the journal before the
+           * commands.
+           */
+          if(first == 0u)
+          {
+            atomic_store_explicit(&snapshot_closes_journal, false, 
+              memory_order_release);
+          }
+        #endif
+        break;
+      }
+    }
+
+    notify_TX_task();
+
+    return ret;
+
+  #else
+
+    /* The raw format has no way to carry a state. */
+    return CORE_TCP_CLIENT_NOT_SUPPORTED_ERR;
+
+  #endif
+}
+
+TCP_client_return try_send_messages(const TCP_COMMAND_TYPE *cmds, 
+  const size_t num_of_cmds, const TickType_t time_to_wait, 
+  const TCP_client_overflow_policy policy)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  TCP_client_return ret = CORE_TCP_CLIENT_OK;
+  TX_item items[TCP_CLIENT_TX_BATCH_LEN];
+
+  /* A group longer than a batch is sent in groups of one batch. */
+  for(size_t first = 0u; first < num_of_cmds; first += TCP_CLIENT_TX_BATCH_LEN)
+  {
+    const size_t last = (num_of_cmds - first > TCP_CLIENT_TX_BATCH_LEN) ?
+      first + TCP_CLIENT_TX_BATCH_LEN : num_of_cmds;
+
+    /* Only the commands that do not replace a pending one are enqueued. */
+    uint8_t num_of_items = 0u;
+    for(size_t i = first; i < last; i++)
+    {
+      #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+        TCP_client_return journal_ret;
+        if(journal_offline_cmd(&cmds[i], &journal_ret))
+        {
+          if(journal_ret != CORE_TCP_CLIENT_OK)
+          {
+            ret = journal_ret;
+          }
+          continue;
+        }
+      #endif
+      #if TCP_CLIENT_COALESCE_PWM == 1
+        if(cmds[i].action == SET_PWM && coalesce_PWM_cmd(&cmds[i]))
+        {
+          continue;
+        }
+      #endif
+      items[num_of_items].type = TX_ITEM_CMD;
+      items[num_of_items].cmd = cmds[i];
+      num_of_items++;
+    }
+
+    const TCP_client_return group_ret = enqueue_TX_group(items, num_of_items, 
+      time_to_wait, policy);
+    if(group_ret != CORE_TCP_CLIENT_OK)
+    {
+      ret = group_ret;
+    }
+    if(group_ret == CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)
+    {
+      break;
+    }
+  }
+
+  notify_TX_task();
+
+  return ret;
+}
+
+TCP_client_return send_message_from_ISR(const TCP_COMMAND_TYPE cmd,
+  const TCP_client_overflow_policy policy)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  BaseType_t higher_priority_task_woken = pdFALSE;
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    TCP_client_return journal_ret;
+    if(journal_offline_cmd(&cmd, &journal_ret))
+    {
+      xTaskNotifyFromISR(send_cmd_task_handler, TX_NEW_CMD_BIT, eSetBits, 
+        &higher_priority_task_woken);
+      portYIELD_FROM_ISR(higher_priority_task_woken);
+      return journal_ret;
+    }
+  #endif
+
+  #if TCP_CLIENT_COALESCE_PWM == 1
+    if(cmd.action == SET_PWM && coalesce_PWM_cmd(&cmd))
+    {
+      return CORE_TCP_CLIENT_OK;
+    }
+  #endif
+
+  TCP_client_return ret = CORE_TCP_CLIENT_OK;
+  const TX_item item = 
+  {
+    .type = TX_ITEM_CMD,
+    .cmd = cmd,
+    #if SYSTEM_LATENCY_TRACE == 1
+      .enqueue_us = latency_now(),
+      .press_us = latency_origin(),
+    #endif
+  };
+
+  if(xQueueSendFromISR(cmd_TX_queue, (void *)&item, &higher_priority_task_woken) != 
+       pdPASS)
+  {
+    ret = CORE_TCP_CLIENT_DROPPED_NEWEST_WARN;
+
+    if(policy == TCP_CLIENT_DROP_OLDEST)
+    {
+      /* The oldest group is discarded whole, as drop_oldest_TX_group does. */
+      TX_item oldest_item;
+      TX_item next_item;
+      if(xQueueReceiveFromISR(cmd_TX_queue, (void *)&oldest_item, 
+           &higher_priority_task_woken) == pdPASS)
+      {
+        discard_TX_item(&oldest_item, CORE_TCP_CLIENT_DROPPED_OLDEST_WARN);
+        while(xQueuePeekFromISR(cmd_TX_queue, (void *)&next_item) == pdPASS && 
+              CONTINUES_TX_GROUP(oldest_item, next_item) &&
+              xQueueReceiveFromISR(cmd_TX_queue, (void *)&oldest_item, 
+                &higher_priority_task_woken) == pdPASS)
+        {
+          discard_TX_item(&oldest_item, CORE_TCP_CLIENT_DROPPED_OLDEST_WARN);
+        }
+      }
+
+      if(xQueueSendFromISR(cmd_TX_queue, (void *)&item, 
+           &higher_priority_task_woken) == pdPASS)
+      {
+        ret = CORE_TCP_CLIENT_DROPPED_OLDEST_WARN;
+      }
+    }
+
+    if(ret == CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)
+    {
+      discard_TX_item(&item, CORE_TCP_CLIENT_DROPPED_NEWEST_WARN);
+    }
+  }
+
+  #if SYSTEM_TELEMETRY == 1
+    count_TX_enqueue(ret);
+  #endif
+
+  if(ret != CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)
+  {
+    xTaskNotifyFromISR(send_cmd_task_handler, TX_NEW_CMD_BIT, eSetBits, 
+      &higher_priority_task_woken);
+  }
+
+  portYIELD_FROM_ISR(higher_priority_task_woken);
+
+  return ret;
+}
+
+TCP_client_return wait_for_connection(const TickType_t time_to_wait)
+{
+
+  if(!module_was_initialized)
+  {
+    return CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR;
+  }
+
+  if(link_is_up())
+  {
+    return CORE_TCP_CLIENT_OK;
+  }
+
+  if((xEventGroupWaitBits(connection_event_group, LINK_UP_BIT, pdFALSE, pdTRUE,
+        time_to_wait) & LINK_UP_BIT) == 0u)
+  {
+    return CORE_TCP_CLIENT_SEND_TIME_OUT_WARN;
+  }
+
+  return CORE_TCP_CLIENT_OK;
+}
+
+inline TCP_client_return core_TCP_client_LOG(const TCP_client_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define TCP_CLIENT_RETURN(enumerate) \
+        case enumerate:                    \
+          if(ret > 0)                      \
+          {                                \
+            CORE_LOGE(TAG, #enumerate);    \
+          }                                \
+          else                             \
+          {                                \
+            CORE_LOGI(TAG, #enumerate);    \
+          }                                \
+          break;       
+        TCP_CLIENT_RETURNS
+      #undef TCP_CLIENT_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+static void cmd_TX_func(void *args)
+{
+
+  int sock_fd = -1;
+  uint32_t notifications;
+
+  /* Bytes of the batch that is waiting to be delivered. A batch interrupted by a link
+   * loss is kept in the TX buffer and delivered first in the next session.
+   */
+  size_t TX_len = 0u;
+
+  while(true)
+  {
+
+    /* Park until the link is up. */
+    xEventGroupWaitBits(connection_event_group, LINK_UP_BIT, pdFALSE, pdTRUE, 
+      portMAX_DELAY);
+
+    while(link_is_up())
+    {
+
+      #if TCP_CLIENT_GATEWAY_ACKS == 1
+        if(in_flight_count > 0u)
+        {
+          /* A session closed with frames waiting for their ack is opened again to
+           * write them.
+           */
+          if(sock_fd < 0)
+          {
+            deliver_TX_batch(&sock_fd, 0u);
+            continue;
+          }
+
+          /* Take the acks that arrived. With the window full, wait for them. */
+          if(in_flight_count < TCP_CLIENT_ACK_WINDOW)
+          {
+            receive_gateway_acks(&sock_fd, 0u);
+          }
+          else
+          {
+            receive_gateway_acks(&sock_fd, ack_time_left());
+            continue;
+          }
+        }
+      #endif
+
+      /* Take a new batch only when the previous one left the TX buffer. */
+      if(TX_len == 0u)
+      {
+        #if TELEMETRY_REPORT_PERIOD_MS > 0
+          report_telemetry(&sock_fd);
+        #endif
+
+        /* The batch is built in the next slot, wait while lwIP holds every one. */
+        #if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+          TX_buffer = next_raw_TCP_slot(pdMS_TO_TICKS(CONNECT_POLL_PERIOD_MS));
+          if(TX_buffer == NULL)
+          {
+            continue;
+          }
+        #endif
+
+        TX_len = take_TX_batch();
+        if(TX_len == 0u)
+        {
+          #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+            /* The copies of the last datagram go out while there is nothing newer. */
+            if(UDP_copies_left > 0u && UDP_copy_time_left() == 0u)
+            {
+              send_UDP_copy(sock_fd);
+              continue;
+            }
+          #endif
+
+          #if SYSTEM_TELEMETRY == 1
+            sample_telemetry(TELEMETRY_TX_STACK_LOW_WATER, 
+              (uint32_t)uxTaskGetStackHighWaterMark(NULL));
+          #endif
+
+          /* Sleep until there are new commands or the link is lost. While there are
+           * frames waiting for their ack, wake up to read them, and wake up for the
+           * next stats frame too.
+           */
+          TickType_t time_to_wait = portMAX_DELAY;
+          #if TCP_CLIENT_GATEWAY_ACKS == 1
+            if(in_flight_count > 0u)
+            {
+              time_to_wait = ACK_POLL_TICKS;
+            }
+          #endif
+          #if TELEMETRY_REPORT_PERIOD_MS > 0
+            if(report_time_left() < time_to_wait)
+            {
+              time_to_wait = report_time_left();
+            }
+          #endif
+          #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+            if(UDP_copies_left > 0u && UDP_copy_time_left() < time_to_wait)
+            {
+              time_to_wait = UDP_copy_time_left();
+            }
+          #endif
+          xTaskNotifyWait(0u, UINT32_MAX, &notifications, time_to_wait);
+          continue;
+        }
+      }
+
+      /* The CPU does not sleep nor slow down while a batch is written. */
+      keep_CPU_awake();
+      const bool delivered = deliver_TX_batch(&sock_fd, TX_len);
+      let_CPU_sleep();
+      if(delivered)
+      {
+        #if SYSTEM_LATENCY_TRACE == 1
+          record_latency(LATENCY_TAKE_TO_WRITE, TX_batch_take_us);
+          record_latency(LATENCY_PRESS_TO_WRITE, TX_batch_press_us);
+        #endif
+        TX_len = 0u;
+      }
+    }
+
+    /* The link was lost, release the session before parking. The commands that are
+     * still in the queue wait there for the next session.
+     */
+    if(sock_fd >= 0)
+    {
+      close_gateway_socket(&sock_fd);
+    }
+    #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+      UDP_copies_left = 0u;
+    #endif
+    swap_connection_state(CONNECTION_DRAINING, CONNECTION_DISCONNECTED);
+
+    #if DEBUG_MODE_ENABLE == 1
+      CORE_LOGI(TAG, "TX task parked.");
+    #endif
+  }
+
+}
+
+static size_t take_TX_batch(void)
+{
+
+  TX_item item;
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    TX_batch_take_us = latency_now();
+    /* A journal batch has no press to measure from, it is measured from now. */
+    TX_batch_press_us = TX_batch_take_us;
+  #endif
+
+  #if SYSTEM_TELEMETRY == 1
+    /* Taken before the item, the producers can refill the queue right after it. */
+    const uint32_t queue_depth = (uint32_t)uxQueueMessagesWaiting(cmd_TX_queue);
+  #endif
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    /* The journal is replayed once the commands queued before it are sent, and
+     * before the states of a snapshot, which were queued after it.
+     */
+    if(xQueuePeek(cmd_TX_queue, &(item), 0u) != pdPASS || 
+       (item.type == TX_ITEM_STATE && !journal_is_empty()))
+    {
+      return take_journal_batch();
+    }
+  #endif
+
+  if(xQueueReceive(cmd_TX_queue, &(item), 0u) != pdPASS)
+  {
+    return 0u;
+  }
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    if(item.type == TX_ITEM_STATE)
+    {
+      atomic_store_explicit(&snapshot_closes_journal, false, memory_order_release);
+    }
+  #endif
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    record_latency(LATENCY_QUEUE_WAIT, item.enqueue_us);
+    TX_batch_press_us = item.press_us;
+  #endif
+
+  #if SYSTEM_TELEMETRY == 1
+    sample_telemetry(TELEMETRY_TX_QUEUE_DEPTH, queue_depth);
+    sample_telemetry(TELEMETRY_TX_QUEUE_HIGH_WATER, queue_depth);
+  #endif
+
+  #if TCP_CLIENT_COALESCE_PWM == 1
+    if(IS_PWM_ITEM(item))
+    {
+      take_newest_PWM_cmd(&item.cmd);
+    }
+  #endif
+
+  /* Join the commands that are waiting behind it in one single write. */
+  return drain_cmd_TX_queue(&item);
+}
+
+static bool deliver_TX_batch(int *sock_fd, const size_t len)
+{
+
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+
+    /* Only the peers that missed the frame receive it again, the rest would tell the
+     * copy by its frame sequence anyway.
+     */
+    uint32_t pending_peers = ESPNOW_ALL_PEERS;
+    uint32_t backoff_ms = TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS;
+
+    for(uint8_t attempt = 0u; attempt < TCP_CLIENT_MAX_SEND_ATTEMPTS; attempt++)
+    {
+
+      if(attempt > 0u)
+      {
+        /* Give the missing peers time to wake up, but stop if the link is lost. */
+        if((xEventGroupWaitBits(connection_event_group, LINK_DOWN_BIT, pdFALSE,
+              pdTRUE, pdMS_TO_TICKS(backoff_ms)) & LINK_DOWN_BIT) != 0u)
+        {
+          return false;
+        }
+        backoff_ms = (backoff_ms*2u > TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS) ?
+          TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS : backoff_ms*2u;
+      }
+
+      #if SYSTEM_LATENCY_TRACE == 1
+        const uint32_t write_start_us = latency_now();
+      #endif
+      const Espnow_return espnow_ret = core_espnow_LOG(send_espnow_frame(TX_buffer,
+        len, &pending_peers));
+      if(espnow_ret == CORE_ESPNOW_OK)
+      {
+        #if SYSTEM_LATENCY_TRACE == 1
+          record_latency(LATENCY_WRITE, write_start_us);
+        #endif
+        #if SYSTEM_TELEMETRY == 1
+          count_telemetry(TELEMETRY_WRITES);
+        #endif
+        report_frame(TX_buffer, len, CORE_TCP_CLIENT_OK);
+        return true;
+      }
+
+      #if SYSTEM_TELEMETRY == 1
+        count_telemetry(TELEMETRY_WRITE_ERRS);
+      #endif
+
+      /* Without the module nothing can be sent, trying again does not help. */
+      if(espnow_ret != CORE_ESPNOW_NOT_ACKED_WARN)
+      {
+        break;
+      }
+    }
+
+    /* A peer is off or out of range, drop the batch so it does not block the rest. */
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(TELEMETRY_NOT_ACKED);
+    #endif
+    report_frame(TX_buffer, len, CORE_TCP_CLIENT_NOT_ACKED_ERR);
+    return true;
+
+  #elif TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+
+    bool delivered = false;
+
+    /* The socket lives as long as the session, there is nothing to connect. */
+    if(*sock_fd < 0)
+    {
+      *sock_fd = open_UDP_socket();
+      if(*sock_fd >= 0)
+      {
+        swap_connection_state(CONNECTION_GOT_IP, CONNECTION_SOCKET_READY);
+      }
+    }
+
+    if(*sock_fd >= 0)
+    {
+      /* The copies of the previous datagram are not waited for, they leave before
+       * it is replaced so the gateway still gets the frames in order.
+       */
+      while(UDP_copies_left > 0u)
+      {
+        send_UDP_copy(*sock_fd);
+      }
+
+      #if SYSTEM_LATENCY_TRACE == 1
+        const uint32_t write_start_us = latency_now();
+      #endif
+      delivered = send_UDP_datagram(*sock_fd, TX_buffer, len);
+      #if SYSTEM_LATENCY_TRACE == 1
+        if(delivered)
+        {
+          record_latency(LATENCY_WRITE, write_start_us);
+        }
+      #endif
+
+      /* A lost datagram is not retransmitted, its copies are sent from the TX loop
+       * once the gap elapses, so the next batch does not wait for them.
+       */
+      if(TCP_CLIENT_UDP_SENDS > 1u)
+      {
+        memcpy(UDP_copy_buffer, TX_buffer, len);
+        UDP_copy_len = len;
+        UDP_copies_left = TCP_CLIENT_UDP_SENDS - 1u;
+        UDP_copy_tick = xTaskGetTickCount();
+      }
+    }
+
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(delivered ? TELEMETRY_WRITES : TELEMETRY_WRITE_ERRS);
+    #endif
+
+    #if DEBUG_MODE_ENABLE == 1
+      if(!delivered)
+      {
+        CORE_LOGE_ARG(TAG, "Unable to send datagram: errno %d", errno);
+      }
+    #endif
+
+    return delivered || link_is_up();
+
+  #elif TCP_CLIENT_CONNECTION_MODE == TCP_CLIENT_PERSISTENT_CONNECTION
+
+    static uint32_t backoff_ms = TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS;
+
+    for(uint8_t attempt = 0u; attempt < TCP_CLIENT_MAX_SEND_ATTEMPTS; attempt++)
+    {
+
+      /* (Re)connect the session socket if there is not one alive. */
+      if(*sock_fd < 0)
+      {
+        *sock_fd = refresh_gateway_addr() ? open_gateway_socket(&gateway_addr) : -1;
+        if(*sock_fd < 0)
+        {
+          #if TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_DNS
+            /* The gateway could have moved, resolve it again before the next try. */
+            atomic_store(&gateway_addr_is_stale, true);
+          #endif
+          #if TCP_CLIENT_FAST_RECONNECT == 1
+            reject_network_cache();
+          #endif
+
+          /* Wait for the backoff, but stop waiting if the link is lost. */
+          if((xEventGroupWaitBits(connection_event_group, LINK_DOWN_BIT, pdFALSE, 
+                pdTRUE, pdMS_TO_TICKS(backoff_ms)) & LINK_DOWN_BIT) != 0u)
+          {
+            return false;
+          }
+          backoff_ms = (backoff_ms*2u > TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS) ?
+            TCP_CLIENT_MAX_RECONNECT_BACKOFF_MS : backoff_ms*2u;
+          continue;
+        }
+        swap_connection_state(CONNECTION_GOT_IP, CONNECTION_SOCKET_READY);
+
+        #if TCP_CLIENT_GATEWAY_ACKS == 1
+          /* The new session starts with the frames that were not acknowledged. */
+          if(!rewrite_in_flight_frames(*sock_fd))
+          {
+            close_gateway_socket(sock_fd);
+            swap_connection_state(CONNECTION_SOCKET_READY, CONNECTION_GOT_IP);
+            if(!link_is_up())
+            {
+              return false;
+            }
+            continue;
+          }
+        #endif
+      }
+
+      /* Send the batch to the gateway. */
+      if(write_to_gateway(*sock_fd, (void*)TX_buffer, len))
+      {
+        backoff_ms = TCP_CLIENT_MIN_RECONNECT_BACKOFF_MS;
+        #if TCP_CLIENT_GATEWAY_ACKS == 1
+          if(len > 0u)
+          {
+            push_in_flight_frame(len);
+          }
+        #endif
+        return true;
+      }
+
+      /* The session is broken, the next attempt will open a new one. */
+      close_gateway_socket(sock_fd);
+      swap_connection_state(CONNECTION_SOCKET_READY, CONNECTION_GOT_IP);
+
+      if(!link_is_up())
+      {
+        return false;
+      }
+    }
+
+    /* The gateway is alive for the link but it does not accept the batch. */
+    #if TCP_CLIENT_GATEWAY_ACKS == 1
+      if(len > 0u)
+      {
+        report_frame(TX_buffer, len, CORE_TCP_CLIENT_NOT_ACKED_ERR);
+      }
+      while(in_flight_count > 0u)
+      {
+        pop_in_flight_frame(CORE_TCP_CLIENT_NOT_ACKED_ERR);
+      }
+    #endif
+    return true;
+
+  #else
+
+    bool delivered = false;
+
+    *sock_fd = refresh_gateway_addr() ? open_gateway_socket(&gateway_addr) : -1;
+    if(*sock_fd >= 0)
+    {
+      /* Send command to the gateway. */
+      delivered = write_to_gateway(*sock_fd, (void*)TX_buffer, len);
+      close_gateway_socket(sock_fd);
+    }
+    else
+    {
+      #if TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_DNS
+        /* The gateway could have moved, resolve it again before the next try. */
+        atomic_store(&gateway_addr_is_stale, true);
+      #endif
+      #if TCP_CLIENT_FAST_RECONNECT == 1
+        reject_network_cache();
+      #endif
+    }
+
+    return delivered || link_is_up();
+
+  #endif
+}
+
+static bool refresh_gateway_addr(void)
+{
+
+  /* Set IPV4 and the port of the transport. */
+  gateway_addr.sin_family = AF_INET;
+  gateway_addr.sin_port = htons(GATEWAY_PORT);
+
+  #if TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_LEASE
+
+    gateway_addr.sin_addr.s_addr = atomic_load(&lease_gateway_IP);
+
+  #elif TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FIXED_IP
+
+    if(gateway_addr.sin_addr.s_addr == 0u)
+    {
+      inet_pton(AF_INET, TCP_CLIENT_GATEWAY_IP, &gateway_addr.sin_addr);
+    }
+
+  #else
+
+    const TickType_t now = xTaskGetTickCount();
+    if(gateway_addr.sin_addr.s_addr != 0u && !atomic_load(&gateway_addr_is_stale) &&
+       (now - gateway_addr_resolution_tick) < 
+        pdMS_TO_TICKS(TCP_CLIENT_GATEWAY_DNS_TTL_S*1000u))
+    {
+      return true;
+    }
+
+    const struct addrinfo hints =
+    {
+      .ai_family = AF_INET,
+      .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *result = NULL;
+    if(getaddrinfo(TCP_CLIENT_GATEWAY_HOSTNAME, NULL, &hints, &result) == 0 && 
+       result != NULL)
+    {
+      gateway_addr.sin_addr = ((struct sockaddr_in *)result->ai_addr)->sin_addr;
+      gateway_addr_resolution_tick = now;
+      atomic_store(&gateway_addr_is_stale, false);
+    }
+    #if DEBUG_MODE_ENABLE == 1
+      else
+      {
+        CORE_LOGE(TAG, "Gateway host name could not be resolved.");
+      }
+    #endif
+    if(result != NULL)
+    {
+      freeaddrinfo(result);
+    }
+
+    /* If the resolution failed, the previous address is still tried. */
+
+  #endif
+
+  return gateway_addr.sin_addr.s_addr != 0u;
+}
+
+static void notify_TX_task(void)
+{
+
+  xTaskNotify(send_cmd_task_handler, TX_NEW_CMD_BIT, eSetBits);
+}
+
+static TCP_client_return enqueue_TX_item(const TX_item *item, 
+  const TickType_t time_to_wait, const TCP_client_overflow_policy policy)
+{
+
+  if(xQueueSend(cmd_TX_queue, (void *)item, time_to_wait) == pdPASS)
+  {
+    return CORE_TCP_CLIENT_OK;
+  }
+
+  /* Make room discarding the oldest group. If another producer takes the room first,
+   * the given command is the one discarded.
+   */
+  if(policy == TCP_CLIENT_DROP_OLDEST && drop_oldest_TX_group() &&
+     xQueueSend(cmd_TX_queue, (void *)item, 0u) == pdPASS)
+  {
+    return CORE_TCP_CLIENT_DROPPED_OLDEST_WARN;
+  }
+
+  discard_TX_item(item, CORE_TCP_CLIENT_DROPPED_NEWEST_WARN);
+
+  return CORE_TCP_CLIENT_DROPPED_NEWEST_WARN;
+}
+
+static TCP_client_return enqueue_TX_group(TX_item *items, const uint8_t num_of_items,
+  const TickType_t time_to_wait, const TCP_client_overflow_policy policy)
+{
+
+  TCP_client_return ret = CORE_TCP_CLIENT_OK;
+
+  if(num_of_items == 0u)
+  {
+    return ret;
+  }
+
+  /* The group only starts once it fits whole, so the TX task never waits for a part
+   * of it that was discarded.
+   */
+  if(!wait_for_TX_room(num_of_items, time_to_wait))
+  {
+    if(policy == TCP_CLIENT_DROP_OLDEST)
+    {
+      while(uxQueueSpacesAvailable(cmd_TX_queue) < num_of_items && 
+            drop_oldest_TX_group())
+      {
+      }
+      ret = CORE_TCP_CLIENT_DROPPED_OLDEST_WARN;
+    }
+    if(uxQueueSpacesAvailable(cmd_TX_queue) < num_of_items)
+    {
+      for(uint8_t i = 0u; i < num_of_items; i++)
+      {
+        discard_TX_item(&items[i], CORE_TCP_CLIENT_DROPPED_NEWEST_WARN);
+      }
+      return CORE_TCP_CLIENT_DROPPED_NEWEST_WARN;
+    }
+  }
+
+  const uint8_t group_ID = 
+    (uint8_t)((atomic_fetch_add(&TX_group_seq, 1u) % UINT8_MAX) + 1u);
+  for(uint8_t i = 0u; i < num_of_items; i++)
+  {
+    items[i].group_left = num_of_items - i - 1u;
+    items[i].group_ID = group_ID;
+    #if SYSTEM_LATENCY_TRACE == 1
+      items[i].enqueue_us = latency_now();
+      items[i].press_us = latency_origin();
+    #endif
+
+    if(xQueueSend(cmd_TX_queue, (void *)&items[i], 0u) != pdPASS)
+    {
+      /* Another producer took the room after the check. The TX task ends the group
+       * at the first item that does not follow it, so the part already enqueued is
+       * sent alone.
+       */
+      for(uint8_t j = i; j < num_of_items; j++)
+      {
+        discard_TX_item(&items[j], CORE_TCP_CLIENT_DROPPED_NEWEST_WARN);
+      }
+      return CORE_TCP_CLIENT_DROPPED_NEWEST_WARN;
+    }
+    #if SYSTEM_TELEMETRY == 1
+      count_TX_enqueue(ret);
+    #endif
+  }
+
+  return ret;
+}
+
+static bool wait_for_TX_room(const UBaseType_t num_of_items, TickType_t time_to_wait)
+{
+
+  /* A queue only wakes the producers of one item, so a group polls for its room. */
+  TimeOut_t time_out;
+  vTaskSetTimeOutState(&time_out);
+  while(uxQueueSpacesAvailable(cmd_TX_queue) < num_of_items)
+  {
+    if(xTaskCheckForTimeOut(&time_out, &time_to_wait) != pdFALSE)
+    {
+      return false;
+    }
+    vTaskDelay(1u);
+  }
+
+  return true;
+}
+
+static bool drop_oldest_TX_group(void)
+{
+
+  TX_item oldest_item;
+  if(xQueueReceive(cmd_TX_queue, (void *)&oldest_item, 0u) != pdPASS)
+  {
+    return false;
+  }
+  discard_TX_item(&oldest_item, CORE_TCP_CLIENT_DROPPED_OLDEST_WARN);
+
+  /* The rest of the group follows it, unless the TX task already took it. */
+  TX_item item;
+  while(xQueuePeek(cmd_TX_queue, (void *)&item, 0u) == pdPASS && 
+        CONTINUES_TX_GROUP(oldest_item, item) &&
+        xQueueReceive(cmd_TX_queue, (void *)&oldest_item, 0u) == pdPASS)
+  {
+    discard_TX_item(&oldest_item, CORE_TCP_CLIENT_DROPPED_OLDEST_WARN);
+  }
+
+  return true;
+}
+
+static void discard_TX_item(const TX_item *item, const TCP_client_return ret)
+{
+
+  #if TCP_CLIENT_COALESCE_PWM == 1
+    if(IS_PWM_ITEM(*item))
+    {
+      release_PWM_cmd(&item->cmd);
+    }
+  #endif
+
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry((ret == CORE_TCP_CLIENT_DROPPED_OLDEST_WARN) ? 
+      TELEMETRY_DROPPED_OLDEST : TELEMETRY_DROPPED_NEWEST);
+  #endif
+}
+
+#if SYSTEM_TELEMETRY == 1
+  static void count_TX_enqueue(const TCP_client_return ret)
+  {
+
+    if(ret != CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)
+    {
+      count_telemetry(TELEMETRY_CMDS_ENQUEUED);
+    }
+  }
+#endif
+
+static size_t drain_cmd_TX_queue(const TX_item *first_item)
+{
+
+  TX_item item;
+  TX_item last_item = *first_item;
+  size_t num_of_cmds = 1u;
+
+  place_TX_item(0u, first_item);
+
+  /* The linger window is counted from the first command, so late commands can not
+   * extend it. The rest of a group is always waited.
+   */
+  TimeOut_t linger;
+  TickType_t ticks_to_wait = TX_LINGER_TICKS;
+  vTaskSetTimeOutState(&linger);
+
+  while(num_of_cmds < TCP_CLIENT_TX_BATCH_LEN &&
+        xQueuePeek(cmd_TX_queue, &item, (last_item.group_left > 0u) ? 
+          TX_GROUP_WAIT_TICKS : ticks_to_wait) == pdPASS)
+  {
+    /* A new group that does not fit opens the next batch, and so does an item of
+     * another type, a frame only carries commands or states. A group that lost its
+     * tail to another producer ends at the first item that does not follow it.
+     */
+    if(!CONTINUES_TX_GROUP(last_item, item) && 
+       (item.group_left >= TCP_CLIENT_TX_BATCH_LEN - num_of_cmds || 
+        item.type != first_item->type))
+    {
+      break;
+    }
+
+    /* Only a producer that drops the oldest command can take it first, then the next
+     * one is taken.
+     */
+    if(xQueueReceive(cmd_TX_queue, &item, 0u) != pdPASS)
+    {
+      break;
+    }
+    last_item = item;
+
+    #if SYSTEM_LATENCY_TRACE == 1
+      record_latency(LATENCY_QUEUE_WAIT, item.enqueue_us);
+    #endif
+
+    #if TCP_CLIENT_COALESCE_PWM == 1
+      if(IS_PWM_ITEM(item))
+      {
+        take_newest_PWM_cmd(&item.cmd);
+      }
+    #endif
+
+    place_TX_item(num_of_cmds, &item);
+    num_of_cmds++;
+
+    /* Once the window expires, only take the commands that are already queued. */
+    if(xTaskCheckForTimeOut(&linger, &ticks_to_wait) != pdFALSE)
+    {
+      ticks_to_wait = 0u;
+    }
+  }
+
+  #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+    /* The header is written last, when the number of commands is known. */
+    encode_frame_header(TX_buffer, (first_item->type == TX_ITEM_STATE) ? 
+      FRAME_TYPE_STATE : FRAME_TYPE_COMMANDS, TX_frame_seq++, (uint8_t)num_of_cmds);
+  #endif
+
+  return TX_HEADER_SIZE + (num_of_cmds*TX_CMD_SIZE);
+}
+
+static void place_TX_item(const size_t index, const TX_item *item)
+{
+
+  uint8_t *slot = &TX_buffer[TX_HEADER_SIZE + (index*TX_CMD_SIZE)];
+
+  #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+    if(item->type == TX_ITEM_STATE)
+    {
+      encode_state_record(slot, &item->state);
+    }
+    else
+    {
+      encode_cmd_record(slot, &item->cmd);
+    }
+  #else
+    /* State items are only enqueued with the framed format. */
+    memcpy(slot, &item->cmd, TCP_COMMAND_SIZE);
+  #endif
+}
+
+#if TCP_CLIENT_OFFLINE_JOURNAL == 1
+
+  static bool journal_offline_cmd(const TCP_COMMAND_TYPE *cmd, TCP_client_return *ret)
+  {
+
+    if(link_is_up() && (journal_is_empty() || 
+       atomic_load_explicit(&snapshot_closes_journal, memory_order_acquire)))
+    {
+      return false;
+    }
+
+    *ret = (append_to_journal(cmd) == CORE_JOURNAL_OK) ? CORE_TCP_CLIENT_OK : 
+      CORE_TCP_CLIENT_DROPPED_OLDEST_WARN;
+
+    #if SYSTEM_TELEMETRY == 1
+      if(*ret != CORE_TCP_CLIENT_OK)
+      {
+        count_telemetry(TELEMETRY_JOURNAL_DROPS);
+      }
+    #endif
+
+    return true;
+  }
+
+  static size_t take_journal_batch(void)
+  {
+
+    TCP_COMMAND_TYPE cmds[TCP_CLIENT_TX_BATCH_LEN];
+    const size_t num_of_cmds = take_from_journal(cmds, TCP_CLIENT_TX_BATCH_LEN);
+    if(num_of_cmds == 0u)
+    {
+      return 0u;
+    }
+
+    TX_item item =
+    {
+      .type = TX_ITEM_CMD,
+    };
+    for(size_t i = 0u; i < num_of_cmds; i++)
+    {
+      item.cmd = cmds[i];
+      place_TX_item(i, &item);
+    }
+
+    #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+      encode_frame_header(TX_buffer, FRAME_TYPE_COMMANDS, TX_frame_seq++, 
+        (uint8_t)num_of_cmds);
+    #endif
+
+    return TX_HEADER_SIZE + (num_of_cmds*TX_CMD_SIZE);
+  }
+
+#endif
+
+#if TCP_CLIENT_COALESCE_PWM == 1
+
+  static bool coalesce_PWM_cmd(const TCP_COMMAND_TYPE *cmd)
+  {
+
+    if(cmd->ID >= NUM_OF_LEDS)
+    {
+      return false;
+    }
+
+    portENTER_CRITICAL_SAFE(&pending_PWM_lock);
+    const bool was_pending = pending_PWM_flags[cmd->ID];
+    pending_PWM_cmds[cmd->ID] = *cmd;
+    pending_PWM_flags[cmd->ID] = true;
+    portEXIT_CRITICAL_SAFE(&pending_PWM_lock);
+
+    return was_pending;
+  }
+
+  static void take_newest_PWM_cmd(TCP_COMMAND_TYPE *cmd)
+  {
+
+    if(cmd->ID >= NUM_OF_LEDS)
+    {
+      return;
+    }
+
+    portENTER_CRITICAL_SAFE(&pending_PWM_lock);
+    if(pending_PWM_flags[cmd->ID])
+    {
+      *cmd = pending_PWM_cmds[cmd->ID];
+      pending_PWM_flags[cmd->ID] = false;
+    }
+    portEXIT_CRITICAL_SAFE(&pending_PWM_lock);
+  }
+
+  static void release_PWM_cmd(const TCP_COMMAND_TYPE *cmd)
+  {
+
+    if(cmd->ID >= NUM_OF_LEDS)
+    {
+      return;
+    }
+
+    portENTER_CRITICAL_SAFE(&pending_PWM_lock);
+    pending_PWM_flags[cmd->ID] = false;
+    portEXIT_CRITICAL_SAFE(&pending_PWM_lock);
+  }
+
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1
+  static void receive_gateway_acks(int *sock_fd, const TickType_t time_to_wait)
+  {
+
+    bool session_is_broken = false;
+
+    /* Wait until there is something to read or the time expires. */
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(*sock_fd, &read_set);
+    const uint32_t ms_to_wait = pdTICKS_TO_MS(time_to_wait);
+    struct timeval time_out =
+    {
+      .tv_sec = ms_to_wait/1000u,
+      .tv_usec = (ms_to_wait%1000u)*1000u,
+    };
+
+    if(select(*sock_fd + 1, &read_set, NULL, NULL, &time_out) > 0)
+    {
+      /* Read all the acks that arrived, they can come split in several segments. */
+      while(!session_is_broken)
+      {
+        const ssize_t ret = recv(*sock_fd, &ack_buffer[ack_len], 
+          FRAME_ACK_SIZE - ack_len, MSG_DONTWAIT);
+        if(ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+          break;
+        }
+        else if(ret <= 0)
+        {
+          /* The gateway closed the session or it is broken. */
+          session_is_broken = true;
+          break;
+        }
+
+        ack_len += (size_t)ret;
+        if(ack_len < FRAME_ACK_SIZE)
+        {
+          continue;
+        }
+        ack_len = 0u;
+
+        Frame_header header;
+        if(decode_frame_header(ack_buffer, FRAME_ACK_SIZE, &header) != CORE_FRAME_OK ||
+           header.type != FRAME_TYPE_ACK)
+        {
+          /* The stream lost its alignment, start a new session. */
+          session_is_broken = true;
+          break;
+        }
+
+        /* The ack covers its frame and all the previous ones. */
+        while(in_flight_count > 0u && 
+              (int16_t)(header.seq - in_flight_frames[in_flight_head].seq) >= 0)
+        {
+          pop_in_flight_frame(CORE_TCP_CLIENT_OK);
+        }
+      }
+    }
+
+    /* The oldest frame waited too long, write it again in a new session. */
+    if(!session_is_broken && in_flight_count > 0u && ack_time_left() == 0u)
+    {
+      session_is_broken = true;
+      #if SYSTEM_TELEMETRY == 1
+        count_telemetry(TELEMETRY_ACK_TIME_OUTS);
+      #endif
+      if(++in_flight_frames[in_flight_head].time_outs >= TCP_CLIENT_MAX_SEND_ATTEMPTS)
+      {
+        pop_in_flight_frame(CORE_TCP_CLIENT_NOT_ACKED_ERR);
+      }
+
+      #if DEBUG_MODE_ENABLE == 1
+        CORE_LOGE(TAG, "Ack time out, reopening the session.");
+      #endif
+    }
+
+    if(session_is_broken)
+    {
+      close_gateway_socket(sock_fd);
+      swap_connection_state(CONNECTION_SOCKET_READY, CONNECTION_GOT_IP);
+    }
+  }
+
+  static TickType_t ack_time_left(void)
+  {
+
+    const TickType_t waited = xTaskGetTickCount() - 
+      in_flight_frames[in_flight_head].written_tick;
+
+    return (waited >= ACK_TIME_OUT_TICKS) ? 0u : ACK_TIME_OUT_TICKS - waited;
+  }
+
+  static bool rewrite_in_flight_frames(const int sock_fd)
+  {
+
+    /* A partial ack of the previous session is useless. */
+    ack_len = 0u;
+
+    for(uint8_t i = 0u; i < in_flight_count; i++)
+    {
+      in_flight_frame *in_flight = 
+        &in_flight_frames[(in_flight_head + i) % TCP_CLIENT_ACK_WINDOW];
+      if(!write_to_gateway(sock_fd, in_flight->frame, in_flight->len))
+      {
+        return false;
+      }
+      in_flight->written_tick = xTaskGetTickCount();
+    }
+
+    return true;
+  }
+
+  static void push_in_flight_frame(const size_t len)
+  {
+
+    in_flight_frame *in_flight = 
+      &in_flight_frames[(in_flight_head + in_flight_count) % TCP_CLIENT_ACK_WINDOW];
+
+    Frame_header header;
+    decode_frame_header(TX_buffer, len, &header);
+
+    memcpy(in_flight->frame, TX_buffer, len);
+    in_flight->len = len;
+    in_flight->seq = header.seq;
+    in_flight->time_outs = 0u;
+    in_flight->written_tick = xTaskGetTickCount();
+    in_flight_count++;
+  }
+
+  static void pop_in_flight_frame(const TCP_client_return result)
+  {
+
+    const in_flight_frame *in_flight = &in_flight_frames[in_flight_head];
+    report_frame(in_flight->frame, in_flight->len, result);
+
+    #if SYSTEM_TELEMETRY == 1
+      if(result == CORE_TCP_CLIENT_NOT_ACKED_ERR)
+      {
+        count_telemetry(TELEMETRY_NOT_ACKED);
+      }
+    #endif
+
+    in_flight_head = (in_flight_head + 1u) % TCP_CLIENT_ACK_WINDOW;
+    in_flight_count--;
+  }
+#endif
+
+#if TCP_CLIENT_GATEWAY_ACKS == 1 || TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+  static void report_frame(const uint8_t *frame, const size_t len, 
+    const TCP_client_return result)
+  {
+
+    /* The states of a snapshot are not commands of the application. */
+    Frame_header header;
+    if(decode_frame_header(frame, len, &header) != CORE_FRAME_OK || 
+       header.type != FRAME_TYPE_COMMANDS)
+    {
+      return;
+    }
+
+    TCP_COMMAND_TYPE cmd;
+    size_t offset = FRAME_HEADER_SIZE;
+    for(uint8_t i = 0u; i < header.count; i++)
+    {
+      offset += decode_cmd_record(&frame[offset], &cmd);
+      TCP_client_delivery_CB(cmd, result);
+    }
+  }
+#endif
+
+#if TCP_CLIENT_FAST_RECONNECT == 1
+  static bool use_network_cache(const Network_cache_record *record)
+  {
+
+    esp_netif_t *esp_netif = esp_netif_get_handle_from_ifkey(STA_NETIF_KEY);
+    wifi_config_t config;
+    if(esp_netif == NULL || esp_wifi_get_config(WIFI_IF_STA, &config) != ESP_OK)
+    {
+      return false;
+    }
+
+    /* Go straight to the access point of the last association. */
+    config.sta.bssid_set = true;
+    memcpy(config.sta.bssid, record->bssid, sizeof(config.sta.bssid));
+    config.sta.channel = record->channel;
+    if(esp_wifi_set_config(WIFI_IF_STA, &config) != ESP_OK)
+    {
+      return false;
+    }
+
+    /* Set the last lease, the IP is available as soon as the station is associated. */
+    const esp_err_t ret = esp_netif_dhcpc_stop(esp_netif);
+    if(ret != ESP_OK && ret != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED)
+    {
+      drop_network_cache();
+      return false;
+    }
+
+    esp_netif_dns_info_t dns_info =
+    {
+      .ip.type = ESP_IPADDR_TYPE_V4,
+      .ip.u_addr.ip4 = record->dns,
+    };
+    if(esp_netif_set_ip_info(esp_netif, &record->ip_info) != ESP_OK ||
+       (record->dns.addr != 0u && 
+        esp_netif_set_dns_info(esp_netif, ESP_NETIF_DNS_MAIN, &dns_info) != ESP_OK))
+    {
+      drop_network_cache();
+      return false;
+    }
+
+    #if DEBUG_MODE_ENABLE == 1
+      CORE_LOGI_ARG(TAG, "Fast reconnection to channel %d", record->channel);
+    #endif
 
-  /* Obtain the IP of the gateway. */
-  esp_netif_ip_info_t ip_info;
-  esp_netif_t* esp_netif = esp_netif_next_unsafe(NULL);
-  ESP_error_check(esp_netif_get_ip_info(esp_netif, &ip_info));
-  /* Convert the gateway IP in string format. */
-  char IP_string[32];
-  sprintf(IP_string, IPSTR, IP2STR(&ip_info.gw));
-  /* Set the IP of the gateway */
-  inet_pton(AF_INET, IP_string, &serv_addr.sin_addr);
+    return true;
+  }
+
+  static void drop_network_cache(void)
+  {
 
-  /* Set the port defined in Network_config.h */
-  serv_addr.sin_port = htons(TCP_IP_PORT);
+    core_network_cache_LOG(invalidate_network_cache());
 
-  while(true)
+    /* Scan all the channels again. */
+    wifi_config_t config;
+    if(esp_wifi_get_config(WIFI_IF_STA, &config) == ESP_OK)
+    {
+      config.sta.bssid_set = false;
+      config.sta.channel = 0u;
+      ESP_error_check(esp_wifi_set_config(WIFI_IF_STA, &config));
+    }
+
+    /* Ask for a new lease. */
+    esp_netif_t *esp_netif = esp_netif_get_handle_from_ifkey(STA_NETIF_KEY);
+    if(esp_netif != NULL)
+    {
+      const esp_err_t ret = esp_netif_dhcpc_start(esp_netif);
+      if(ret != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED)
+      {
+        ESP_error_check(ret);
+      }
+    }
+  }
+
+  #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+    static void reject_network_cache(void)
+    {
+
+      if(!atomic_load(&network_cache_in_use) || 
+         atomic_exchange(&network_cache_failed, true))
+      {
+        return;
+      }
+
+      #if DEBUG_MODE_ENABLE == 1
+        CORE_LOGE(TAG, "Gateway unreachable with the cached lease, asking for DHCP.");
+      #endif
+
+      /* The lease is only validated by reaching the gateway, the association drops
+       * so the next one negotiates it.
+       */
+      ESP_error_check(esp_wifi_disconnect());
+    }
+  #endif
+#endif
+
+#if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+static int open_gateway_socket(const struct sockaddr_in *serv_addr)
+{
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    const uint32_t connect_start_us = latency_now();
+  #endif
+
+  bool connected = false;
+  if(core_raw_TCP_LOG(open_raw_TCP(serv_addr->sin_addr.s_addr, 
+       ntohs(serv_addr->sin_port))) == CORE_RAW_TCP_OK)
+  {
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(TELEMETRY_SOCKETS_OPENED);
+    #endif
+
+    /* Connect in slices, so the task can give up as soon as the link is lost. */
+    uint32_t waited_ms = 0u;
+    while(waited_ms < TCP_CLIENT_CONNECT_TIME_OUT_MS && link_is_up())
+    {
+      const Raw_TCP_return ret = 
+        wait_for_raw_TCP(pdMS_TO_TICKS(CONNECT_POLL_PERIOD_MS));
+      if(ret != CORE_RAW_TCP_CONNECTING_WARN)
+      {
+        connected = (ret == CORE_RAW_TCP_OK);
+        break;
+      }
+      waited_ms += CONNECT_POLL_PERIOD_MS;
+    }
+
+    if(!connected)
+    {
+      close_raw_TCP();
+      #if SYSTEM_TELEMETRY == 1
+        count_telemetry(TELEMETRY_SOCKETS_CLOSED);
+      #endif
+    }
+  }
+
+  if(!connected)
+  {
+    #if DEBUG_MODE_ENABLE == 1
+      CORE_LOGE(TAG, "Raw session unable to connect.");
+    #endif
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(TELEMETRY_CONNECT_FAILS);
+    #endif
+    return -1;
+  }
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    record_latency(LATENCY_CONNECT, connect_start_us);
+  #endif
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry(TELEMETRY_CONNECTS);
+  #endif
+
+  return RAW_SESSION_FD;
+}
+#elif TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+static int open_gateway_socket(const struct sockaddr_in *serv_addr)
+{
+
+  /* Create socket and verify the initialization. */
+  const int sock_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+  if(sock_fd < 0)
+  {
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(TELEMETRY_CONNECT_FAILS);
+    #endif
+    #if DEBUG_MODE_ENABLE == 1
+      CORE_LOGE_ARG(TAG, "Unable to create socket: errno %d", errno);
+    #endif
+    return -1;
+  }
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry(TELEMETRY_SOCKETS_OPENED);
+  #endif
+
+  #if TCP_CLIENT_CONNECTION_MODE == TCP_CLIENT_PERSISTENT_CONNECTION
+
+    /* Send each command as soon as it is written instead of waiting to merge it. */
+    const int enable = 1;
+    setsockopt(sock_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+    /* Detect dead sessions while the switch is idle. */
+    const int keep_idle = TCP_CLIENT_KEEPALIVE_IDLE_S;
+    const int keep_interval = TCP_CLIENT_KEEPALIVE_INTERVAL_S;
+    const int keep_count = TCP_CLIENT_KEEPALIVE_COUNT;
+    setsockopt(sock_fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    setsockopt(sock_fd, IPPROTO_TCP, TCP_KEEPIDLE, &keep_idle, sizeof(keep_idle));
+    setsockopt(sock_fd, IPPROTO_TCP, TCP_KEEPINTVL, &keep_interval, sizeof(keep_interval));
+    setsockopt(sock_fd, IPPROTO_TCP, TCP_KEEPCNT, &keep_count, sizeof(keep_count));
+
+  #endif
+
+  /* A blocked write gives up after a while, so a dead link can not hold the task. */
+  const struct timeval send_time_out = 
   {
+    .tv_sec = TCP_CLIENT_SEND_TIME_OUT_MS/1000u,
+    .tv_usec = (TCP_CLIENT_SEND_TIME_OUT_MS%1000u)*1000u,
+  };
+  setsockopt(sock_fd, SOL_SOCKET, SO_SNDTIMEO, &send_time_out, sizeof(send_time_out));
+
+  /* Connect without blocking, so the task can give up as soon as the link is lost. */
+  const int flags = fcntl(sock_fd, F_GETFL, 0);
+  fcntl(sock_fd, F_SETFL, flags | O_NONBLOCK);
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    const uint32_t connect_start_us = latency_now();
+  #endif
 
-    /* Wait for new commands to send. */
-    if(xQueueReceive(cmd_TX_queue, &(cmd), (TickType_t)portMAX_DELAY-1) == pdPASS)
+  /* Connect the client socket to the server socket. */
+  bool connected = (connect(sock_fd, (struct sockaddr *)serv_addr, 
+    sizeof(*serv_addr)) == 0);
+
+  if(!connected && errno == EINPROGRESS)
+  {
+    uint32_t waited_ms = 0u;
+    while(waited_ms < TCP_CLIENT_CONNECT_TIME_OUT_MS && link_is_up())
     {
+      fd_set write_fds;
+      FD_ZERO(&write_fds);
+      FD_SET(sock_fd, &write_fds);
+      struct timeval poll_period = 
+      {
+        .tv_sec = 0,
+        .tv_usec = CONNECT_POLL_PERIOD_MS*1000u,
+      };
 
-      /* Create socket and verify the initialization. */
-      sock_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
-      if(sock_fd < 0)
+      const int ret = select(sock_fd + 1, NULL, &write_fds, NULL, &poll_period);
+      if(ret > 0)
       {
-        #if DEBUG_MODE_ENABLE == 1
-          ESP_LOGE(TAG, "Unable to create socket: errno %d", errno);
-        #endif
+        /* The socket is writable, check if the connection went well. */
+        int sock_err = 0;
+        socklen_t sock_err_len = sizeof(sock_err);
+        getsockopt(sock_fd, SOL_SOCKET, SO_ERROR, &sock_err, &sock_err_len);
+        connected = (sock_err == 0);
+        errno = sock_err;
+        break;
+      }
+      else if(ret < 0)
+      {
+        break;
       }
+      waited_ms += CONNECT_POLL_PERIOD_MS;
+    }
+  }
+
+  if(!connected)
+  {
+    #if DEBUG_MODE_ENABLE == 1
+      CORE_LOGE_ARG(TAG, "Socket unable to connect: errno %d", errno);
+    #endif
+    close(sock_fd);
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(TELEMETRY_SOCKETS_CLOSED);
+      count_telemetry(TELEMETRY_CONNECT_FAILS);
+    #endif
+    return -1;
+  }
+
+  fcntl(sock_fd, F_SETFL, flags);
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    record_latency(LATENCY_CONNECT, connect_start_us);
+  #endif
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry(TELEMETRY_CONNECTS);
+  #endif
+
+  return sock_fd;
+}
+#endif
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+  static int open_UDP_socket(void)
+  {
+
+    const int sock_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if(sock_fd < 0)
+    {
+      #if DEBUG_MODE_ENABLE == 1
+        CORE_LOGE_ARG(TAG, "Unable to create socket: errno %d", errno);
+      #endif
+      return -1;
+    }
+    #if SYSTEM_TELEMETRY == 1
+      count_telemetry(TELEMETRY_SOCKETS_OPENED);
+    #endif
+
+    /* A full buffer gives up after a while, so a dead link can not hold the task. */
+    const struct timeval send_time_out = 
+    {
+      .tv_sec = TCP_CLIENT_SEND_TIME_OUT_MS/1000u,
+      .tv_usec = (TCP_CLIENT_SEND_TIME_OUT_MS%1000u)*1000u,
+    };
+    setsockopt(sock_fd, SOL_SOCKET, SO_SNDTIMEO, &send_time_out, sizeof(send_time_out));
+
+    #if TCP_CLIENT_UDP_MULTICAST == 1
+
+      /* Keep the datagrams in the LAN and do not receive them back. */
+      const uint8_t TTL = TCP_CLIENT_UDP_MULTICAST_TTL;
+      const uint8_t loop = 0u;
+      setsockopt(sock_fd, IPPROTO_IP, IP_MULTICAST_TTL, &TTL, sizeof(TTL));
+      setsockopt(sock_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+
+      UDP_group_addr.sin_family = AF_INET;
+      UDP_group_addr.sin_port = htons(GATEWAY_PORT);
+      inet_pton(AF_INET, TCP_CLIENT_UDP_MULTICAST_GROUP, &UDP_group_addr.sin_addr);
+
+    #endif
+
+    return sock_fd;
+  }
+
+  static bool send_UDP_datagram(const int sock_fd, const uint8_t *datagram,
+    const size_t len)
+  {
 
-      /* Connect the client socket to the server socket. */
-      if(connect(sock_fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) != 0)
+    #if TCP_CLIENT_UDP_MULTICAST == 1
+      const struct sockaddr_in *dest_addr = &UDP_group_addr;
+    #else
+      const struct sockaddr_in *dest_addr = &gateway_addr;
+      if(!refresh_gateway_addr())
       {
-        #if DEBUG_MODE_ENABLE == 1
-          ESP_LOGE(TAG, "Socket unable to connect: errno %d", errno);
-        #endif
+        return false;
       }
+    #endif
 
-      /* Send command to the gateway. */
-      if(write(sock_fd, (void*)&cmd, TCP_COMMAND_SIZE) < 0)
+    return sendto(sock_fd, datagram, len, 0, (const struct sockaddr *)dest_addr,
+      sizeof(*dest_addr)) == (ssize_t)len;
+  }
+
+  static void send_UDP_copy(const int sock_fd)
+  {
+
+    if(sock_fd < 0 || !send_UDP_datagram(sock_fd, UDP_copy_buffer, UDP_copy_len))
+    {
+      UDP_copies_left = 0u;
+      return;
+    }
+
+    UDP_copies_left--;
+    UDP_copy_tick = xTaskGetTickCount();
+  }
+
+  static TickType_t UDP_copy_time_left(void)
+  {
+
+    const TickType_t elapsed = xTaskGetTickCount() - UDP_copy_tick;
+
+    return (elapsed < UDP_SEND_GAP_TICKS) ? UDP_SEND_GAP_TICKS - elapsed : 0u;
+  }
+#endif
+
+static void close_gateway_socket(int *sock_fd)
+{
+
+  #if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+    close_raw_TCP();
+  #else
+    shutdown(*sock_fd, 0);
+    close(*sock_fd);
+  #endif
+
+  *sock_fd = -1;
+
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry(TELEMETRY_SOCKETS_CLOSED);
+  #endif
+}
+
+#if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_TCP
+static bool write_to_gateway(const int sock_fd, const void *buffer, const size_t len)
+{
+
+  #if SYSTEM_LATENCY_TRACE == 1
+    const uint32_t write_start_us = latency_now();
+  #endif
+
+  #if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+
+    /* The batch of the TX buffer is sent from its slot, any other buffer is copied. */
+    const Raw_TCP_return ret = (buffer == TX_buffer) ? send_raw_TCP_slot(len) :
+      send_raw_TCP_copy((const uint8_t *)buffer, len);
+    if(core_raw_TCP_LOG(ret) != CORE_RAW_TCP_OK)
+    {
+      #if SYSTEM_TELEMETRY == 1
+        count_telemetry(TELEMETRY_WRITE_ERRS);
+      #endif
+      return false;
+    }
+
+  #else
+
+    const uint8_t *data = (const uint8_t *)buffer;
+    size_t written = 0u;
+
+    /* The socket can accept only a part of the buffer, keep writing the remainder. */
+    while(written < len)
+    {
+      const ssize_t ret = write(sock_fd, data + written, len - written);
+      if(ret < 0)
       {
+        #if SYSTEM_TELEMETRY == 1
+          count_telemetry(TELEMETRY_WRITE_ERRS);
+        #endif
         #if DEBUG_MODE_ENABLE == 1
-          ESP_LOGE(TAG, "Send error: errno %d", errno);
+          CORE_LOGE_ARG(TAG, "Send error: errno %d", errno);
         #endif
+        return false;
       }
+      written += (size_t)ret;
+    }
 
-      bzero((void*)&cmd, sizeof(cmd));
+  #endif
 
-      shutdown(sock_fd, 0);
-      close(sock_fd);
+  #if SYSTEM_LATENCY_TRACE == 1
+    record_latency(LATENCY_WRITE, write_start_us);
+  #endif
+  #if SYSTEM_TELEMETRY == 1
+    count_telemetry(TELEMETRY_WRITES);
+  #endif
 
-    }
-  }
-  
+  return true;
 }
+#endif
 
 static void WiFi_event_handler(void *event_handler_arg, esp_event_base_t event_base,
   int32_t event_id, void *event_data)
@@ -322,24 +2851,90 @@ static void WiFi_event_handler(void *event_handler_arg, esp_event_base_t event_b
     switch (event_id)
     {
       case WIFI_EVENT_STA_START:
-        /* Try to connect to the gateway. */
-        ESP_error_check(esp_wifi_connect());
+
+        #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+          /* The peers are reachable as soon as the radio starts, the link is up
+           * without waiting for the association nor the IP.
+           */
+          if(core_espnow_LOG(init_espnow()) == CORE_ESPNOW_OK)
+          {
+            set_connection_state(CONNECTION_GOT_IP);
+            TCP_client_link_up_CB();
+          }
+        #endif
+
+        #if STATION_ASSOCIATES
+          #if TCP_CLIENT_FAST_RECONNECT == 1
+            /* Reuse the last good association of a previous boot if there is one. */
+            network_cache_in_use = (load_network_cache(&network_cache) == 
+              CORE_NETWORK_CACHE_OK) && use_network_cache(&network_cache);
+          #endif
+
+          /* Try to connect to the gateway. */
+          ESP_error_check(esp_wifi_connect());
+        #endif
         break;
-      case WIFI_EVENT_STA_DISCONNECTED:
-        
-        /* Alerts that the station lost the communications. */
-        set_connection_state((TickType_t)portMAX_DELAY-1, false);
+      case WIFI_EVENT_STA_CONNECTED:
 
-        /* If it was initialized before, delete the send command task. */
-        if(send_cmd_task_handler != NULL)
-        {
-          vTaskDelete(send_cmd_task_handler);
-        }
+        #if TCP_CLIENT_FAST_RECONNECT == 1
+          /* Keep the access point of the session, it is stored with the IP lease. */
+          memcpy(network_cache.bssid, ((wifi_event_sta_connected_t *)event_data)->bssid,
+            sizeof(network_cache.bssid));
+          network_cache.channel = ((wifi_event_sta_connected_t *)event_data)->channel;
+        #endif
+
+        #if TCP_CLIENT_TRANSPORT != TCP_CLIENT_TRANSPORT_ESPNOW
+          set_connection_state(CONNECTION_ASSOCIATED);
+        #endif
+        break;
+      case WIFI_EVENT_STA_DISCONNECTED: {
+
+        #if SYSTEM_TELEMETRY == 1
+          count_telemetry(TELEMETRY_WIFI_DISCONNECTS);
+        #endif
+
+        #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+          /* The ESP-NOW link does not depend on the access point, it stays up. */
+          const bool link_was_up = station_has_IP;
+          station_has_IP = false;
+        #else
+          const bool link_was_up = link_is_up();
+
+          /* Alerts that the station lost the communications. If the link was up, the
+           * TX task closes its session and parks, then it sets
+           * CONNECTION_DISCONNECTED.
+           */
+          set_connection_state(link_was_up ? CONNECTION_DRAINING : 
+            CONNECTION_DISCONNECTED);
+
+          /* Wake up the TX task if it is waiting for commands, so it parks now. */
+          xTaskNotify(send_cmd_task_handler, TX_LINK_DOWN_BIT, eSetBits);
+        #endif
+
+        #if TCP_CLIENT_FAST_RECONNECT == 1
+          const bool network_cache_was_rejected = 
+            atomic_exchange(&network_cache_failed, false);
+          if(network_cache_in_use && (!link_was_up || network_cache_was_rejected))
+          {
+            /* The cached association or its lease failed, scan and ask for a DHCP
+             * lease.
+             */
+            drop_network_cache();
+            network_cache_in_use = false;
+          }
+          else if(link_was_up && !network_cache_in_use)
+          {
+            /* Reconnect to the access point and with the lease of the lost session. */
+            network_cache_in_use = (load_network_cache(&network_cache) == 
+              CORE_NETWORK_CACHE_OK) && use_network_cache(&network_cache);
+          }
+        #endif
  
         /* Try to connect again to the gateway. */
         ESP_error_check(esp_wifi_connect());
 
         break;
+      }
       default:
         break;
     }
@@ -351,70 +2946,240 @@ static void IP_event_handler(void *event_handler_arg, esp_event_base_t event_bas
     switch (event_id)
     {
       case IP_EVENT_STA_GOT_IP:
-      
-        /* Alerts that the station starts the communications. */
-        set_connection_state((TickType_t)portMAX_DELAY-1, true);
 
-        /* Create the task that will send the messages. */
-        const BaseType_t ret = xTaskCreate(cmd_TX_func, "cmd_TX_func", 2048, (void *) 0, 
-                                            (UBaseType_t)configMAX_PRIORITIES-2,
-                                            &send_cmd_task_handler);
+        #if SYSTEM_TELEMETRY == 1
+          count_telemetry(TELEMETRY_IP_LEASES);
+        #endif
+
+        #if TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_LEASE
+          /* Keep the gateway of the lease, the TX task reads it without locking. */
+          atomic_store(&lease_gateway_IP, 
+            ((ip_event_got_ip_t *)event_data)->ip_info.gw.addr);
+        #elif TCP_CLIENT_GATEWAY_SOURCE == TCP_CLIENT_GATEWAY_FROM_DNS
+          /* A new IP can come with a new DNS server, resolve the gateway again. */
+          if(((ip_event_got_ip_t *)event_data)->ip_changed)
+          {
+            atomic_store(&gateway_addr_is_stale, true);
+          }
+        #endif
+
+        #if TCP_CLIENT_FAST_RECONNECT == 1
+          /* The association is complete, keep it for the next one. */
+          network_cache.ip_info = ((ip_event_got_ip_t *)event_data)->ip_info;
+          esp_netif_dns_info_t dns_info;
+          if(esp_netif_get_dns_info(((ip_event_got_ip_t *)event_data)->esp_netif,
+               ESP_NETIF_DNS_MAIN, &dns_info) == ESP_OK)
+          {
+            network_cache.dns = dns_info.ip.u_addr.ip4;
+          }
+          core_network_cache_LOG(store_network_cache(&network_cache));
+        #endif
+      
+        #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+          /* The commands do not travel through the IP network, the link was already
+           * up since the radio started.
+           */
+          station_has_IP = true;
+        #else
+          /* Alerts that the station starts the communications, it resumes the parked
+           * TX task.
+           */
+          set_connection_state(CONNECTION_GOT_IP);
+
+          /* The gateway could have missed commands while the link was down. */
+          TCP_client_link_up_CB();
+        #endif
 
-        if(ret != pdPASS)
-        {
-          /* TODO: Handle this corner case. */
-        }
         #if DEBUG_MODE_ENABLE == 1
-          ESP_LOGI(TAG, "WiFi got IP");
+          CORE_LOGI(TAG, "WiFi got IP");
         #endif
         break;
       default:
         #if DEBUG_MODE_ENABLE == 1
-          ESP_LOGE(TAG, "Unregistered IP event happened: %" PRIu32, event_id);
+          CORE_LOGE_ARG(TAG, "Unregistered IP event happened: %d", event_id);
         #endif
         break;
     }
 }
 
-static bool get_connection_state(const TickType_t time_to_wait)
-{
+#if TELEMETRY_REPORT_PERIOD_MS > 0
+  static void report_telemetry(int *sock_fd)
+  {
 
-  bool state = false;
+    if(report_time_left() > 0u)
+    {
+      return;
+    }
+    last_report_tick = xTaskGetTickCount();
 
-  if(xSemaphoreTake(connection_state_sempahore, time_to_wait) == pdTRUE)
-  {
+    sample_heap_telemetry();
 
-    state = connection_state;
-    if(xSemaphoreGive(connection_state_sempahore) != pdTRUE)
+    size_t len = encode_frame_header(stats_buffer, FRAME_TYPE_STATS, stats_frame_seq++,
+      (uint8_t)NUM_OF_TELEMETRY_VALUES);
+    for(uint32_t ID = 0u; ID < NUM_OF_TELEMETRY_VALUES; ID++)
     {
-      /* TODO: Handle this corner case */
-    } 
+      Frame_stats_record record = { .ID = (uint8_t)ID };
+      get_telemetry((Telemetry_ID)ID, &record.value);
+      len += encode_stats_record(&stats_buffer[len], &record);
+    }
 
-    return state;
+    #if TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_ESPNOW
+
+      /* The report is not sent again, the next one carries newer values. */
+      uint32_t pending_peers = ESPNOW_ALL_PEERS;
+      core_espnow_LOG(send_espnow_frame(stats_buffer, len, &pending_peers));
+
+    #elif TCP_CLIENT_TRANSPORT == TCP_CLIENT_TRANSPORT_UDP
+
+      #if TCP_CLIENT_UDP_MULTICAST == 1
+        const struct sockaddr_in *dest_addr = &UDP_group_addr;
+        const bool has_dest_addr = true;
+      #else
+        const struct sockaddr_in *dest_addr = &gateway_addr;
+        const bool has_dest_addr = refresh_gateway_addr();
+      #endif
+
+      /* A lost report is not sent again, the next one carries newer values. */
+      if(*sock_fd >= 0 && has_dest_addr)
+      {
+        sendto(*sock_fd, stats_buffer, len, 0, (const struct sockaddr *)dest_addr,
+          sizeof(*dest_addr));
+      }
+
+    #elif TCP_CLIENT_CONNECTION_MODE == TCP_CLIENT_PERSISTENT_CONNECTION
+
+      /* Do not connect only for a report, it waits for the next session. */
+      if(*sock_fd >= 0 && !write_to_gateway(*sock_fd, stats_buffer, len))
+      {
+        close_gateway_socket(sock_fd);
+        swap_connection_state(CONNECTION_SOCKET_READY, CONNECTION_GOT_IP);
+      }
+
+    #else
+
+      int stats_sock_fd = refresh_gateway_addr() ? 
+        open_gateway_socket(&gateway_addr) : -1;
+      if(stats_sock_fd >= 0)
+      {
+        write_to_gateway(stats_sock_fd, stats_buffer, len);
+        close_gateway_socket(&stats_sock_fd);
+      }
+
+    #endif
+  }
+
+  static TickType_t report_time_left(void)
+  {
+
+    const TickType_t elapsed = xTaskGetTickCount() - last_report_tick;
+
+    return (elapsed < TELEMETRY_REPORT_TICKS) ? TELEMETRY_REPORT_TICKS - elapsed : 0u;
+  }
+#endif
+
+static bool link_is_up(void)
+{
+
+  const connection_state_type state = atomic_load_explicit(&connection_state, 
+    memory_order_acquire);
+
+  return state == CONNECTION_GOT_IP || state == CONNECTION_SOCKET_READY;
+}
+
+static void set_connection_state(const connection_state_type state)
+{
+
+  atomic_store_explicit(&connection_state, state, memory_order_release);
+
+  if(state == CONNECTION_GOT_IP || state == CONNECTION_SOCKET_READY)
+  {
+    xEventGroupClearBits(connection_event_group, LINK_DOWN_BIT);
+    xEventGroupSetBits(connection_event_group, LINK_UP_BIT);
   }
   else
   {
-    return false;
+    xEventGroupClearBits(connection_event_group, LINK_UP_BIT);
+    xEventGroupSetBits(connection_event_group, LINK_DOWN_BIT);
   }
 }
 
-static bool set_connection_state(const TickType_t time_to_wait, const bool state)
+static bool swap_connection_state(connection_state_type expected, 
+  const connection_state_type state)
+{
+
+  /* The socket states do not change the link, LINK_UP_BIT stays as it is. */
+  return atomic_compare_exchange_strong_explicit(&connection_state, &expected, state,
+    memory_order_acq_rel, memory_order_acquire);
+}
+
+static TCP_client_return create_client_objects(void)
 {
 
-  if(xSemaphoreTake(connection_state_sempahore, time_to_wait) == pdTRUE)
+  send_cmd_task_handler = NULL;
+
+  #if TCP_CLIENT_WIRE_FORMAT == TCP_CLIENT_WIRE_FRAMED
+    TX_frame_seq = (uint16_t)esp_random();
+  #endif
+
+  #if TCP_CLIENT_OFFLINE_JOURNAL == 1
+    core_journal_LOG(init_journal());
+  #endif
+
+  /* Create the queue where the commands wait to be sent. */
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    cmd_TX_queue = xQueueCreateStatic(RX_QUEUE_LEN, sizeof(TX_item),
+      cmd_TX_queue_storage, &cmd_TX_queue_buffer);
+  #else
+    cmd_TX_queue = xQueueCreate(RX_QUEUE_LEN, sizeof(TX_item));
+  #endif
+  if(cmd_TX_queue == NULL)
+  {
+    return CORE_TCP_CLIENT_INIT_QUEUE_ERR; 
+  }
+
+  /* Create the event group that will alert of the connection state. */
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    connection_event_group = xEventGroupCreateStatic(&connection_event_group_buffer);
+  #else
+    connection_event_group = xEventGroupCreate();
+  #endif
+  if(connection_event_group == NULL)
   {
-    connection_state = state;
-    if(xSemaphoreGive(connection_state_sempahore) != pdTRUE)
+    vQueueDelete(cmd_TX_queue);
+    return CORE_TCP_CLIENT_INIT_EVENT_GROUP_ERR;
+  }
+  set_connection_state(CONNECTION_DISCONNECTED);
+
+  #if TCP_CLIENT_LWIP_API == TCP_CLIENT_LWIP_RAW
+    if(core_raw_TCP_LOG(init_raw_TCP()) != CORE_RAW_TCP_OK)
     {
-      return false;
+      vEventGroupDelete(connection_event_group);
+      vQueueDelete(cmd_TX_queue);
+      return CORE_TCP_CLIENT_INIT_RAW_TCP_ERR;
     }
+  #endif
 
-  }
-  else
+  /* Create the task that will send the messages. It stays parked until the link is
+   * up and parks again when the link is lost.
+   */
+  #if SYSTEM_STATIC_ALLOCATION == 1
+    send_cmd_task_handler = xTaskCreateStaticPinnedToCore(cmd_TX_func, "cmd_TX_func",
+      TX_TASK_STACK_SIZE, (void *) 0, (UBaseType_t)TX_TASK_PRIORITY,
+      cmd_TX_task_stack, &cmd_TX_task_TCB, TX_TASK_CORE);
+  #else
+    if(xTaskCreatePinnedToCore(cmd_TX_func, "cmd_TX_func", TX_TASK_STACK_SIZE,
+         (void *) 0, (UBaseType_t)TX_TASK_PRIORITY, &send_cmd_task_handler,
+         TX_TASK_CORE) != pdPASS)
+    {
+      send_cmd_task_handler = NULL;
+    }
+  #endif
+  if(send_cmd_task_handler == NULL)
   {
-    return false;
+    vEventGroupDelete(connection_event_group);
+    vQueueDelete(cmd_TX_queue);
+    return CORE_TCP_CLIENT_INIT_TASK_ERR;
   }
 
-  return true;
+  return CORE_TCP_CLIENT_OK;
 }
-
@@ -14,6 +14,9 @@
  * Includes
  ***************************************************************************************/
 #include <Network_config.h>
+#include <Frame.h>
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
 
 /***************************************************************************************
  * Defines
@@ -26,11 +29,17 @@
   /* Error codes */                                           \
   TCP_CLIENT_RETURN(CORE_TCP_CLIENT_INIT_ERR)                 \
   TCP_CLIENT_RETURN(CORE_TCP_CLIENT_INIT_QUEUE_ERR)           \
-  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_INIT_SEMAPHORE_ERR)       \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_INIT_EVENT_GROUP_ERR)     \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_INIT_TASK_ERR)            \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_INIT_RAW_TCP_ERR)         \
   TCP_CLIENT_RETURN(CORE_TCP_CLIENT_DE_INIT_ERR)              \
   TCP_CLIENT_RETURN(CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR)  \   
   TCP_CLIENT_RETURN(CORE_TCP_CLIENT_CANT_INSERT_IN_QUEUE_ERR) \
-  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_SEND_TIME_OUT_WARN)  
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_SEND_TIME_OUT_WARN)       \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_DROPPED_NEWEST_WARN)      \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_DROPPED_OLDEST_WARN)      \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_NOT_ACKED_ERR)            \
+  TCP_CLIENT_RETURN(CORE_TCP_CLIENT_NOT_SUPPORTED_ERR)
  
 /***************************************************************************************
  * Data Type Definitions
@@ -46,6 +55,15 @@ typedef enum
   NUM_OF_TCP_CLIENT_RETURNS,
 } TCP_client_return;
 
+/* Enumerate that lists what to do with a command that does not fit in the TX queue. */
+typedef enum
+{
+  /* The given command is discarded. */
+  TCP_CLIENT_DROP_NEWEST,
+  /* The oldest command of the queue is discarded to make room for the given one. */
+  TCP_CLIENT_DROP_OLDEST,
+} TCP_client_overflow_policy;
+
 /***************************************************************************************
  * Functions Prototypes
  ***************************************************************************************/
@@ -53,8 +71,8 @@ typedef enum
 /**
  * @brief Initializes the WiFi peripheral starting the device as a WiFi station. 
  *        It is mandatory to call this function before any other function of this module.
- *        This function performs a wait until the connection is stablished and can not be 
- *        called from ISR.
+ *        This function does not wait for the connection, the commands sent before it is
+ *        stablished are buffered. It can not be called from ISR.
  *
  * @param void
  *
@@ -64,8 +82,14 @@ typedef enum
  *           - CORE_TCP_CLIENT_INIT_QUEUE_ERR:
  *               Error trying to create a queue.
  * 
- *           - CORE_TCP_CLIENT_INIT_SEMAPHORE_ERR:
- *               Error trying to create a sempahore.
+ *           - CORE_TCP_CLIENT_INIT_EVENT_GROUP_ERR:
+ *               Error trying to create an event group.
+ * 
+ *           - CORE_TCP_CLIENT_INIT_TASK_ERR:
+ *               Error trying to create the TX task.
+ * 
+ *           - CORE_TCP_CLIENT_INIT_RAW_TCP_ERR:
+ *               Error trying to initialize the raw lwIP session, see Raw_TCP.h.
  * 
  *           - CORE_TCP_CLIENT_INIT_ERR:
  *               An error ocurred in an intermediate function.
@@ -89,7 +113,8 @@ TCP_client_return init_TCP_client(void);
 TCP_client_return de_init_TCP_client(void);
 
 /**
- * @brief Sends a command(TCP/IP frame) to the gateway.
+ * @brief Sends a command(TCP/IP frame) to the gateway. If the connection is not
+ *        stablished, the command is buffered until it is.
  *
  * @param cmd Command to send, this parameter type is defined in Network_config.h
  *
@@ -103,11 +128,151 @@ TCP_client_return de_init_TCP_client(void);
  *              If it is not possible to insert the message in the queue.
  * 
  *           - CORE_TCP_CLIENT_SEND_TIME_OUT_WARN:
- *               Time out expires while trying to send the message.
+ *               The connection is not stablished and there is no room to buffer the
+ *               message.
  *           
  */
 TCP_client_return send_message(const TCP_COMMAND_TYPE cmd);
 
+/**
+ * @brief Sends a command(TCP/IP frame) to the gateway waiting a bounded time. It does
+ *        not wait for the connection, if it is not stablished the command is buffered
+ *        until it is. This function can not be called from ISR.
+ *
+ * @param cmd Command to send, this parameter type is defined in Network_config.h
+ *
+ * @param time_to_wait Maximum time in ticks to wait for room in the TX queue.
+ *
+ * @param policy What to do with the command if the queue is still full after
+ *               time_to_wait.
+ *
+ * @return CORE_TCP_CLIENT_OK if the operation went well,
+ *         otherwise:
+ * 
+ *           - CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR: 
+ *               Module was not initialized before.
+ * 
+ *           - CORE_TCP_CLIENT_DROPPED_NEWEST_WARN:
+ *               The queue was full and the given command was discarded.
+ * 
+ *           - CORE_TCP_CLIENT_DROPPED_OLDEST_WARN:
+ *               The queue was full and the oldest command, with the rest of its
+ *               group, was discarded to enqueue the given one.
+ *           
+ */
+TCP_client_return try_send_message(const TCP_COMMAND_TYPE cmd, 
+  const TickType_t time_to_wait, const TCP_client_overflow_policy policy);
+
+/**
+ * @brief Sends a group of commands to the gateway in the same frame, for example all
+ *        the targets of a scene, so they are applied at the same time. A group longer
+ *        than TCP_CLIENT_TX_BATCH_LEN is split in frames of that length. This
+ *        function can not be called from ISR.
+ *
+ * @param cmds Commands to send, this parameter type is defined in Network_config.h
+ *
+ * @param num_of_cmds Number of commands of the group.
+ *
+ * @param time_to_wait Maximum time in ticks that every frame of the group waits for
+ *                     room in the queue.
+ *
+ * @param policy What to do with a frame of the group if the queue is still full. A
+ *               frame is enqueued or discarded whole, and if it is discarded the
+ *               rest of the group is discarded too.
+ *
+ * @return The same codes than try_send_message.
+ */
+TCP_client_return try_send_messages(const TCP_COMMAND_TYPE *cmds, 
+  const size_t num_of_cmds, const TickType_t time_to_wait, 
+  const TCP_client_overflow_policy policy);
+
+/**
+ * @brief Sends the whole state of the LEDs to the gateway, so it recovers the commands
+ *        that it missed while the link was down. The states travel in state frames
+ *        through the same queue than the commands, so the commands sent after the
+ *        snapshot are applied on top of it. This function can not be called from ISR.
+ *
+ * @param states State of every LED, this parameter type is defined in Frame.h
+ *
+ * @param num_of_LEDs Number of states of the snapshot.
+ *
+ * @param time_to_wait Maximum time in ticks that every state frame waits for room in
+ *                     the queue.
+ *
+ * @param policy What to do with a state frame if the queue is still full. A frame is
+ *               enqueued or discarded whole.
+ *
+ * @return The same codes than try_send_message, and also:
+ *
+ *           - CORE_TCP_CLIENT_NOT_SUPPORTED_ERR:
+ *               The system was configured with the raw wire format, it can not carry
+ *               a state.
+ */
+TCP_client_return send_state_snapshot(const Frame_state_record *states,
+  const size_t num_of_LEDs, const TickType_t time_to_wait, 
+  const TCP_client_overflow_policy policy);
+
+/**
+ * @brief Sends a command(TCP/IP frame) to the gateway from an ISR, for example from
+ *        button_CB. It never blocks.
+ *
+ * @param cmd Command to send, this parameter type is defined in Network_config.h
+ *
+ * @param policy What to do with the command if the queue is full.
+ *
+ * @return The same codes than try_send_message.
+ */
+TCP_client_return send_message_from_ISR(const TCP_COMMAND_TYPE cmd,
+  const TCP_client_overflow_policy policy);
+
+/**
+ * @brief Waits until the connection with the access point is stablished, for the 
+ *        callers that need it. This function can not be called from ISR.
+ *
+ * @param time_to_wait Maximum time in ticks to wait for the connection.
+ *
+ * @return CORE_TCP_CLIENT_OK if the connection is stablished,
+ *         otherwise:
+ * 
+ *           - CORE_TCP_CLIENT_MODULE_WAS_NOT_INIT_ERR: 
+ *               Module was not initialized before.
+ * 
+ *           - CORE_TCP_CLIENT_SEND_TIME_OUT_WARN:
+ *               Time out expires before the connection is stablished.
+ */
+TCP_client_return wait_for_connection(const TickType_t time_to_wait);
+
+/**
+ * @brief Callback that the TX task calls when the gateway acknowledges a command or
+ *        when the command is dropped without ack. It is only called if the system
+ *        was configured with TCP_CLIENT_GATEWAY_ACKS or with the ESP-NOW transport,
+ *        where the ack is the MAC ack of every peer. It runs in the TX task, so it
+ *        must not block.
+ *
+ * @param cmd Command that finished.
+ *
+ * @param result CORE_TCP_CLIENT_OK if the gateway acknowledged the command,
+ *               otherwise:
+ *
+ *                 - CORE_TCP_CLIENT_NOT_ACKED_ERR:
+ *                     The command was dropped after TCP_CLIENT_MAX_SEND_ATTEMPTS
+ *                     attempts without ack.
+ *
+ * @return void
+ */
+void TCP_client_delivery_CB(const TCP_COMMAND_TYPE cmd, const TCP_client_return result);
+
+/**
+ * @brief Callback that is called every time the station gets an IP, after the link
+ *        was down or on the first connection. It runs in the event loop task, so it
+ *        must not block.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void TCP_client_link_up_CB(void);
+
 /**
  * @brief Prints the return of a TCP client module function if the system was configured 
  *        in debug mode.
@@ -0,0 +1,175 @@
+/**
+ * @file      Telemetry.c
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This source file defines the functions to keep the telemetry counters
+ *            of the system: queue depth, drops, connections, heap and stack
+ *            watermarks. It is only compiled with SYSTEM_TELEMETRY.
+ */
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <Telemetry.h>
+
+#if SYSTEM_TELEMETRY == 1
+
+#include <Debug.h>
+#include <Deferred_log.h>
+#include <esp_system.h>
+#include <stdatomic.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Tag to show traces in core telemetry module. */
+  #define TAG "CORE_TELEMETRY"
+#endif
+
+/***************************************************************************************
+ * Global Variables
+ ***************************************************************************************/
+
+/* Every telemetry value, they are only updated with atomic operations. The low water
+ * marks start at UINT32_MAX, so the first sample is always kept.
+ */
+static _Atomic uint32_t values[NUM_OF_TELEMETRY_VALUES] =
+{
+  #define TELEMETRY_VALUE(enumerate, kind) \
+    [enumerate] = ((kind) == TELEMETRY_LOW_WATER) ? UINT32_MAX : 0u,
+    TELEMETRY_VALUES
+  #undef TELEMETRY_VALUE
+};
+
+/* Kind of every telemetry value. */
+static const uint8_t kinds[NUM_OF_TELEMETRY_VALUES] =
+{
+  #define TELEMETRY_VALUE(enumerate, kind) [enumerate] = (kind),
+    TELEMETRY_VALUES
+  #undef TELEMETRY_VALUE
+};
+
+#if DEBUG_MODE_ENABLE == 1
+  /* Name of every telemetry value, for the reports. */
+  static const char *const names[NUM_OF_TELEMETRY_VALUES] =
+  {
+    #define TELEMETRY_VALUE(enumerate, kind) [enumerate] = #enumerate,
+      TELEMETRY_VALUES
+    #undef TELEMETRY_VALUE
+  };
+#endif
+
+/***************************************************************************************
+ * Functions
+ ***************************************************************************************/
+
+void count_telemetry(const Telemetry_ID ID)
+{
+
+  if(ID >= NUM_OF_TELEMETRY_VALUES)
+  {
+    return;
+  }
+
+  atomic_fetch_add_explicit(&values[ID], 1u, memory_order_relaxed);
+}
+
+void sample_telemetry(const Telemetry_ID ID, const uint32_t value)
+{
+
+  if(ID >= NUM_OF_TELEMETRY_VALUES)
+  {
+    return;
+  }
+
+  uint32_t kept = atomic_load_explicit(&values[ID], memory_order_relaxed);
+
+  switch(kinds[ID])
+  {
+    case TELEMETRY_HIGH_WATER:
+      while(value > kept &&
+            !atomic_compare_exchange_weak_explicit(&values[ID], &kept, value,
+              memory_order_relaxed, memory_order_relaxed))
+      {
+      }
+      break;
+    case TELEMETRY_LOW_WATER:
+      while(value < kept &&
+            !atomic_compare_exchange_weak_explicit(&values[ID], &kept, value,
+              memory_order_relaxed, memory_order_relaxed))
+      {
+      }
+      break;
+    default:
+      atomic_store_explicit(&values[ID], value, memory_order_relaxed);
+      break;
+  }
+}
+
+void sample_heap_telemetry(void)
+{
+
+  sample_telemetry(TELEMETRY_FREE_HEAP, (uint32_t)esp_get_free_heap_size());
+  sample_telemetry(TELEMETRY_MIN_FREE_HEAP, (uint32_t)esp_get_minimum_free_heap_size());
+}
+
+Telemetry_return get_telemetry(const Telemetry_ID ID, uint32_t *value)
+{
+
+  if(ID >= NUM_OF_TELEMETRY_VALUES)
+  {
+    return CORE_TELEMETRY_INVALID_ID_ERR;
+  }
+
+  *value = atomic_load_explicit(&values[ID], memory_order_relaxed);
+
+  return CORE_TELEMETRY_OK;
+}
+
+void print_telemetry(void)
+{
+
+  #if DEBUG_MODE_ENABLE == 1
+    sample_heap_telemetry();
+
+    uint32_t value;
+    for(uint32_t ID = 0u; ID < NUM_OF_TELEMETRY_VALUES; ID++)
+    {
+      if(get_telemetry((Telemetry_ID)ID, &value) == CORE_TELEMETRY_OK)
+      {
+        ESP_LOGI(TAG, "%s: %u", names[ID], (unsigned int)value);
+      }
+    }
+  #endif
+}
+
+inline Telemetry_return core_telemetry_LOG(const Telemetry_return ret)
+{
+  #if DEBUG_MODE_ENABLE == 1
+    switch(ret)
+    {
+      #define TELEMETRY_RETURN(enumerate) \
+        case enumerate:                   \
+          if(ret > 0)                     \
+          {                               \
+            CORE_LOGE(TAG, #enumerate);   \
+          }                               \
+          else                            \
+          {                               \
+            CORE_LOGI(TAG, #enumerate);   \
+          }                               \
+          break;
+        TELEMETRY_RETURNS
+      #undef TELEMETRY_RETURN
+      default:
+        CORE_LOGE(TAG, "Undefined return.");
+        break;
+    }
+  #endif
+  return ret;
+}
+
+#endif /* SYSTEM_TELEMETRY == 1 */
@@ -0,0 +1,192 @@
+/**
+ * @file      Telemetry.h
+ * @authors   Álvaro Velasco García
+ * @date      October 14, 2026
+ *
+ * @brief     This header file declares the functions to keep the telemetry counters
+ *            of the system: queue depth, drops, connections, heap and stack
+ *            watermarks. It is only compiled with SYSTEM_TELEMETRY.
+ */
+
+#ifndef CORE_TELEMETRY_H_
+#define CORE_TELEMETRY_H_
+
+/***************************************************************************************
+ * Includes
+ ***************************************************************************************/
+#include <System_telemetry.h>
+#include <stdint.h>
+
+/***************************************************************************************
+ * Defines
+ ***************************************************************************************/
+
+/* List of the possible return codes that module telemetry can return. */
+#define TELEMETRY_RETURNS                                 \
+  /* Info codes */                                        \
+  TELEMETRY_RETURN(CORE_TELEMETRY_OK)                     \
+  /* Error codes */                                       \
+  TELEMETRY_RETURN(CORE_TELEMETRY_INVALID_ID_ERR)
+
+/* Kinds of telemetry values. A counter only grows and wraps, a level is the last
+ * sample, a high water mark is the highest sample and a low water mark the lowest
+ * one, UINT32_MAX until the first sample.
+ */
+#define TELEMETRY_COUNTER    0u
+#define TELEMETRY_LEVEL      1u
+#define TELEMETRY_HIGH_WATER 2u
+#define TELEMETRY_LOW_WATER  3u
+
+/* Macro that enlist the telemetry values. It is mandatory to not set values to the
+ * enumerates, they are the IDs of the stats frames, so new values go at the end.
+ *
+ * Parameters:
+ *
+ *   1) Telemetry value.
+ *   2) Kind of the value, see TELEMETRY_COUNTER.
+ *
+ *   - TELEMETRY_CMDS_ENQUEUED: Commands and states that entered the TX queue.
+ *   - TELEMETRY_SEND_TIME_OUTS / TELEMETRY_QUEUE_INSERT_ERRS: Commands that
+ *     send_message could not enqueue, SEND_TIME_OUT_WARN while the link is down and
+ *     CANT_INSERT_IN_QUEUE_ERR while it is up.
+ *   - TELEMETRY_DROPPED_NEWEST / TELEMETRY_DROPPED_OLDEST: Commands dropped by the
+ *     overflow policy of the TX queue.
+ *   - TELEMETRY_JOURNAL_DROPS: Offline commands dropped by the full journal.
+ *   - TELEMETRY_WRITES / TELEMETRY_WRITE_ERRS: Batches and frames written to the
+ *     gateway, and writes that failed.
+ *   - TELEMETRY_CONNECTS / TELEMETRY_CONNECT_FAILS: Completed and failed connect().
+ *   - TELEMETRY_SOCKETS_OPENED / TELEMETRY_SOCKETS_CLOSED: Gateway sockets opened
+ *     and closed, the difference is the number of open sockets.
+ *   - TELEMETRY_ACK_TIME_OUTS / TELEMETRY_NOT_ACKED: Ack waits that ran out, and
+ *     frames given up without an ack.
+ *   - TELEMETRY_WIFI_DISCONNECTS / TELEMETRY_IP_LEASES: Link losses and leases.
+ *   - TELEMETRY_BUTTON_EVENTS / TELEMETRY_BUTTON_EVENTS_LOST: Button edges handled by
+ *     the dispatcher, and the ones lost because its ring was full.
+ *   - TELEMETRY_TX_QUEUE_DEPTH / TELEMETRY_TX_QUEUE_HIGH_WATER: Commands waiting in
+ *     the TX queue when the TX task takes a batch, last and highest.
+ *   - TELEMETRY_FREE_HEAP / TELEMETRY_MIN_FREE_HEAP: Free heap in bytes, last sample
+ *     and lowest since boot.
+ *   - TELEMETRY_TX_STACK_LOW_WATER / TELEMETRY_DISPATCHER_STACK_LOW_WATER: Lowest
+ *     free stack in bytes of the TX task and of the dispatcher.
+ */
+#define TELEMETRY_VALUES                                                 \
+  TELEMETRY_VALUE(TELEMETRY_CMDS_ENQUEUED, TELEMETRY_COUNTER)            \
+  TELEMETRY_VALUE(TELEMETRY_SEND_TIME_OUTS, TELEMETRY_COUNTER)           \
+  TELEMETRY_VALUE(TELEMETRY_QUEUE_INSERT_ERRS, TELEMETRY_COUNTER)        \
+  TELEMETRY_VALUE(TELEMETRY_DROPPED_NEWEST, TELEMETRY_COUNTER)           \
+  TELEMETRY_VALUE(TELEMETRY_DROPPED_OLDEST, TELEMETRY_COUNTER)           \
+  TELEMETRY_VALUE(TELEMETRY_JOURNAL_DROPS, TELEMETRY_COUNTER)            \
+  TELEMETRY_VALUE(TELEMETRY_WRITES, TELEMETRY_COUNTER)                   \
+  TELEMETRY_VALUE(TELEMETRY_WRITE_ERRS, TELEMETRY_COUNTER)               \
+  TELEMETRY_VALUE(TELEMETRY_CONNECTS, TELEMETRY_COUNTER)                 \
+  TELEMETRY_VALUE(TELEMETRY_CONNECT_FAILS, TELEMETRY_COUNTER)            \
+  TELEMETRY_VALUE(TELEMETRY_SOCKETS_OPENED, TELEMETRY_COUNTER)           \
+  TELEMETRY_VALUE(TELEMETRY_SOCKETS_CLOSED, TELEMETRY_COUNTER)           \
+  TELEMETRY_VALUE(TELEMETRY_ACK_TIME_OUTS, TELEMETRY_COUNTER)            \
+  TELEMETRY_VALUE(TELEMETRY_NOT_ACKED, TELEMETRY_COUNTER)                \
+  TELEMETRY_VALUE(TELEMETRY_WIFI_DISCONNECTS, TELEMETRY_COUNTER)         \
+  TELEMETRY_VALUE(TELEMETRY_IP_LEASES, TELEMETRY_COUNTER)                \
+  TELEMETRY_VALUE(TELEMETRY_BUTTON_EVENTS, TELEMETRY_COUNTER)            \
+  TELEMETRY_VALUE(TELEMETRY_BUTTON_EVENTS_LOST, TELEMETRY_COUNTER)       \
+  TELEMETRY_VALUE(TELEMETRY_TX_QUEUE_DEPTH, TELEMETRY_LEVEL)             \
+  TELEMETRY_VALUE(TELEMETRY_TX_QUEUE_HIGH_WATER, TELEMETRY_HIGH_WATER)   \
+  TELEMETRY_VALUE(TELEMETRY_FREE_HEAP, TELEMETRY_LEVEL)                  \
+  TELEMETRY_VALUE(TELEMETRY_MIN_FREE_HEAP, TELEMETRY_LEVEL)              \
+  TELEMETRY_VALUE(TELEMETRY_TX_STACK_LOW_WATER, TELEMETRY_LOW_WATER)     \
+  TELEMETRY_VALUE(TELEMETRY_DISPATCHER_STACK_LOW_WATER, TELEMETRY_LOW_WATER)
+
+/***************************************************************************************
+ * Data Type Definitions
+ ***************************************************************************************/
+
+/* Enumerate that lists the posible return codes that the module can return. */
+typedef enum
+{
+  #define TELEMETRY_RETURN(enumerate) enumerate,
+    TELEMETRY_RETURNS
+  #undef TELEMETRY_RETURN
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_TELEMETRY_RETURNS,
+} Telemetry_return;
+
+/* Enumerate that enlist the telemetry values. */
+typedef enum
+{
+  #define TELEMETRY_VALUE(enumerate, kind) enumerate,
+    TELEMETRY_VALUES
+  #undef TELEMETRY_VALUE
+  /* Last enumerate always, indicates the number of elements. Do not delete */
+  NUM_OF_TELEMETRY_VALUES,
+} Telemetry_ID;
+
+/***************************************************************************************
+ * Functions Prototypes
+ ***************************************************************************************/
+
+/**
+ * @brief Adds one to a counter. It does not lock, so it can be called from any task
+ *        or ISR.
+ *
+ * @param ID Counter to increase.
+ *
+ * @return void
+ */
+void count_telemetry(const Telemetry_ID ID);
+
+/**
+ * @brief Samples a value. Levels keep the sample, high water marks keep it if it is
+ *        the highest one and low water marks if it is the lowest one. Counters are
+ *        overwritten. It does not lock, so it can be called from any task or ISR.
+ *
+ * @param ID Value to sample.
+ *
+ * @param value Sample.
+ *
+ * @return void
+ */
+void sample_telemetry(const Telemetry_ID ID, const uint32_t value);
+
+/**
+ * @brief Samples the free heap, in TELEMETRY_FREE_HEAP and TELEMETRY_MIN_FREE_HEAP.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void sample_heap_telemetry(void);
+
+/**
+ * @brief Gets a telemetry value.
+ *
+ * @param ID Value to read.
+ *
+ * @param value Where the value is copied.
+ *
+ * @return CORE_TELEMETRY_OK if the operation went well,
+ *         otherwise:
+ *
+ *           - CORE_TELEMETRY_INVALID_ID_ERR:
+ *               The given value does not exist.
+ */
+Telemetry_return get_telemetry(const Telemetry_ID ID, uint32_t *value);
+
+/**
+ * @brief Prints every telemetry value if the system was configured in debug mode.
+ *
+ * @param void
+ *
+ * @return void
+ */
+void print_telemetry(void);
+
+/**
+ * @brief Prints the return of a telemetry module function if the system was
+ *        configured in debug mode.
+ *
+ * @param ret Received return from a telemetry module function.
+ *
+ * @return The given return.
+ */
+Telemetry_return core_telemetry_LOG(const Telemetry_return ret);
+
+#endif /* CORE_TELEMETRY_H_ */
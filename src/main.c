@@ -11,6 +11,10 @@
  ***************************************************************************************/
 #include <Remote_switch.h>
 #include <Debug.h>
+#include <Deferred_log.h>
+#include <Power.h>
+#include <Bench.h>
+#include <Latency.h>
 
 /***************************************************************************************
  * Functions
@@ -20,6 +24,22 @@
 void app_main() 
 {
 
+  /* First, so the traces of the other modules are printed from the start. */
+  if(core_deferred_log_LOG(init_deferred_log()) != CORE_DEFERRED_LOG_OK)
+  {
+    #if DEBUG_MODE_ENABLE == 1
+      ESP_LOGE("MAIN", "Can not start the deferred log.");
+    #endif
+  }
+
+  /* The buttons wake up the CPU, so it can sleep since the start. */
+  if(core_power_LOG(init_power()) != CORE_POWER_OK)
+  {
+    #if DEBUG_MODE_ENABLE == 1
+      ESP_LOGE("MAIN", "Can not initialize the low power mode.");
+    #endif
+  }
+
   if(BPS_button_LOG(init_BSP_button_module()) != BSP_BUTTON_OK)
   {
     #if DEBUG_MODE_ENABLE == 1
@@ -27,25 +47,56 @@ void app_main()
     #endif
   }
 
-  if(core_remote_switch_LOG(init_remote_switch(BUTTON_0)) != CORE_REMOTE_SWITCH_OK)
+  /* Start the client first, the WiFi connects while the switches are initialized and
+   * the presses are buffered until it is ready.
+   */
+  if(core_remote_switch_LOG(remote_switch_start_client()) != CORE_REMOTE_SWITCH_OK)
   {
     #if DEBUG_MODE_ENABLE == 1
-      ESP_LOGE("MAIN", "Can not initialize remote switch 0.");
+      ESP_LOGE("MAIN", "Can not start the remote switch client.");
     #endif
   }
 
-  if(core_remote_switch_LOG(init_remote_switch(BUTTON_1)) != CORE_REMOTE_SWITCH_OK)
+  if(core_remote_switch_LOG(init_remote_switch(BUTTON_0)) != CORE_REMOTE_SWITCH_OK)
   {
     #if DEBUG_MODE_ENABLE == 1
       ESP_LOGE("MAIN", "Can not initialize remote switch 0.");
     #endif
   }
 
-  if(core_remote_switch_LOG(remote_switch_start_client()) != CORE_REMOTE_SWITCH_OK)
+  if(core_remote_switch_LOG(init_remote_switch(BUTTON_1)) != CORE_REMOTE_SWITCH_OK)
   {
     #if DEBUG_MODE_ENABLE == 1
-      ESP_LOGE("MAIN", "Can not initialize remote switch 1.");
+      ESP_LOGE("MAIN", "Can not initialize remote switch 0.");
     #endif
   }
 
+  #if SYSTEM_BENCH_MODE == 1
+    /* The benchmark waits for the link, then it presses the initialized switches. */
+    if(core_bench_LOG(start_bench()) != CORE_BENCH_OK)
+    {
+      ESP_LOGE("MAIN", "Can not start the benchmark.");
+    }
+  #endif
+
+  #if SYSTEM_LATENCY_TRACE == 1 && SYSTEM_BENCH_MODE == 0
+    /* The benchmark mode prints its own reports, between the runs. */
+    if(core_latency_LOG(start_latency_report()) != CORE_LATENCY_OK)
+    {
+      #if DEBUG_MODE_ENABLE == 1
+        ESP_LOGE("MAIN", "Can not start the latency reports.");
+      #endif
+    }
+  #endif
+
+  #if LATENCY_STRESS_TRAFFIC == 1
+    /* The stress task waits for the link, like the benchmark. */
+    if(core_latency_LOG(start_stress_traffic()) != CORE_LATENCY_OK)
+    {
+      #if DEBUG_MODE_ENABLE == 1
+        ESP_LOGE("MAIN", "Can not start the stress traffic.");
+      #endif
+    }
+  #endif
+
 }
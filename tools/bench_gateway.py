@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""
+@file      bench_gateway.py
+@authors   Álvaro Velasco García
+@date      October 14, 2026
+
+@brief     Fake gateway for the benchmark mode (SYSTEM_BENCH_MODE -> System_bench.h).
+           It accepts the data that the switch writes in TCP or UDP, in the framed
+           (Frame.h) or in the raw TCP_COMMAND_TYPE format, records the arrival time of
+           every command and prints the throughput, the drops and the inter-arrival
+           percentiles of every run. A run ends after --idle seconds without data.
+
+           Usage: python3 tools/bench_gateway.py --port <TCP_IP_PORT> [--udp]
+                  [--acks] [--expect 10,100,500,100,500] [--csv arrivals.csv]
+
+           The expected counts are the presses of every run of BENCH_RUNS multiplied
+           by the number of its TOGGLE_LED_ACTION buttons, one entry per run.
+"""
+
+import argparse
+import selectors
+import socket
+import struct
+import sys
+import time
+
+# Wire format of Frame.h.
+FRAME_VERSION = 1
+FRAME_HEADER = struct.Struct(">BBHB")
+FRAME_CMD_RECORD_SIZE = 3
+FRAME_STATE_RECORD_SIZE = 3
+FRAME_STATS_RECORD_SIZE = 5
+FRAME_TYPE_COMMANDS = 1
+FRAME_TYPE_ACK = 2
+FRAME_TYPE_STATE = 3
+FRAME_TYPE_STATS = 4
+
+# Size of the records of every frame type that carries commands, states or counters.
+RECORD_SIZES = {
+    FRAME_TYPE_COMMANDS: FRAME_CMD_RECORD_SIZE,
+    FRAME_TYPE_STATE: FRAME_STATE_RECORD_SIZE,
+    FRAME_TYPE_STATS: FRAME_STATS_RECORD_SIZE,
+}
+
+
+class Run:
+    """Arrivals of one benchmark run."""
+
+    def __init__(self, index):
+        self.index = index
+        self.arrivals = []
+        self.frames = 0
+        self.state_frames = 0
+        self.stats_frames = 0
+        self.duplicates = 0
+        self.gaps = 0
+        self.bad_frames = 0
+        self.seqs = set()
+        self.last_seq = None
+
+    def add_frame(self, seq, now, num_of_cmds):
+        self.frames += 1
+        # Frames written again after a reconnection are not new commands.
+        if seq in self.seqs:
+            self.duplicates += 1
+            return False
+        if self.last_seq is not None and seq != ((self.last_seq + 1) & 0xFFFF):
+            self.gaps += 1
+        self.seqs.add(seq)
+        self.last_seq = seq
+        self.arrivals.extend([now] * num_of_cmds)
+        return True
+
+
+def percentile(values, fraction):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def report(run, expected, csv_file):
+    commands = len(run.arrivals)
+    elapsed = (run.arrivals[-1] - run.arrivals[0]) if commands > 1 else 0.0
+    throughput = ((commands - 1) / elapsed) if elapsed > 0.0 else 0.0
+    gaps_ms = [(b - a) * 1000.0 for a, b in zip(run.arrivals, run.arrivals[1:])]
+
+    print("Run %d: commands=%d frames=%d state_frames=%d stats_frames=%d duplicates=%d "
+          "seq_gaps=%d bad_frames=%d" % (run.index, commands, run.frames,
+                                         run.state_frames, run.stats_frames,
+                                         run.duplicates, run.gaps, run.bad_frames))
+    if expected is not None:
+        print("Run %d: expected=%d dropped=%d" % (run.index, expected,
+                                                   max(expected - commands, 0)))
+    print("Run %d: throughput=%.1f commands/s inter-arrival p50=%.2fms p99=%.2fms "
+          "max=%.2fms" % (run.index, throughput, percentile(gaps_ms, 0.50),
+                          percentile(gaps_ms, 0.99), max(gaps_ms, default=0.0)))
+    sys.stdout.flush()
+
+    if csv_file is not None:
+        start = run.arrivals[0] if commands else 0.0
+        for number, arrival in enumerate(run.arrivals):
+            csv_file.write("%d,%d,%.6f\n" % (run.index, number, arrival - start))
+        csv_file.flush()
+
+
+class Decoder:
+    """Splits the received bytes in frames or raw commands."""
+
+    def __init__(self, args):
+        self.args = args
+        self.pending = b""
+
+    def feed(self, data, run, now):
+        """Returns the ack frames to write back."""
+        acks = []
+        self.pending += data
+        if self.args.format == "raw":
+            size = self.args.raw_size
+            num_of_cmds = len(self.pending) // size
+            self.pending = self.pending[num_of_cmds * size:]
+            run.arrivals.extend([now] * num_of_cmds)
+            run.frames += num_of_cmds
+            return acks
+
+        while len(self.pending) >= FRAME_HEADER.size:
+            version, frame_type, seq, count = FRAME_HEADER.unpack_from(self.pending)
+            record_size = RECORD_SIZES.get(frame_type)
+            if version != FRAME_VERSION or record_size is None:
+                # The stream lost its alignment, nothing after it can be trusted.
+                run.bad_frames += 1
+                self.pending = b""
+                break
+            frame_size = FRAME_HEADER.size + count * record_size
+            if len(self.pending) < frame_size:
+                break
+            self.pending = self.pending[frame_size:]
+            if frame_type == FRAME_TYPE_STATE:
+                run.state_frames += 1
+                continue
+            if frame_type == FRAME_TYPE_STATS:
+                # The reports are not acknowledged, they are only counted.
+                run.stats_frames += 1
+                continue
+            run.add_frame(seq, now, count)
+            if self.args.acks:
+                acks.append(FRAME_HEADER.pack(FRAME_VERSION, FRAME_TYPE_ACK, seq, 0))
+        return acks
+
+
+class Runs:
+    """Splits the arrivals in runs separated by --idle seconds of silence."""
+
+    def __init__(self, args, csv_file):
+        self.args = args
+        self.csv_file = csv_file
+        self.expected = ([int(value) for value in args.expect.split(",")]
+                         if args.expect else [])
+        self.index = 0
+        self.current = None
+        self.last_data = 0.0
+
+    def get(self, now):
+        if self.current is None:
+            self.current = Run(self.index)
+        self.last_data = now
+        return self.current
+
+    def poll(self, now):
+        if self.current is not None and now - self.last_data >= self.args.idle:
+            expected = (self.expected[self.index]
+                        if self.index < len(self.expected) else None)
+            report(self.current, expected, self.csv_file)
+            self.current = None
+            self.index += 1
+
+
+def serve_udp(args, runs):
+    server = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind((args.bind, args.port))
+    server.settimeout(0.05)
+    while True:
+        try:
+            data, address = server.recvfrom(2048)
+        except socket.timeout:
+            runs.poll(time.monotonic())
+            continue
+        now = time.monotonic()
+        # Every datagram is a whole frame, a partial one is not carried to the next.
+        decoder = Decoder(args)
+        for ack in decoder.feed(data, runs.get(now), now):
+            server.sendto(ack, address)
+
+
+def serve_tcp(args, runs):
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind((args.bind, args.port))
+    server.listen(4)
+    server.setblocking(False)
+    # Connect per command opens a connection for every batch, so several can be open.
+    # The listening socket and the clients are waited together, so the arrival time
+    # is taken as soon as the data is readable.
+    selector = selectors.DefaultSelector()
+    selector.register(server, selectors.EVENT_READ)
+    clients = {}
+    while True:
+        for key, _ in selector.select(timeout=0.05):
+            now = time.monotonic()
+            if key.fileobj is server:
+                try:
+                    client, _ = server.accept()
+                except BlockingIOError:
+                    continue
+                client.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                client.setblocking(False)
+                clients[client] = Decoder(args)
+                selector.register(client, selectors.EVENT_READ)
+                continue
+            client = key.fileobj
+            try:
+                data = client.recv(4096)
+            except BlockingIOError:
+                continue
+            except OSError:
+                data = b""
+            if not data:
+                selector.unregister(client)
+                client.close()
+                del clients[client]
+                continue
+            for ack in clients[client].feed(data, runs.get(now), now):
+                client.sendall(ack)
+        runs.poll(time.monotonic())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fake gateway for the benchmarks.")
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, required=True,
+                        help="TCP_IP_PORT of Network_config.h")
+    parser.add_argument("--udp", action="store_true",
+                        help="listen for TCP_CLIENT_TRANSPORT_UDP")
+    parser.add_argument("--format", choices=("framed", "raw"),
+                        help="TCP_CLIENT_WIRE_FORMAT of System_network.h, raw over "
+                             "TCP and framed over UDP by default")
+    parser.add_argument("--raw-size", type=int, default=12,
+                        help="sizeof(TCP_COMMAND_TYPE) with the raw format")
+    parser.add_argument("--acks", action="store_true",
+                        help="acknowledge the frames, TCP_CLIENT_GATEWAY_ACKS")
+    parser.add_argument("--expect", default="",
+                        help="expected commands of every run, comma separated")
+    parser.add_argument("--idle", type=float, default=1.0,
+                        help="seconds without data that end a run, less than "
+                             "BENCH_SETTLE_MS")
+    parser.add_argument("--csv", help="file where every arrival is written")
+    args = parser.parse_args()
+    if args.format is None:
+        args.format = "framed" if args.udp else "raw"
+
+    if args.acks and args.format != "framed":
+        parser.error("the acks need the framed format")
+
+    csv_file = open(args.csv, "w") if args.csv else None
+    if csv_file is not None:
+        csv_file.write("run,command,arrival_s\n")
+
+    runs = Runs(args, csv_file)
+    try:
+        if args.udp:
+            serve_udp(args, runs)
+        else:
+            serve_tcp(args, runs)
+    except KeyboardInterrupt:
+        runs.poll(float("inf"))
+    finally:
+        if csv_file is not None:
+            csv_file.close()
+
+
+if __name__ == "__main__":
+    main()